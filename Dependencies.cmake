@@ -48,6 +48,15 @@ function(horiba_cpp_sdk_setup_dependencies)
       OPTIONS "BOOST_ENABLE_CMAKE ON" "BOOST_INCLUDE_LIBRARIES container\\\;asio")
   endif()
 
+  # Used only in the benchmarks
+  if(horiba_cpp_sdk_BUILD_BENCHMARKS AND NOT TARGET benchmark::benchmark)
+    CPMAddPackage(
+      NAME benchmark
+      VERSION 1.8.3
+      GITHUB_REPOSITORY google/benchmark
+      OPTIONS "BENCHMARK_ENABLE_TESTING OFF" "BENCHMARK_ENABLE_INSTALL OFF" "BENCHMARK_ENABLE_GTEST_TESTS OFF")
+  endif()
+
   if(NOT TARGET nlohmann_json::nlohmann_json)
     CPMAddPackage("gh:nlohmann/json@3.11.3")
   endif()
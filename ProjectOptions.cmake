@@ -88,6 +88,7 @@ macro(horiba_cpp_sdk_setup_options)
   endif()
 
   option(horiba_cpp_sdk_BUILD_FUZZ_TESTS "Enable fuzz testing executable" ${DEFAULT_FUZZER})
+  option(horiba_cpp_sdk_BUILD_BENCHMARKS "Build the benchmarks against the fake ICL server" OFF)
 
 endmacro()
 
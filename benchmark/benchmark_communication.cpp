@@ -0,0 +1,247 @@
+#include <benchmark/benchmark.h>
+#include <fake_icl/icl_server.h>
+#include <horiba_cpp_sdk/common/buffer_pool.h>
+#include <horiba_cpp_sdk/communication/binary_message.h>
+#include <horiba_cpp_sdk/communication/command.h>
+#include <horiba_cpp_sdk/communication/response.h>
+#include <horiba_cpp_sdk/communication/response_parser.h>
+#include <horiba_cpp_sdk/communication/websocket_communicator.h>
+#include <horiba_cpp_sdk/devices/single_devices/acquisition_data.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "fake_icl_server.h"
+
+namespace horiba::benchmarks {
+
+using json = nlohmann::json;
+using communication::BinaryBlock;
+using communication::BinaryMessage;
+using communication::Command;
+using communication::DomResponseParser;
+using communication::NumericDataResponseParser;
+using communication::Response;
+using communication::ResponseParser;
+using communication::WebSocketCommunicator;
+using devices::single_devices::AcquisitionData;
+
+namespace {
+
+json acquisition_response(std::size_t columns, std::size_t rows) {
+  return {{"id", 1234},
+          {"command", "ccd_getAcquisitionData"},
+          {"results", fake_icl::synthetic_acquisition_results(
+                          {static_cast<int>(columns), static_cast<int>(rows)})},
+          {"errors", json::array()}};
+}
+
+/**
+ * @brief Parses a text response the way WebSocketCommunicator does.
+ */
+Response parse_response(ResponseParser& parser, const std::string& raw_response,
+                        common::BufferPool<double>* buffers = nullptr) {
+  std::vector<BinaryBlock> blocks;
+  json json_response = parser.parse(raw_response, blocks, buffers);
+  std::vector<std::string> errors;
+  for (auto& json_error : json_response.at("errors")) {
+    errors.push_back(std::move(json_error.get_ref<std::string&>()));
+  }
+  return Response{
+      json_response.at("id").get<unsigned long long int>(),
+      std::move(json_response.at("command").get_ref<std::string&>()),
+      std::move(json_response.at("results").get_ref<json::object_t&>()),
+      std::move(errors), std::move(blocks)};
+}
+
+AcquisitionData acquisition_data(Response& response) {
+  if (!response.binary_blocks().empty()) {
+    return AcquisitionData::from_binary_message(response.json_results(),
+                                                response.take_binary_blocks());
+  }
+  return AcquisitionData::from_json(response.json_results());
+}
+
+void acquisition_sizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"columns", "rows"});
+  benchmark->Args({1024, 1});
+  benchmark->Args({1024, 16});
+  benchmark->Args({1024, 256});
+}
+
+void parsed_acquisition_sizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"columns", "rows", "numeric_parser"});
+  for (const int rows : {1, 16, 256}) {
+    benchmark->Args({1024, rows, 0});
+    benchmark->Args({1024, rows, 1});
+  }
+}
+
+}  // namespace
+
+static void BM_CommandSerialize(benchmark::State& state) {
+  const Command command("ccd_setRoi", {{"index", 0},
+                                       {"roiIndex", 1},
+                                       {"xOrigin", 0},
+                                       {"yOrigin", 0},
+                                       {"xSize", 1024},
+                                       {"ySize", 256},
+                                       {"xBin", 1},
+                                       {"yBin", 256}});
+  std::string json_command;
+  for (auto _ : state) {
+    command.serialize(json_command);
+    benchmark::DoNotOptimize(json_command.data());
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(json_command.size()));
+}
+BENCHMARK(BM_CommandSerialize);
+
+static void BM_StatusResponseParse(benchmark::State& state) {
+  const std::string raw_response =
+      json{{"id", 1234},
+           {"command", "mono_isBusy"},
+           {"results", {{"busy", false}}},
+           {"errors", json::array()}}
+          .dump();
+  NumericDataResponseParser parser;
+  for (auto _ : state) {
+    auto response = parse_response(parser, raw_response);
+    benchmark::DoNotOptimize(response.json_results().at("busy").get<bool>());
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(raw_response.size()));
+}
+BENCHMARK(BM_StatusResponseParse);
+
+static void BM_AcquisitionResponseParse(benchmark::State& state) {
+  const auto columns = static_cast<std::size_t>(state.range(0));
+  const auto rows = static_cast<std::size_t>(state.range(1));
+  const std::string raw_response = acquisition_response(columns, rows).dump();
+  std::unique_ptr<ResponseParser> parser;
+  if (state.range(2) != 0) {
+    parser = std::make_unique<NumericDataResponseParser>(0);
+  } else {
+    parser = std::make_unique<DomResponseParser>();
+  }
+  // frames are parsed into the buffers of the previous ones, as when
+  // streaming
+  common::BufferPool<double> buffers;
+  buffers.set_buffer_size(columns * rows);
+  AcquisitionData data;
+  for (auto _ : state) {
+    data.release_buffers(buffers);
+    auto response = parse_response(*parser, raw_response, &buffers);
+    data = acquisition_data(response);
+    benchmark::DoNotOptimize(data.acquisitions().data());
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(raw_response.size()));
+  state.counters["pixels"] = static_cast<double>(columns * rows);
+}
+BENCHMARK(BM_AcquisitionResponseParse)
+    ->Apply(parsed_acquisition_sizes)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_AcquisitionBinaryResponseDecode(benchmark::State& state) {
+  const auto columns = static_cast<std::size_t>(state.range(0));
+  const auto rows = static_cast<std::size_t>(state.range(1));
+  json metadata = acquisition_response(columns, rows);
+  auto& roi = metadata["results"]["acquisition"][0]["roi"][0];
+
+  std::vector<BinaryBlock> blocks(2);
+  blocks[0].acquisition_index = 1;
+  blocks[0].roi_index = 1;
+  blocks[0].axis = BinaryBlock::Axis::X;
+  blocks[0].element_type = BinaryBlock::ElementType::FLOAT64;
+  blocks[0].rows = 1;
+  blocks[1].acquisition_index = 1;
+  blocks[1].roi_index = 1;
+  blocks[1].axis = BinaryBlock::Axis::Y;
+  blocks[1].element_type = BinaryBlock::ElementType::UINT32;
+  blocks[1].rows = static_cast<int>(rows);
+  for (const auto& value : roi["xData"][0]) {
+    blocks[0].values.push_back(value.get<double>());
+  }
+  for (const auto& row : roi["yData"]) {
+    for (const auto& value : row) {
+      blocks[1].values.push_back(value.get<double>());
+    }
+  }
+  roi.erase("xData");
+  roi.erase("yData");
+  const auto frame = BinaryMessage::encode(metadata, blocks);
+
+  common::BufferPool<double> buffers;
+  AcquisitionData data;
+  for (auto _ : state) {
+    data.release_buffers(buffers);
+    auto message = BinaryMessage::decode(frame, &buffers);
+    data = AcquisitionData::from_binary_message(
+        message.metadata().at("results"), std::move(message.blocks()));
+    benchmark::DoNotOptimize(data.acquisitions().data());
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(frame.size()));
+  state.counters["pixels"] = static_cast<double>(columns * rows);
+}
+BENCHMARK(BM_AcquisitionBinaryResponseDecode)
+    ->Apply(acquisition_sizes)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_RoundTrip(benchmark::State& state) {
+  WebSocketCommunicator communicator(
+      test::FakeICLServer::FAKE_ICL_ADDRESS,
+      std::to_string(test::FakeICLServer::FAKE_ICL_PORT));
+  communicator.open();
+  const Command command("mono_isBusy", {{"index", 0}});
+  for (auto _ : state) {
+    auto response = communicator.request_with_response(command);
+    benchmark::DoNotOptimize(response.id());
+  }
+  communicator.close();
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+BENCHMARK(BM_RoundTrip)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+static void BM_PipelinedRoundTrip(benchmark::State& state) {
+  WebSocketCommunicator communicator(
+      test::FakeICLServer::FAKE_ICL_ADDRESS,
+      std::to_string(test::FakeICLServer::FAKE_ICL_PORT));
+  communicator.open();
+  const auto depth = static_cast<std::size_t>(state.range(0));
+  std::vector<Command> commands;
+  for (std::size_t i = 0; i < depth; i++) {
+    commands.emplace_back("mono_isBusy", json{{"index", 0}});
+  }
+  std::vector<std::future<Response>> responses;
+  responses.reserve(depth);
+  for (auto _ : state) {
+    for (const auto& command : commands) {
+      responses.push_back(communicator.request_with_response_async(command));
+    }
+    for (auto& response : responses) {
+      benchmark::DoNotOptimize(response.get().id());
+    }
+    responses.clear();
+  }
+  communicator.close();
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) *
+                          static_cast<std::int64_t>(depth));
+}
+BENCHMARK(BM_PipelinedRoundTrip)
+    ->ArgName("depth")
+    ->Arg(4)
+    ->Arg(16)
+    ->Arg(64)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+}  // namespace horiba::benchmarks
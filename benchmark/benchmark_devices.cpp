@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+#include <horiba_cpp_sdk/devices/icl_device_manager.h>
+#include <horiba_cpp_sdk/devices/single_devices/acquisition_data.h>
+#include <horiba_cpp_sdk/devices/single_devices/ccd.h>
+#include <horiba_cpp_sdk/devices/single_devices/mono.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include "fake_icl_server.h"
+#include "os/fake_process.h"
+
+namespace horiba::benchmarks {
+
+using devices::ICLDeviceManager;
+using devices::single_devices::ChargeCoupledDevice;
+
+namespace {
+
+ICLDeviceManager fake_icl_device_manager(bool enable_binary_messages) {
+  return ICLDeviceManager(std::make_shared<os::FakeProcess>(),
+                          test::FakeICLServer::FAKE_ICL_ADDRESS,
+                          std::to_string(test::FakeICLServer::FAKE_ICL_PORT),
+                          false, enable_binary_messages);
+}
+
+}  // namespace
+
+static void BM_DiscoverDevices(benchmark::State& state) {
+  auto icl_device_manager = fake_icl_device_manager(false);
+  icl_device_manager.start();
+  for (auto _ : state) {
+    icl_device_manager.discover_devices();
+    benchmark::DoNotOptimize(icl_device_manager.charge_coupled_devices());
+  }
+  state.counters["ccds_ms"] = static_cast<double>(
+      icl_device_manager.charge_coupled_devices_discovery_time().count());
+  state.counters["monos_ms"] = static_cast<double>(
+      icl_device_manager.monochromators_discovery_time().count());
+  icl_device_manager.stop();
+}
+BENCHMARK(BM_DiscoverDevices)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/**
+ * One step of a scan: the monochromator moves to the center wavelength, then
+ * the CCD acquires and its data is read.
+ */
+static void BM_CenterScanCycle(benchmark::State& state) {
+  const bool enable_binary_messages = state.range(0) != 0;
+  auto icl_device_manager = fake_icl_device_manager(enable_binary_messages);
+  icl_device_manager.start();
+  auto ccd = icl_device_manager.charge_coupled_devices().front();
+  auto mono = icl_device_manager.monochromators().front();
+  ccd->open();
+  mono->open();
+
+  ChargeCoupledDevice::AcquisitionSettings settings;
+  settings.acquisition_count = 1;
+  settings.exposure_time = 0;
+  ccd->apply_acquisition_settings(settings);
+
+  const std::chrono::milliseconds timeout{5000};
+  const double center_wavelength = 500.0;
+  for (auto _ : state) {
+    mono->move_to_target_wavelength(center_wavelength);
+    mono->wait_until_ready(timeout);
+    ccd->set_acquisition_start(true);
+    ccd->wait_for_acquisition(timeout);
+    auto data = ccd->get_acquisition_data();
+    benchmark::DoNotOptimize(data.acquisitions().data());
+  }
+
+  ccd->close();
+  mono->close();
+  icl_device_manager.stop();
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()));
+}
+BENCHMARK(BM_CenterScanCycle)
+    ->ArgName("binary")
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+}  // namespace horiba::benchmarks
@@ -0,0 +1,43 @@
+#include <benchmark/benchmark.h>
+#include <spdlog/spdlog.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "fake_icl_server.h"
+
+/**
+ * Runs the benchmarks against the fake ICL server of the tests.
+ *
+ * On top of the google benchmark options, e.g. --benchmark_filter or
+ * --benchmark_out=results.json --benchmark_out_format=json, the folder of the
+ * fake responses can be given with --fake_responses_folder_path=<path>.
+ */
+int main(int argc, char* argv[]) {
+  spdlog::set_level(spdlog::level::warn);
+
+  std::string fake_responses_folder_path = "./fake_icl_responses/";
+  constexpr std::string_view FOLDER_OPTION = "--fake_responses_folder_path=";
+  int remaining_argc = 0;
+  for (int i = 0; i < argc; i++) {
+    const std::string_view argument{argv[i]};
+    if (argument.starts_with(FOLDER_OPTION)) {
+      fake_responses_folder_path = argument.substr(FOLDER_OPTION.size());
+      continue;
+    }
+    argv[remaining_argc++] = argv[i];
+  }
+
+  benchmark::Initialize(&remaining_argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(remaining_argc, argv)) {
+    return 1;
+  }
+  benchmark::AddCustomContext("icl", "fake ICL server");
+
+  const auto fake_icl_server =
+      std::make_unique<horiba::test::FakeICLServer>(fake_responses_folder_path);
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,256 @@
+#ifndef ICL_SERVER_H
+#define ICL_SERVER_H
+
+#include <horiba_cpp_sdk/communication/binary_message.h>
+
+#include <atomic>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace horiba::fake_icl {
+
+/**
+ * @brief Distribution of the time the fake ICL takes to answer a command.
+ */
+class LatencyDistribution {
+ public:
+  enum class Kind : std::uint8_t { NONE, FIXED, UNIFORM, NORMAL };
+
+  /**
+   * @brief Answers immediately.
+   */
+  LatencyDistribution() = default;
+
+  static LatencyDistribution fixed(std::chrono::microseconds latency);
+
+  /**
+   * @brief Latency uniformly distributed in [minimum, maximum].
+   */
+  static LatencyDistribution uniform(std::chrono::microseconds minimum,
+                                     std::chrono::microseconds maximum);
+
+  /**
+   * @brief Normally distributed latency, negative samples are clamped to 0.
+   */
+  static LatencyDistribution normal(
+      std::chrono::microseconds mean,
+      std::chrono::microseconds standard_deviation);
+
+  /**
+   * @brief Parses a distribution in milliseconds: "none", "fixed:<ms>",
+   * "uniform:<min ms>:<max ms>" or "normal:<mean ms>:<stddev ms>".
+   *
+   * @param text The distribution
+   *
+   * @return The distribution
+   *
+   * @throw std::invalid_argument if the text is not a valid distribution
+   */
+  static LatencyDistribution parse(std::string_view text) noexcept(false);
+
+  /**
+   * @brief Draws a latency.
+   *
+   * @param generator Random generator of the caller
+   *
+   * @return The latency, never negative
+   */
+  [[nodiscard]] std::chrono::microseconds sample(
+      std::mt19937_64& generator) const;
+
+  [[nodiscard]] Kind kind() const;
+
+ private:
+  Kind distribution_kind = Kind::NONE;
+  double first = 0.0;
+  double second = 0.0;
+};
+
+/**
+ * @brief How the fake ICL handles one command.
+ */
+struct CommandBehavior {
+  LatencyDistribution latency;
+  /**
+   * @brief Probability, between 0 and 1, to answer with an error instead of
+   * the results.
+   */
+  double error_probability = 0.0;
+  std::string error_message = "[E];-1;Injected error";
+  /**
+   * @brief Probability to never answer, to test timeouts.
+   */
+  double drop_probability = 0.0;
+  /**
+   * @brief Probability to close the connection instead of answering.
+   */
+  double disconnect_probability = 0.0;
+};
+
+/**
+ * @brief Size of the synthetic acquisitions.
+ */
+struct ChipSize {
+  int columns = 1024;
+  int rows = 1;
+};
+
+/**
+ * @brief Results of "ccd_getAcquisitionData" with one acquisition of one
+ * region of interest covering the chip.
+ *
+ * @param chip Size of the chip
+ *
+ * @return The results, with "xData" and "yData" rows
+ */
+nlohmann::json synthetic_acquisition_results(ChipSize chip);
+
+/**
+ * @brief Configuration of an ICLServer.
+ */
+struct ICLServerConfig {
+  std::string address = "127.0.0.1";
+  /**
+   * @brief Port to listen on, 0 to let the system pick a free one, see
+   * ICLServer::port().
+   */
+  unsigned short port = 25010;
+  /**
+   * @brief Threads serving the sessions.
+   */
+  std::size_t threads = 1;
+  /**
+   * @brief Folder of the canned responses "icl.json", "ccd.json" and
+   * "monochromator.json". Empty for none, unknown commands are answered with
+   * empty results.
+   */
+  std::filesystem::path responses_folder;
+  /**
+   * @brief Behavior of the commands not listed in command_behaviors.
+   */
+  CommandBehavior default_behavior;
+  std::unordered_map<std::string, CommandBehavior> command_behaviors;
+  /**
+   * @brief When set, "ccd_getChipSize" and "ccd_getAcquisitionData" answer
+   * with a synthetic chip of this size instead of the canned responses.
+   */
+  std::optional<ChipSize> synthetic_chip;
+  /**
+   * @brief Whether sessions send acquisitions as binary messages before
+   * receiving "icl_binMode".
+   */
+  bool binary_messages = false;
+  std::uint64_t seed = 0;
+};
+
+/**
+ * @brief Fake ICL for tests, benchmarks and load tests.
+ *
+ * Serves any number of websocket sessions on a pool of threads. Each command
+ * is answered after a latency drawn from its CommandBehavior, so responses of
+ * pipelined commands may be sent out of order like the ones of the real ICL.
+ * The canned responses are serialized once at startup and only the id is
+ * spliced in per response.
+ *
+ * Once "icl_binMode" has been received on a session, acquisition data is sent
+ * as a binary message, see horiba::communication::BinaryMessage.
+ */
+class ICLServer {
+ public:
+  /**
+   * @brief Starts listening, the server runs until it is destroyed.
+   *
+   * @param config Configuration of the server
+   *
+   * @throw std::exception if the canned responses cannot be read or the
+   * address cannot be bound
+   */
+  explicit ICLServer(ICLServerConfig config) noexcept(false);
+  ~ICLServer();
+
+  ICLServer(const ICLServer&) = delete;
+  ICLServer& operator=(const ICLServer&) = delete;
+  ICLServer(ICLServer&&) = delete;
+  ICLServer& operator=(ICLServer&&) = delete;
+
+  /**
+   * @brief Port the server listens on.
+   *
+   * @return The port
+   */
+  [[nodiscard]] unsigned short port() const;
+
+  /**
+   * @brief Number of commands received over all the sessions.
+   *
+   * @return The number of commands
+   */
+  [[nodiscard]] std::uint64_t received_commands() const;
+
+  /**
+   * @brief Stops accepting connections and serving the sessions. Called by
+   * the destructor.
+   */
+  void stop();
+
+ private:
+  class Session;
+
+  struct Reply {
+    bool binary = false;
+    std::string text;
+    std::vector<std::byte> frame;
+  };
+
+  struct CannedResponse {
+    /**
+     * @brief Serialized response without the id and its opening brace.
+     */
+    std::string text_after_id;
+    /**
+     * @brief Response without the values, set for acquisition data only.
+     */
+    std::optional<nlohmann::json> binary_metadata;
+    std::vector<communication::BinaryBlock> binary_blocks;
+  };
+
+  ICLServerConfig config;
+  std::unordered_map<std::string, CannedResponse> canned_responses;
+  std::atomic<std::uint64_t> command_count{0};
+  std::atomic<std::uint64_t> session_count{0};
+
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor;
+  std::vector<std::thread> threads;
+  std::atomic<bool> stopped{false};
+
+  void load_canned_responses();
+  void add_canned_response(const std::string& command,
+                           nlohmann::json response);
+  void do_accept();
+
+  [[nodiscard]] const CommandBehavior& behavior(
+      const std::string& command) const;
+  [[nodiscard]] Reply reply(unsigned long long int id,
+                            const std::string& command, bool binary_mode) const;
+  [[nodiscard]] static Reply error_reply(unsigned long long int id,
+                                         const std::string& command,
+                                         const std::string& error_message);
+};
+
+} /* namespace horiba::fake_icl */
+
+#endif /* ifndef ICL_SERVER_H */
@@ -0,0 +1,514 @@
+#include "fake_icl/icl_server.h"
+
+#include <horiba_cpp_sdk/communication/binary_message.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+#include <charconv>
+#include <chrono>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace horiba::fake_icl {
+
+namespace {
+
+using communication::BinaryBlock;
+
+double microseconds(std::chrono::microseconds duration) {
+  return static_cast<double>(duration.count());
+}
+
+double parse_milliseconds(std::string_view text) {
+  double milliseconds = 0.0;
+  const auto [end, error] =
+      std::from_chars(text.data(), text.data() + text.size(), milliseconds);
+  if (error != std::errc{} || end != text.data() + text.size() ||
+      milliseconds < 0.0) {
+    throw std::invalid_argument("invalid latency in milliseconds: " +
+                                std::string(text));
+  }
+  return milliseconds;
+}
+
+/**
+ * @brief Moves the values of acquisition data into numeric blocks, the way
+ * the ICL sends them in binary mode.
+ */
+std::vector<BinaryBlock> take_binary_blocks(nlohmann::json& response) {
+  std::vector<BinaryBlock> blocks;
+  for (auto& acquisition : response["results"]["acquisition"]) {
+    for (auto& roi : acquisition["roi"]) {
+      for (const auto axis : {BinaryBlock::Axis::X, BinaryBlock::Axis::Y}) {
+        const auto* key = axis == BinaryBlock::Axis::X ? "xData" : "yData";
+        BinaryBlock block;
+        block.acquisition_index = acquisition["acqIndex"].get<int>();
+        block.roi_index = roi["roiIndex"].get<int>();
+        block.axis = axis;
+        block.element_type = axis == BinaryBlock::Axis::X
+                                 ? BinaryBlock::ElementType::FLOAT64
+                                 : BinaryBlock::ElementType::UINT32;
+        block.rows = static_cast<int>(roi[key].size());
+        for (const auto& row : roi[key]) {
+          for (const auto& value : row) {
+            block.values.push_back(value.get<double>());
+          }
+        }
+        roi.erase(key);
+        blocks.push_back(std::move(block));
+      }
+    }
+  }
+  return blocks;
+}
+
+}  // namespace
+
+LatencyDistribution LatencyDistribution::fixed(
+    std::chrono::microseconds latency) {
+  LatencyDistribution distribution;
+  distribution.distribution_kind = Kind::FIXED;
+  distribution.first = microseconds(latency);
+  return distribution;
+}
+
+LatencyDistribution LatencyDistribution::uniform(
+    std::chrono::microseconds minimum, std::chrono::microseconds maximum) {
+  if (maximum < minimum) {
+    throw std::invalid_argument(
+        "maximum latency must not be smaller than the minimum");
+  }
+  LatencyDistribution distribution;
+  distribution.distribution_kind = Kind::UNIFORM;
+  distribution.first = microseconds(minimum);
+  distribution.second = microseconds(maximum);
+  return distribution;
+}
+
+LatencyDistribution LatencyDistribution::normal(
+    std::chrono::microseconds mean,
+    std::chrono::microseconds standard_deviation) {
+  LatencyDistribution distribution;
+  distribution.distribution_kind = Kind::NORMAL;
+  distribution.first = microseconds(mean);
+  distribution.second = microseconds(standard_deviation);
+  return distribution;
+}
+
+LatencyDistribution LatencyDistribution::parse(std::string_view text) {
+  std::vector<std::string_view> fields;
+  std::size_t start = 0;
+  while (true) {
+    const auto separator = text.find(':', start);
+    fields.push_back(text.substr(start, separator - start));
+    if (separator == std::string_view::npos) {
+      break;
+    }
+    start = separator + 1;
+  }
+
+  const auto to_duration = [](std::string_view field) {
+    return std::chrono::microseconds(
+        static_cast<long long>(parse_milliseconds(field) * 1000.0));
+  };
+  if (fields[0] == "none" && fields.size() == 1) {
+    return {};
+  }
+  if (fields[0] == "fixed" && fields.size() == 2) {
+    return fixed(to_duration(fields[1]));
+  }
+  if (fields[0] == "uniform" && fields.size() == 3) {
+    return uniform(to_duration(fields[1]), to_duration(fields[2]));
+  }
+  if (fields[0] == "normal" && fields.size() == 3) {
+    return normal(to_duration(fields[1]), to_duration(fields[2]));
+  }
+  throw std::invalid_argument("invalid latency distribution: " +
+                              std::string(text));
+}
+
+std::chrono::microseconds LatencyDistribution::sample(
+    std::mt19937_64& generator) const {
+  double latency = 0.0;
+  switch (this->distribution_kind) {
+    case Kind::NONE:
+      break;
+    case Kind::FIXED:
+      latency = this->first;
+      break;
+    case Kind::UNIFORM:
+      latency = std::uniform_real_distribution<double>(this->first,
+                                                       this->second)(generator);
+      break;
+    case Kind::NORMAL:
+      latency = std::normal_distribution<double>(this->first,
+                                                 this->second)(generator);
+      break;
+  }
+  return std::chrono::microseconds(
+      static_cast<long long>(std::max(latency, 0.0)));
+}
+
+LatencyDistribution::Kind LatencyDistribution::kind() const {
+  return this->distribution_kind;
+}
+
+nlohmann::json synthetic_acquisition_results(ChipSize chip) {
+  const auto columns = static_cast<std::size_t>(chip.columns);
+  const auto rows = static_cast<std::size_t>(chip.rows);
+  std::vector<int> x_row(columns);
+  std::vector<std::vector<int>> y_rows(rows, std::vector<int>(columns));
+  for (std::size_t column = 0; column < columns; column++) {
+    x_row[column] = static_cast<int>(column);
+    for (std::size_t row = 0; row < rows; row++) {
+      // plausible counts, with enough digits to weigh on parsing
+      y_rows[row][column] = static_cast<int>(600 + (column * 7 + row) % 50000);
+    }
+  }
+  return {{"acquisition",
+           nlohmann::json::array({{{"acqIndex", 1},
+                                   {"roi", nlohmann::json::array(
+                                               {{{"roiIndex", 1},
+                                                 {"xOrigin", 0},
+                                                 {"yOrigin", 0},
+                                                 {"xSize", chip.columns},
+                                                 {"ySize", chip.rows},
+                                                 {"xBinning", 1},
+                                                 {"yBinning", 1},
+                                                 {"xData", {x_row}},
+                                                 {"yData", y_rows}}})}}})},
+          {"timestamp", "2024.04.22 15:07:50.096"}};
+}
+
+/**
+ * @brief One websocket connection. All its handlers run on its strand.
+ */
+class ICLServer::Session : public std::enable_shared_from_this<Session> {
+ public:
+  Session(ICLServer& server, boost::asio::ip::tcp::socket socket,
+          std::uint64_t seed)
+      : server{server},
+        websocket{std::move(socket)},
+        generator{seed},
+        binary_mode{server.config.binary_messages} {}
+
+  void run() {
+    boost::asio::dispatch(
+        this->websocket.get_executor(), [self = this->shared_from_this()] {
+          self->websocket.next_layer().socket().set_option(
+              boost::asio::ip::tcp::no_delay(true));
+          self->websocket.set_option(
+              boost::beast::websocket::stream_base::decorator(
+                  [](boost::beast::websocket::response_type& response) {
+                    response.set(boost::beast::http::field::server,
+                                 "horiba fake ICL");
+                  }));
+          self->websocket.async_accept([self](boost::beast::error_code error) {
+            if (error) {
+              spdlog::debug("[ICLServer] accept: {}", error.message());
+              return;
+            }
+            self->do_read();
+          });
+        });
+  }
+
+ private:
+  ICLServer& server;
+  boost::beast::websocket::stream<boost::beast::tcp_stream> websocket;
+  boost::beast::flat_buffer read_buffer;
+  std::deque<Reply> write_queue;
+  std::mt19937_64 generator;
+  bool binary_mode;
+
+  void do_read() {
+    this->websocket.async_read(
+        this->read_buffer,
+        [self = this->shared_from_this()](boost::beast::error_code error,
+                                          std::size_t /*bytes_read*/) {
+          self->on_read(error);
+        });
+  }
+
+  void on_read(boost::beast::error_code error) {
+    if (error) {
+      if (error != boost::beast::websocket::error::closed &&
+          error != boost::asio::error::operation_aborted) {
+        spdlog::debug("[ICLServer] read: {}", error.message());
+      }
+      return;
+    }
+
+    std::string command;
+    unsigned long long int id = 0;
+    try {
+      const auto frame = this->read_buffer.cdata();
+      const auto* begin = static_cast<const char*>(frame.data());
+      const auto request = nlohmann::json::parse(begin, begin + frame.size());
+      command = request.at("command").get<std::string>();
+      id = request.value("id", 0ULL);
+      if (command == "icl_binMode") {
+        this->binary_mode =
+            request.value("parameters", nlohmann::json::object())
+                .value("mode", "off") != "off";
+      }
+    } catch (const nlohmann::json::exception& e) {
+      spdlog::error("[ICLServer] invalid command: {}", e.what());
+      this->read_buffer.consume(this->read_buffer.size());
+      this->do_read();
+      return;
+    }
+    this->read_buffer.consume(this->read_buffer.size());
+    this->server.command_count.fetch_add(1, std::memory_order_relaxed);
+
+    const auto& behavior = this->server.behavior(command);
+    if (this->happens(behavior.disconnect_probability)) {
+      spdlog::debug("[ICLServer] injected disconnect on {}", command);
+      this->websocket.async_close(
+          boost::beast::websocket::close_code::going_away,
+          [self = this->shared_from_this()](boost::beast::error_code) {});
+      return;
+    }
+
+    if (!this->happens(behavior.drop_probability)) {
+      Reply reply =
+          this->happens(behavior.error_probability)
+              ? ICLServer::error_reply(id, command, behavior.error_message)
+              : this->server.reply(id, command, this->binary_mode);
+      const auto latency = behavior.latency.sample(this->generator);
+      if (latency.count() == 0) {
+        this->queue(std::move(reply));
+      } else {
+        auto timer = std::make_shared<boost::asio::steady_timer>(
+            this->websocket.get_executor(), latency);
+        timer->async_wait([self = this->shared_from_this(), timer,
+                           reply = std::move(reply)](
+                              boost::beast::error_code wait_error) mutable {
+          if (!wait_error) {
+            self->queue(std::move(reply));
+          }
+        });
+      }
+    }
+
+    this->do_read();
+  }
+
+  bool happens(double probability) {
+    return probability > 0.0 &&
+           std::uniform_real_distribution<double>(0.0, 1.0)(this->generator) <
+               probability;
+  }
+
+  void queue(Reply reply) {
+    this->write_queue.push_back(std::move(reply));
+    if (this->write_queue.size() == 1) {
+      this->do_write();
+    }
+  }
+
+  void do_write() {
+    const auto& reply = this->write_queue.front();
+    this->websocket.binary(reply.binary);
+    const auto buffer = reply.binary ? boost::asio::buffer(reply.frame)
+                                     : boost::asio::buffer(reply.text);
+    this->websocket.async_write(
+        buffer, [self = this->shared_from_this()](
+                    boost::beast::error_code error,
+                    std::size_t /*bytes_written*/) { self->on_write(error); });
+  }
+
+  void on_write(boost::beast::error_code error) {
+    if (error) {
+      spdlog::debug("[ICLServer] write: {}", error.message());
+      this->write_queue.clear();
+      return;
+    }
+    this->write_queue.pop_front();
+    if (!this->write_queue.empty()) {
+      this->do_write();
+    }
+  }
+};
+
+ICLServer::ICLServer(ICLServerConfig config)
+    : config{std::move(config)}, acceptor{context} {
+  this->load_canned_responses();
+  if (this->config.synthetic_chip) {
+    const auto chip = *this->config.synthetic_chip;
+    this->add_canned_response(
+        "ccd_getChipSize",
+        {{"command", "ccd_getChipSize"},
+         {"results", {{"x", chip.columns}, {"y", chip.rows}}},
+         {"errors", nlohmann::json::array()}});
+    this->add_canned_response(
+        "ccd_getAcquisitionData",
+        {{"command", "ccd_getAcquisitionData"},
+         {"results", synthetic_acquisition_results(chip)},
+         {"errors", nlohmann::json::array()}});
+  }
+
+  const boost::asio::ip::tcp::endpoint endpoint{
+      boost::asio::ip::make_address(this->config.address), this->config.port};
+  this->acceptor.open(endpoint.protocol());
+  this->acceptor.set_option(boost::asio::socket_base::reuse_address(true));
+  this->acceptor.bind(endpoint);
+  this->acceptor.listen(boost::asio::socket_base::max_listen_connections);
+  spdlog::debug("[ICLServer] listening on {}:{}", this->config.address,
+                this->port());
+
+  this->do_accept();
+  const auto thread_count = std::max<std::size_t>(this->config.threads, 1);
+  for (std::size_t i = 0; i < thread_count; i++) {
+    this->threads.emplace_back([this] { this->context.run(); });
+  }
+}
+
+ICLServer::~ICLServer() { this->stop(); }
+
+unsigned short ICLServer::port() const {
+  return this->acceptor.local_endpoint().port();
+}
+
+std::uint64_t ICLServer::received_commands() const {
+  return this->command_count.load(std::memory_order_relaxed);
+}
+
+void ICLServer::stop() {
+  if (this->stopped.exchange(true)) {
+    return;
+  }
+  this->context.stop();
+  for (auto& thread : this->threads) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
+  boost::beast::error_code ignored;
+  this->acceptor.close(ignored);
+  spdlog::debug("[ICLServer] stopped after {} commands",
+                this->received_commands());
+}
+
+void ICLServer::load_canned_responses() {
+  if (this->config.responses_folder.empty()) {
+    return;
+  }
+  for (const auto* file_name : {"icl.json", "ccd.json", "monochromator.json"}) {
+    const auto file_path = this->config.responses_folder / file_name;
+    std::ifstream file(file_path);
+    if (!file) {
+      throw std::runtime_error("cannot read fake responses from " +
+                               file_path.string());
+    }
+    auto responses = nlohmann::json::parse(file);
+    for (auto& [command, response] : responses.items()) {
+      this->add_canned_response(command, std::move(response));
+    }
+  }
+}
+
+void ICLServer::add_canned_response(const std::string& command,
+                                    nlohmann::json response) {
+  CannedResponse canned;
+  response.erase("id");
+  canned.text_after_id = response.dump().substr(1);
+  if (response.contains("results") &&
+      response["results"].contains("acquisition")) {
+    canned.binary_blocks = take_binary_blocks(response);
+    canned.binary_metadata = std::move(response);
+  }
+  this->canned_responses.insert_or_assign(command, std::move(canned));
+}
+
+void ICLServer::do_accept() {
+  this->acceptor.async_accept(
+      boost::asio::make_strand(this->context),
+      [this](boost::beast::error_code error,
+             boost::asio::ip::tcp::socket socket) {
+        if (error) {
+          if (error != boost::asio::error::operation_aborted) {
+            spdlog::error("[ICLServer] accept: {}", error.message());
+          }
+        } else {
+          std::make_shared<Session>(
+              *this, std::move(socket),
+              this->config.seed +
+                  this->session_count.fetch_add(1, std::memory_order_relaxed))
+              ->run();
+        }
+        if (!this->stopped.load() && this->acceptor.is_open()) {
+          this->do_accept();
+        }
+      });
+}
+
+const CommandBehavior& ICLServer::behavior(const std::string& command) const {
+  const auto behavior = this->config.command_behaviors.find(command);
+  return behavior == this->config.command_behaviors.end()
+             ? this->config.default_behavior
+             : behavior->second;
+}
+
+ICLServer::Reply ICLServer::reply(unsigned long long int id,
+                                  const std::string& command,
+                                  bool binary_mode) const {
+  const auto canned = this->canned_responses.find(command);
+  if (canned == this->canned_responses.end()) {
+    return Reply{false,
+                 nlohmann::json{{"id", id},
+                                {"command", command},
+                                {"results", nlohmann::json::object()},
+                                {"errors", nlohmann::json::array()}}
+                     .dump(),
+                 {}};
+  }
+
+  if (binary_mode && canned->second.binary_metadata) {
+    auto metadata = *canned->second.binary_metadata;
+    metadata["id"] = id;
+    return Reply{true,
+                 {},
+                 communication::BinaryMessage::encode(
+                     metadata, canned->second.binary_blocks)};
+  }
+
+  const auto& text_after_id = canned->second.text_after_id;
+  std::string text = "{\"id\":" + std::to_string(id);
+  text.reserve(text.size() + text_after_id.size() + 1);
+  if (text_after_id != "}") {
+    text += ',';
+  }
+  text += text_after_id;
+  return Reply{false, std::move(text), {}};
+}
+
+ICLServer::Reply ICLServer::error_reply(unsigned long long int id,
+                                        const std::string& command,
+                                        const std::string& error_message) {
+  return Reply{
+      false,
+      nlohmann::json{{"id", id},
+                     {"command", command},
+                     {"results", nlohmann::json::object()},
+                     {"errors", nlohmann::json::array({error_message})}}
+          .dump(),
+      {}};
+}
+
+} /* namespace horiba::fake_icl */
@@ -0,0 +1,157 @@
+#include <spdlog/spdlog.h>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/signal_set.hpp>
+#include <csignal>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "fake_icl/icl_server.h"
+
+namespace {
+
+using horiba::fake_icl::ChipSize;
+using horiba::fake_icl::CommandBehavior;
+using horiba::fake_icl::ICLServerConfig;
+using horiba::fake_icl::LatencyDistribution;
+
+constexpr std::string_view USAGE = R"(Usage: fake_icl_server [options]
+
+Fake ICL answering websocket commands, for load and timeout testing.
+
+Options:
+  --address <ip>              Address to listen on (default 127.0.0.1)
+  --port <port>               Port to listen on, 0 for any (default 25010)
+  --threads <count>           Threads serving the sessions (default 1)
+  --responses <folder>        Folder of icl.json, ccd.json and monochromator.json
+  --latency [<command>=]<distribution>
+                              Latency of a command, or of all the commands
+                              without a command. Distributions in ms:
+                              none, fixed:<ms>, uniform:<min>:<max>,
+                              normal:<mean>:<stddev>
+  --error-rate [<command>=]<probability>
+                              Probability to answer with an error
+  --drop-rate [<command>=]<probability>
+                              Probability to never answer
+  --disconnect-rate [<command>=]<probability>
+                              Probability to close the connection
+  --chip <columns>x<rows>     Answer acquisitions with a synthetic chip
+  --binary                    Send acquisitions as binary messages
+  --seed <seed>               Seed of the random generators (default 0)
+  --verbose                   Log every session
+  --help                      Show this help
+)";
+
+/**
+ * @brief Behavior of the command before '=' in the value, the default one
+ * without '='.
+ */
+CommandBehavior& behavior_of(ICLServerConfig& config, std::string_view& value) {
+  const auto separator = value.find('=');
+  if (separator == std::string_view::npos) {
+    return config.default_behavior;
+  }
+  const std::string command{value.substr(0, separator)};
+  value.remove_prefix(separator + 1);
+  auto inserted =
+      config.command_behaviors.try_emplace(command, config.default_behavior);
+  return inserted.first->second;
+}
+
+double parse_probability(std::string_view value) {
+  const double probability = std::stod(std::string(value));
+  if (probability < 0.0 || probability > 1.0) {
+    throw std::invalid_argument("probability must be between 0 and 1: " +
+                                std::string(value));
+  }
+  return probability;
+}
+
+ChipSize parse_chip(std::string_view value) {
+  const auto separator = value.find('x');
+  if (separator == std::string_view::npos) {
+    throw std::invalid_argument("chip size must be <columns>x<rows>: " +
+                                std::string(value));
+  }
+  return ChipSize{std::stoi(std::string(value.substr(0, separator))),
+                  std::stoi(std::string(value.substr(separator + 1)))};
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  spdlog::set_level(spdlog::level::info);
+  ICLServerConfig config;
+
+  try {
+    for (int i = 1; i < argc; i++) {
+      const std::string_view option{argv[i]};
+      if (option == "--help") {
+        std::cout << USAGE;
+        return 0;
+      }
+      if (option == "--binary") {
+        config.binary_messages = true;
+        continue;
+      }
+      if (option == "--verbose") {
+        spdlog::set_level(spdlog::level::debug);
+        continue;
+      }
+      if (i + 1 >= argc) {
+        throw std::invalid_argument("missing value for " + std::string(option));
+      }
+      std::string_view value{argv[++i]};
+      if (option == "--address") {
+        config.address = value;
+      } else if (option == "--port") {
+        config.port =
+            static_cast<unsigned short>(std::stoi(std::string(value)));
+      } else if (option == "--threads") {
+        config.threads = std::stoul(std::string(value));
+      } else if (option == "--responses") {
+        config.responses_folder = value;
+      } else if (option == "--latency") {
+        auto& behavior = behavior_of(config, value);
+        behavior.latency = LatencyDistribution::parse(value);
+      } else if (option == "--error-rate") {
+        auto& behavior = behavior_of(config, value);
+        behavior.error_probability = parse_probability(value);
+      } else if (option == "--drop-rate") {
+        auto& behavior = behavior_of(config, value);
+        behavior.drop_probability = parse_probability(value);
+      } else if (option == "--disconnect-rate") {
+        auto& behavior = behavior_of(config, value);
+        behavior.disconnect_probability = parse_probability(value);
+      } else if (option == "--chip") {
+        config.synthetic_chip = parse_chip(value);
+      } else if (option == "--seed") {
+        config.seed = std::stoull(std::string(value));
+      } else {
+        throw std::invalid_argument("unknown option " + std::string(option));
+      }
+    }
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << "\n\n" << USAGE;
+    return 1;
+  }
+
+  try {
+    horiba::fake_icl::ICLServer server(config);
+    spdlog::info("fake ICL listening on {}:{}", config.address, server.port());
+
+    boost::asio::io_context signals_context;
+    boost::asio::signal_set signals(signals_context, SIGINT, SIGTERM);
+    signals.async_wait([](const boost::system::error_code&, int) {});
+    signals_context.run();
+
+    spdlog::info("fake ICL stopping after {} commands",
+                 server.received_commands());
+  } catch (const std::exception& e) {
+    spdlog::error("fake ICL failed: {}", e.what());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,68 @@
+#ifndef ALIGNED_ALLOCATOR_H
+#define ALIGNED_ALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace horiba::common {
+
+/**
+ * @brief Size of a cache line on the platforms supported by the SDK.
+ */
+inline constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * @brief Allocator returning memory aligned on the given boundary.
+ *
+ * Used for numeric buffers so that they start on a cache line and can be used
+ * by vectorized code without peeling.
+ *
+ * @tparam T Type of the allocated elements
+ * @tparam Alignment Alignment in bytes, a power of two
+ */
+template <typename T, std::size_t Alignment = CACHE_LINE_SIZE>
+class AlignedAllocator {
+ public:
+  static_assert((Alignment & (Alignment - 1)) == 0,
+                "Alignment must be a power of two");
+  static_assert(Alignment >= alignof(T),
+                "Alignment must be at least the alignment of T");
+
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() noexcept = default;
+
+  template <typename U>
+  explicit AlignedAllocator(
+      const AlignedAllocator<U, Alignment>& /*other*/) noexcept {}
+
+  [[nodiscard]] T* allocate(std::size_t count) {
+    return static_cast<T*>(
+        ::operator new(count * sizeof(T), std::align_val_t{Alignment}));
+  }
+
+  void deallocate(T* pointer, std::size_t /*count*/) noexcept {
+    ::operator delete(pointer, std::align_val_t{Alignment});
+  }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, Alignment>& /*other*/)
+      const noexcept {
+    return true;
+  }
+};
+
+/**
+ * @brief Contiguous vector whose storage starts on a cache line.
+ */
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+} /* namespace horiba::common */
+#endif /* ifndef ALIGNED_ALLOCATOR_H */
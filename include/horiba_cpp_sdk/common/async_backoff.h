@@ -0,0 +1,65 @@
+#ifndef ASYNC_BACKOFF_H
+#define ASYNC_BACKOFF_H
+
+#include <horiba_cpp_sdk/common/exponential_backoff.h>
+
+#include <algorithm>
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <chrono>
+
+namespace horiba::common {
+
+/**
+ * @brief Sleeps in a coroutine until the given time, without blocking the
+ * thread of its executor.
+ *
+ * @param wake_up_time Time at which the coroutine is resumed
+ *
+ * @throw boost::system::system_error if the coroutine got cancelled
+ */
+inline boost::asio::awaitable<void> async_sleep_until(
+    std::chrono::steady_clock::time_point wake_up_time) {
+  boost::asio::steady_timer timer{co_await boost::asio::this_coro::executor,
+                                  wake_up_time};
+  co_await timer.async_wait(boost::asio::use_awaitable);
+}
+
+/**
+ * @brief Awaits a predicate with backoff delays until it returns true or the
+ * deadline is reached, see poll_until(). The delays are waited on a timer, the
+ * thread of the executor keeps running other coroutines meanwhile.
+ *
+ * @param predicate Callable returning a boost::asio::awaitable<bool> of the
+ * condition to wait for, awaited at least once. It is kept until the polling
+ * is done, so it can be a lambda coroutine with captures.
+ * @param deadline Time after which the predicate is not awaited anymore
+ * @param backoff Delays to wait between two calls of the predicate
+ *
+ * @return True if the predicate returned true before the deadline, false if
+ * the deadline is reached
+ *
+ * @throw boost::system::system_error if the coroutine got cancelled
+ */
+template <typename Predicate>
+boost::asio::awaitable<bool> async_poll_until(
+    Predicate predicate, std::chrono::steady_clock::time_point deadline,
+    ExponentialBackoff backoff) {
+  while (true) {
+    if (co_await predicate()) {
+      co_return true;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+      co_return false;
+    }
+    co_await async_sleep_until(
+        std::min<std::chrono::steady_clock::time_point>(
+            now + backoff.next_delay(), deadline));
+  }
+}
+
+} /* namespace horiba::common */
+#endif /* ifndef ASYNC_BACKOFF_H */
@@ -0,0 +1,153 @@
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include <horiba_cpp_sdk/common/aligned_allocator.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace horiba::common {
+
+/**
+ * @brief Thread safe pool of spare buffers, to write the values of a frame
+ * into the buffers of an older one instead of allocating new ones.
+ *
+ * A buffer keeps its capacity while it is in the pool, so once the pool holds
+ * the buffers of a frame the next frames of the same size do not allocate.
+ *
+ * @tparam T Type of the values of the buffers
+ */
+template <typename T>
+class BufferPool {
+ public:
+  /**
+   * @brief Creates an empty pool.
+   *
+   * @param max_buffers Number of spare buffers kept, buffers released while
+   * the pool is full are freed
+   */
+  explicit BufferPool(std::size_t max_buffers = 16)
+      : max_buffers{max_buffers} {
+    // releasing a buffer never allocates
+    this->spare_buffers.reserve(max_buffers);
+  }
+
+  /**
+   * @brief Sets the number of values reserved for the y values of a region
+   * of interest of a frame, see
+   * ChargeCoupledDevice::set_acquisition_buffer_size().
+   *
+   * @param size Number of values of a frame buffer
+   */
+  void set_buffer_size(std::size_t size) {
+    const std::lock_guard<std::mutex> lock(this->mutex);
+    this->frame_size = size;
+  }
+
+  /**
+   * @brief Number of values of a frame buffer, 0 when unknown.
+   *
+   * @return Number of values of a frame buffer
+   */
+  [[nodiscard]] std::size_t buffer_size() const {
+    const std::lock_guard<std::mutex> lock(this->mutex);
+    return this->frame_size;
+  }
+
+  /**
+   * @brief Allocates spare buffers up front, so that the first frames do not
+   * allocate either.
+   *
+   * @param count Number of buffers to add, as many as fit in the pool
+   * @param capacity Number of values reserved in each buffer
+   */
+  void preallocate(std::size_t count, std::size_t capacity) {
+    const std::lock_guard<std::mutex> lock(this->mutex);
+    for (std::size_t i = 0;
+         i < count && this->spare_buffers.size() < this->max_buffers; ++i) {
+      AlignedVector<T> buffer;
+      buffer.reserve(capacity);
+      this->spare_buffers.push_back(std::move(buffer));
+    }
+  }
+
+  /**
+   * @brief Takes an empty buffer out of the pool.
+   *
+   * @param min_capacity Number of values the buffer should hold without
+   * growing
+   *
+   * @return The smallest spare buffer holding min_capacity values, or else the
+   * largest spare buffer or a new one, reserved for min_capacity values
+   */
+  AlignedVector<T> acquire(std::size_t min_capacity = 0) {
+    // the smallest buffer large enough, or else the largest one
+    const auto better = [min_capacity](const AlignedVector<T>& candidate,
+                                       const AlignedVector<T>& chosen) {
+      const bool candidate_fits = candidate.capacity() >= min_capacity;
+      const bool chosen_fits = chosen.capacity() >= min_capacity;
+      if (candidate_fits != chosen_fits) {
+        return candidate_fits;
+      }
+      return candidate_fits ? candidate.capacity() < chosen.capacity()
+                            : candidate.capacity() > chosen.capacity();
+    };
+
+    AlignedVector<T> buffer;
+    {
+      const std::lock_guard<std::mutex> lock(this->mutex);
+      if (!this->spare_buffers.empty()) {
+        auto chosen = this->spare_buffers.begin();
+        for (auto spare = chosen + 1; spare != this->spare_buffers.end();
+             ++spare) {
+          if (better(*spare, *chosen)) {
+            chosen = spare;
+          }
+        }
+        std::iter_swap(chosen, this->spare_buffers.end() - 1);
+        buffer = std::move(this->spare_buffers.back());
+        this->spare_buffers.pop_back();
+      }
+    }
+    buffer.reserve(min_capacity);
+    return buffer;
+  }
+
+  /**
+   * @brief Hands a buffer back to the pool.
+   *
+   * @param buffer The buffer, cleared but keeping its capacity
+   */
+  void release(AlignedVector<T> buffer) {
+    if (buffer.capacity() == 0) {
+      return;
+    }
+    buffer.clear();
+    const std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->spare_buffers.size() < this->max_buffers) {
+      this->spare_buffers.push_back(std::move(buffer));
+    }
+  }
+
+  /**
+   * @brief Number of spare buffers in the pool.
+   *
+   * @return Number of spare buffers
+   */
+  [[nodiscard]] std::size_t available() const {
+    const std::lock_guard<std::mutex> lock(this->mutex);
+    return this->spare_buffers.size();
+  }
+
+ private:
+  mutable std::mutex mutex;
+  std::size_t max_buffers;
+  std::size_t frame_size = 0;
+  std::vector<AlignedVector<T>> spare_buffers;
+};
+
+} /* namespace horiba::common */
+#endif /* ifndef BUFFER_POOL_H */
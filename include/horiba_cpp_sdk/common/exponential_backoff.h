@@ -0,0 +1,112 @@
+#ifndef EXPONENTIAL_BACKOFF_H
+#define EXPONENTIAL_BACKOFF_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stop_token>
+
+namespace horiba::common {
+
+/**
+ * @brief Delays growing exponentially between a minimum and a maximum, used to
+ * poll a device: fast at first so that short operations are noticed quickly,
+ * then slower so that long operations do not flood the ICL.
+ */
+class ExponentialBackoff {
+ public:
+  /**
+   * @brief Creates a backoff.
+   *
+   * @param initial_delay First delay returned
+   * @param max_delay Upper bound of the delays
+   * @param factor Factor applied to the delay after each call to next_delay()
+   */
+  constexpr ExponentialBackoff(std::chrono::milliseconds initial_delay,
+                               std::chrono::milliseconds max_delay,
+                               int factor = 2)
+      : initial_delay{initial_delay},
+        max_delay{std::max(initial_delay, max_delay)},
+        factor{std::max(factor, 1)},
+        current_delay{initial_delay} {}
+
+  /**
+   * @brief Returns the delay to wait before the next attempt and grows it.
+   *
+   * @return The delay to wait
+   */
+  constexpr std::chrono::milliseconds next_delay() {
+    const auto delay = this->current_delay;
+    this->current_delay =
+        std::min(this->current_delay * this->factor, this->max_delay);
+    return delay;
+  }
+
+  /**
+   * @brief Restarts the delays from the initial delay.
+   */
+  constexpr void reset() { this->current_delay = this->initial_delay; }
+
+ private:
+  std::chrono::milliseconds initial_delay;
+  std::chrono::milliseconds max_delay;
+  int factor;
+  std::chrono::milliseconds current_delay;
+};
+
+/**
+ * @brief Sleeps for the given duration, waking up early if a stop is
+ * requested on the token.
+ *
+ * @param duration Time to sleep
+ * @param stop_token Token to cancel the sleep
+ *
+ * @return False if the sleep got cancelled
+ */
+template <typename Rep, typename Period>
+bool sleep_for(std::chrono::duration<Rep, Period> duration,
+               std::stop_token stop_token) {
+  std::mutex mutex;
+  std::condition_variable_any stopped;
+  std::unique_lock<std::mutex> lock{mutex};
+  return !stopped.wait_for(lock, stop_token, duration, [] { return false; });
+}
+
+/**
+ * @brief Calls a predicate with backoff delays until it returns true or the
+ * deadline is reached. The last delay is shortened so that the predicate is
+ * checked one last time at the deadline, never after.
+ *
+ * @param predicate Condition to wait for, called at least once unless a stop
+ * is already requested
+ * @param deadline Time after which the predicate is not called anymore
+ * @param backoff Delays to wait between two calls of the predicate
+ * @param stop_token Token to cancel the polling
+ *
+ * @return True if the predicate returned true before the deadline, false if
+ * the deadline is reached or the polling got cancelled
+ */
+template <typename Predicate>
+bool poll_until(Predicate&& predicate,
+                std::chrono::steady_clock::time_point deadline,
+                ExponentialBackoff backoff, std::stop_token stop_token = {}) {
+  while (!stop_token.stop_requested()) {
+    if (predicate()) {
+      return true;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+      return false;
+    }
+    const auto delay = std::min<std::chrono::nanoseconds>(
+        backoff.next_delay(), deadline - now);
+    if (!sleep_for(delay, stop_token)) {
+      return false;
+    }
+  }
+  return false;
+}
+
+} /* namespace horiba::common */
+#endif /* ifndef EXPONENTIAL_BACKOFF_H */
@@ -0,0 +1,203 @@
+#ifndef LOGGING_H
+#define LOGGING_H
+
+#include <spdlog/fmt/fmt.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Lowest level of the SDK logs compiled in, one of the SPDLOG_LEVEL_*
+ * values. Logs below it cost nothing at run time, e.g. define it to
+ * SPDLOG_LEVEL_INFO to strip the debug logs of the command path from a release
+ * build.
+ */
+#ifndef HORIBA_CPP_SDK_LOG_LEVEL
+#define HORIBA_CPP_SDK_LOG_LEVEL SPDLOG_LEVEL_TRACE
+#endif
+
+/**
+ * @brief Logs with spdlog if the level is compiled in and enabled at run time.
+ * Unlike calling spdlog directly, the arguments are only evaluated when the
+ * message is logged.
+ */
+#define HORIBA_CPP_SDK_LOG(level, spdlog_level, ...)        \
+  do {                                                      \
+    if constexpr ((level) >= HORIBA_CPP_SDK_LOG_LEVEL) {    \
+      if (spdlog::should_log(spdlog_level)) {               \
+        spdlog::log(spdlog_level, __VA_ARGS__);             \
+      }                                                     \
+    }                                                       \
+  } while (false)
+
+#define HORIBA_LOG_TRACE(...) \
+  HORIBA_CPP_SDK_LOG(SPDLOG_LEVEL_TRACE, spdlog::level::trace, __VA_ARGS__)
+#define HORIBA_LOG_DEBUG(...) \
+  HORIBA_CPP_SDK_LOG(SPDLOG_LEVEL_DEBUG, spdlog::level::debug, __VA_ARGS__)
+#define HORIBA_LOG_INFO(...) \
+  HORIBA_CPP_SDK_LOG(SPDLOG_LEVEL_INFO, spdlog::level::info, __VA_ARGS__)
+
+namespace horiba::common {
+
+/**
+ * @brief Maximum number of characters of a payload written to the logs, see
+ * LoggedJson and LoggedText.
+ *
+ * @return The current maximum, 1024 by default
+ */
+inline std::atomic<std::size_t>& max_logged_payload_size() {
+  static std::atomic<std::size_t> max_size{1024};
+  return max_size;
+}
+
+/**
+ * @brief Json logged as text, only serialized when the message is formatted and
+ * only up to max_logged_payload_size().
+ */
+struct LoggedJson {
+  const nlohmann::json& json;
+};
+
+/**
+ * @brief Text logged truncated to max_logged_payload_size(), e.g. a raw frame
+ * received from the ICL.
+ */
+struct LoggedText {
+  std::string_view text;
+};
+
+/**
+ * @brief Wraps a json so that it is serialized lazily when logged.
+ *
+ * @param json The json to log, must outlive the log call
+ *
+ * @return The payload to pass to the log call
+ */
+inline LoggedJson log_payload(const nlohmann::json& json) { return {json}; }
+
+/**
+ * @brief Wraps a text so that it is truncated when logged.
+ *
+ * @param text The text to log, must outlive the log call
+ *
+ * @return The payload to pass to the log call
+ */
+inline LoggedText log_payload(std::string_view text) { return {text}; }
+
+/**
+ * @brief Wraps a text so that it is truncated when logged.
+ *
+ * @param text The text to log, must outlive the log call
+ *
+ * @return The payload to pass to the log call
+ */
+inline LoggedText log_payload(const std::string& text) { return {text}; }
+
+/**
+ * @brief Truncates a payload to max_logged_payload_size(), noting the size of
+ * the payload if it got truncated.
+ *
+ * @param text The payload
+ *
+ * @return The text to log
+ */
+inline std::string truncated_payload(std::string_view text) {
+  const auto max_size = max_logged_payload_size().load();
+  if (text.size() <= max_size) {
+    return std::string{text};
+  }
+  return std::string{text.substr(0, max_size)} + "... (" +
+         std::to_string(text.size()) + " bytes)";
+}
+
+/**
+ * @brief Output of the json serializer keeping the first characters only. Once
+ * it got more than it keeps, it stops the serialization by throwing Full, so
+ * that a large json is not serialized in full to log its beginning.
+ */
+class TruncatingJsonOutput
+    : public nlohmann::detail::output_adapter_protocol<char> {
+ public:
+  /**
+   * @brief Thrown once the json is longer than the kept characters.
+   */
+  struct Full {};
+
+  /**
+   * @param text Where the characters are appended
+   * @param max_size Number of characters kept
+   */
+  TruncatingJsonOutput(std::string& text, std::size_t max_size)
+      : text{text}, max_size{max_size} {}
+
+  void write_character(char character) override {
+    this->write_characters(&character, 1);
+  }
+
+  void write_characters(const char* characters, std::size_t length) override {
+    const auto kept = std::min(length, this->max_size - this->text.size());
+    this->text.append(characters, kept);
+    if (kept < length) {
+      throw Full{};
+    }
+  }
+
+ private:
+  std::string& text;
+  std::size_t max_size;
+};
+
+/**
+ * @brief Serializes a json up to max_logged_payload_size(), noting that it got
+ * truncated if it is longer.
+ *
+ * @param json The payload
+ *
+ * @return The text to log
+ */
+inline std::string truncated_payload(const nlohmann::json& json) {
+  const auto max_size = max_logged_payload_size().load();
+  std::string text;
+  try {
+    nlohmann::detail::serializer<nlohmann::json> serializer(
+        std::make_shared<TruncatingJsonOutput>(text, max_size), ' ');
+    serializer.dump(json, false, false, 0);
+  } catch (const TruncatingJsonOutput::Full&) {
+    text += "... (truncated)";
+  }
+  return text;
+}
+
+} /* namespace horiba::common */
+
+template <>
+struct fmt::formatter<horiba::common::LoggedJson>
+    : fmt::formatter<fmt::string_view> {
+  template <typename FormatContext>
+  auto format(const horiba::common::LoggedJson& payload,
+              FormatContext& context) const -> decltype(context.out()) {
+    const auto text = horiba::common::truncated_payload(payload.json);
+    return fmt::formatter<fmt::string_view>::format(
+        fmt::string_view{text.data(), text.size()}, context);
+  }
+};
+
+template <>
+struct fmt::formatter<horiba::common::LoggedText>
+    : fmt::formatter<fmt::string_view> {
+  template <typename FormatContext>
+  auto format(const horiba::common::LoggedText& payload,
+              FormatContext& context) const -> decltype(context.out()) {
+    const auto text = horiba::common::truncated_payload(payload.text);
+    return fmt::formatter<fmt::string_view>::format(
+        fmt::string_view{text.data(), text.size()}, context);
+  }
+};
+
+#endif /* ifndef LOGGING_H */
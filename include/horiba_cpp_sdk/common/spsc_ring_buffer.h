@@ -0,0 +1,125 @@
+#ifndef SPSC_RING_BUFFER_H
+#define SPSC_RING_BUFFER_H
+
+#include <horiba_cpp_sdk/common/aligned_allocator.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace horiba::common {
+
+/**
+ * @brief Bounded lock-free ring buffer for one producer thread and one consumer
+ * thread.
+ *
+ * All slots are allocated when the ring is built. Values are swapped in and out
+ * of the slots instead of being copied, so that a producer or consumer reusing
+ * the value it gets back keeps the buffers of the values alive and does not
+ * allocate once the ring is warmed up.
+ *
+ * The producer never waits: a value pushed while the ring is full is dropped
+ * and counted, see dropped().
+ *
+ * @tparam T Type of the values, default constructible and swappable
+ */
+template <typename T>
+class SpscRingBuffer {
+ public:
+  /**
+   * @brief Creates a ring holding up to capacity values.
+   *
+   * @param capacity Maximum number of values waiting for the consumer, at
+   * least 1
+   */
+  explicit SpscRingBuffer(std::size_t capacity)
+      : slots(std::max<std::size_t>(capacity, 1) + 1) {}
+
+  /**
+   * @brief Pushes a value, called by the producer only.
+   *
+   * @param value The value to push. If pushed, it is swapped with the previous
+   * content of the slot, which can be reused by the producer.
+   *
+   * @return True if pushed, false if the ring was full and the value got
+   * dropped
+   */
+  bool try_push(T& value) {
+    const auto tail = this->tail_index.load(std::memory_order_relaxed);
+    const auto next_tail = this->next(tail);
+    if (next_tail == this->head_index.load(std::memory_order_acquire)) {
+      this->dropped_count.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    using std::swap;
+    swap(this->slots[tail], value);
+    this->tail_index.store(next_tail, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Pops the oldest value, called by the consumer only.
+   *
+   * @param value Receives the value. Its previous content is swapped into the
+   * freed slot, to be reused by the producer.
+   *
+   * @return True if a value got popped, false if the ring was empty
+   */
+  bool try_pop(T& value) {
+    const auto head = this->head_index.load(std::memory_order_relaxed);
+    if (head == this->tail_index.load(std::memory_order_acquire)) {
+      return false;
+    }
+    using std::swap;
+    swap(value, this->slots[head]);
+    this->head_index.store(this->next(head), std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Number of values waiting for the consumer. Only a snapshot when the
+   * other thread is running.
+   *
+   * @return Number of values in the ring
+   */
+  [[nodiscard]] std::size_t size() const {
+    const auto head = this->head_index.load(std::memory_order_acquire);
+    const auto tail = this->tail_index.load(std::memory_order_acquire);
+    return tail >= head ? tail - head : tail + this->slots.size() - head;
+  }
+
+  /**
+   * @brief Maximum number of values waiting for the consumer.
+   *
+   * @return Capacity of the ring
+   */
+  [[nodiscard]] std::size_t capacity() const { return this->slots.size() - 1; }
+
+  /**
+   * @brief Number of values dropped by try_push() because the ring was full.
+   *
+   * @return Number of dropped values
+   */
+  [[nodiscard]] std::uint64_t dropped() const {
+    return this->dropped_count.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // one slot is always left empty to tell a full ring from an empty one
+  std::vector<T> slots;
+  // the indexes live on their own cache lines, so that the producer and the
+  // consumer do not invalidate each other's line on every operation
+  alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> head_index{0};
+  alignas(CACHE_LINE_SIZE) std::atomic<std::size_t> tail_index{0};
+  alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> dropped_count{0};
+
+  [[nodiscard]] std::size_t next(std::size_t index) const {
+    return index + 1 == this->slots.size() ? 0 : index + 1;
+  }
+};
+
+} /* namespace horiba::common */
+#endif /* ifndef SPSC_RING_BUFFER_H */
@@ -0,0 +1,105 @@
+#ifndef ASYNC_REQUEST_H
+#define ASYNC_REQUEST_H
+
+#include <boost/asio/associated_cancellation_slot.hpp>
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/async_result.hpp>
+#include <boost/asio/cancellation_type.hpp>
+#include <boost/asio/execution/outstanding_work.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/prefer.hpp>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stop_token>
+#include <type_traits>
+#include <utility>
+
+#include "horiba_cpp_sdk/communication/command.h"
+#include "horiba_cpp_sdk/communication/communicator.h"
+#include "horiba_cpp_sdk/communication/response.h"
+
+namespace horiba::communication {
+
+namespace detail {
+
+/**
+ * @brief Starts a request of Communicator::async_request() for async_request().
+ */
+struct RequestInitiation {
+  template <typename Handler>
+  void operator()(Handler&& handler, Communicator* communicator,
+                  const Command& command, RequestOptions options) const {
+    // the handler is resumed on its own executor, which is kept busy until
+    // then so that e.g. an io_context waiting only on the ICL does not return
+    auto executor = boost::asio::prefer(
+        boost::asio::get_associated_executor(handler),
+        boost::asio::execution::outstanding_work.tracked);
+
+    // cancelling the operation, e.g. with an awaitable operator, cancels the
+    // request
+    auto slot = boost::asio::get_associated_cancellation_slot(handler);
+    if (slot.is_connected() && !options.stop_token.stop_possible()) {
+      std::stop_source stop_source;
+      options.stop_token = stop_source.get_token();
+      slot.assign(
+          [stop_source](boost::asio::cancellation_type /*type*/) mutable {
+            stop_source.request_stop();
+          });
+    }
+
+    // the handler may not be copyable, unlike a Communicator::ResponseHandler
+    auto shared_handler =
+        std::make_shared<std::decay_t<Handler>>(std::forward<Handler>(handler));
+    communicator->async_request(
+        command, options,
+        [shared_handler, executor](std::exception_ptr error,
+                                   Response response) {
+          boost::asio::post(
+              executor, [shared_handler, error,
+                         response = std::move(response)]() mutable {
+                boost::asio::get_associated_cancellation_slot(*shared_handler)
+                    .clear();
+                std::move (*shared_handler)(error, std::move(response));
+              });
+        });
+  }
+};
+
+}  // namespace detail
+
+/**
+ * @brief Sends a command to the ICL and completes with the response, in the
+ * style of the asynchronous operations of asio.
+ *
+ * With boost::asio::use_awaitable, the response can be awaited in a coroutine,
+ * so that a single thread can drive several devices:
+ *
+ * @code{.cpp}
+ * auto response = co_await async_request(communicator, command, {},
+ *                                        boost::asio::use_awaitable);
+ * @endcode
+ *
+ * The completion handler is called on its associated executor. Cancelling the
+ * operation through its cancellation slot cancels the request, unless the
+ * options already hold a stop token.
+ *
+ * @param communicator The communicator sending the command, which must outlive
+ * the operation
+ * @param command The command for the ICL
+ * @param options Deadline and cancellation of the request
+ * @param token Completion token with the signature
+ * void(std::exception_ptr, Response)
+ *
+ * @return As defined by the completion token
+ */
+template <typename CompletionToken>
+auto async_request(Communicator& communicator, const Command& command,
+                   const RequestOptions& options, CompletionToken&& token) {
+  return boost::asio::async_initiate<CompletionToken,
+                                     void(std::exception_ptr, Response)>(
+      detail::RequestInitiation{}, token, &communicator, command, options);
+}
+
+} /* namespace horiba::communication */
+#endif /* ifndef ASYNC_REQUEST_H */
@@ -0,0 +1,126 @@
+#ifndef BINARY_MESSAGE_H
+#define BINARY_MESSAGE_H
+
+#include <horiba_cpp_sdk/common/aligned_allocator.h>
+#include <horiba_cpp_sdk/common/buffer_pool.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <span>
+#include <vector>
+
+namespace horiba::communication {
+
+/**
+ * @brief Block of numeric values carried by a binary message, e.g. the x or y
+ * data of one region of interest of an acquisition.
+ */
+struct BinaryBlock {
+  /**
+   * @brief Axis the values of the block belong to.
+   */
+  enum class Axis : std::uint8_t { X = 0, Y = 1 };
+
+  /**
+   * @brief Type of the values on the wire.
+   */
+  enum class ElementType : std::uint8_t {
+    UINT16 = 1,
+    UINT32 = 2,
+    FLOAT32 = 3,
+    FLOAT64 = 4,
+  };
+
+  int acquisition_index = 0;
+  int roi_index = 0;
+  Axis axis = Axis::X;
+  /**
+   * @brief Number of rows the values are split into. The values are stored
+   * row after row.
+   */
+  int rows = 1;
+  /**
+   * @brief Type of the values on the wire. The decoded values are always
+   * stored as double.
+   */
+  ElementType element_type = ElementType::FLOAT64;
+  common::AlignedVector<double> values;
+};
+
+/**
+ * @brief Represents a binary message of the ICL, sent when binary mode is
+ * enabled with "icl_binMode".
+ *
+ * Large numeric payloads are carried as raw arrays instead of text json. The
+ * layout of a message is, in little endian:
+ *
+ * | Field         | Type     | Description                                 |
+ * |---------------|----------|---------------------------------------------|
+ * | magic         | uint32   | 0x424C4349 ("ICLB")                         |
+ * | metadata size | uint32   | Size in bytes of the metadata               |
+ * | metadata      | char[]   | Json response without the numeric arrays    |
+ * | block count   | uint32   | Number of blocks following                  |
+ * | blocks        | block[]  | Numeric blocks, see below                   |
+ *
+ * Each block is made of a 12 bytes header followed by its values:
+ *
+ * | Field             | Type   | Description                             |
+ * |-------------------|--------|-----------------------------------------|
+ * | acquisition index | uint16 | Index of the acquisition                |
+ * | roi index         | uint16 | Index of the region of interest         |
+ * | axis              | uint8  | See BinaryBlock::Axis                   |
+ * | element type      | uint8  | See BinaryBlock::ElementType            |
+ * | rows              | uint16 | Number of rows of the values            |
+ * | element count     | uint32 | Number of values                        |
+ */
+class BinaryMessage {
+ public:
+  static constexpr std::uint32_t MAGIC = 0x424C4349;
+
+  /**
+   * @brief Decodes a binary message received from the ICL.
+   *
+   * @param frame The raw websocket frame
+   * @param buffers Pool the buffers of the values are taken from, if any
+   *
+   * @return The decoded message
+   *
+   * @throw std::runtime_error when the frame is not a valid binary message
+   */
+  static BinaryMessage decode(
+      std::span<const std::byte> frame,
+      common::BufferPool<double>* buffers = nullptr) noexcept(false);
+
+  /**
+   * @brief Encodes a binary message. Used by fake ICLs and for testing.
+   *
+   * @param metadata Json part of the message
+   * @param blocks Numeric blocks of the message
+   *
+   * @return The raw binary message
+   */
+  static std::vector<std::byte> encode(const nlohmann::json& metadata,
+                                       const std::vector<BinaryBlock>& blocks);
+
+  /**
+   * @brief Json part of the message, with "id", "command", "results" and
+   * "errors" like a text response.
+   *
+   * @return Metadata of the message
+   */
+  [[nodiscard]] const nlohmann::json& metadata() const;
+
+  /**
+   * @brief Numeric blocks of the message.
+   *
+   * @return Blocks of the message
+   */
+  [[nodiscard]] std::vector<BinaryBlock>& blocks();
+
+ private:
+  nlohmann::json json_metadata;
+  std::vector<BinaryBlock> numeric_blocks;
+};
+} /* namespace horiba::communication */
+#endif /* ifndef BINARY_MESSAGE_H */
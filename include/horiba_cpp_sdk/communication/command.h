@@ -27,9 +27,41 @@ class Command {
    */
   [[nodiscard]] nlohmann::json json() const;
 
+  /**
+   * @brief Writes the JSON representation of the command into a buffer,
+   * replacing its content.
+   *
+   * The JSON is written straight from the parameters, without building the
+   * tree of json(). Once the buffer is large enough, no memory is allocated.
+   *
+   * @param buffer The buffer receiving the JSON text
+   */
+  void serialize(std::string& buffer) const;
+
+  /**
+   * @brief Unique id of the command. The ICL sends it back in the response.
+   *
+   * @return Id of the command
+   */
+  [[nodiscard]] unsigned long long int id() const;
+
+  /**
+   * @brief Name of the ICL command, e.g. "ccd_open".
+   *
+   * @return Name of the command
+   */
+  [[nodiscard]] const std::string& name() const;
+
+  /**
+   * @brief Parameters of the command.
+   *
+   * @return JSON of the parameters, valid as long as the command
+   */
+  [[nodiscard]] const nlohmann::json& json_parameters() const;
+
  private:
   static std::atomic<unsigned long long int> next_id;
-  unsigned long long int id;
+  unsigned long long int command_id;
   std::string command;
   nlohmann::json parameters;
 };
@@ -0,0 +1,170 @@
+#ifndef COMMAND_METRICS_H
+#define COMMAND_METRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace horiba::communication {
+
+/**
+ * @brief Lock-free histogram of unsigned values with power of two buckets.
+ *
+ * Bucket i counts the values in [2^(i-1), 2^i), bucket 0 the value 0. Adding a
+ * value is a few relaxed atomic increments, so histograms can be updated from
+ * any thread on the command path.
+ */
+class Histogram {
+ public:
+  /**
+   * @brief Number of buckets, the last one holds all values from 2^62 on.
+   */
+  static constexpr std::size_t BUCKETS = 64;
+
+  /**
+   * @brief Values of a histogram at one point in time.
+   */
+  struct Snapshot {
+    std::uint64_t count = 0;
+    std::uint64_t sum = 0;
+    std::uint64_t max = 0;
+    std::array<std::uint64_t, BUCKETS> buckets{};
+
+    /**
+     * @brief Exclusive upper bound of the values counted by a bucket.
+     *
+     * @param bucket Index of the bucket
+     *
+     * @return Upper bound, UINT64_MAX for the last bucket
+     */
+    [[nodiscard]] static std::uint64_t upper_bound(std::size_t bucket);
+  };
+
+  /**
+   * @brief Adds a value.
+   *
+   * @param value The value
+   */
+  void add(std::uint64_t value);
+
+  /**
+   * @brief Reads the histogram. Values added concurrently may be partially
+   * seen.
+   *
+   * @return The snapshot
+   */
+  [[nodiscard]] Snapshot snapshot() const;
+
+ private:
+  std::atomic<std::uint64_t> count{0};
+  std::atomic<std::uint64_t> sum{0};
+  std::atomic<std::uint64_t> max{0};
+  std::array<std::atomic<std::uint64_t>, BUCKETS> buckets{};
+};
+
+/**
+ * @brief Timings and sizes of one command sent to the ICL.
+ *
+ * Phases not measured by a communicator are left at zero.
+ */
+struct CommandSample {
+  /**
+   * @brief Time to write the command as JSON text.
+   */
+  std::chrono::nanoseconds serialize_time{0};
+  /**
+   * @brief Time from handing the command to the connection until its response
+   * was received.
+   */
+  std::chrono::nanoseconds round_trip_time{0};
+  /**
+   * @brief Time to parse the response.
+   */
+  std::chrono::nanoseconds parse_time{0};
+  std::size_t bytes_sent = 0;
+  std::size_t bytes_received = 0;
+};
+
+/**
+ * @brief Per-command histograms of the commands sent by a communicator, see
+ * Communicator::set_metrics().
+ *
+ * Durations are recorded in nanoseconds, so that the phases taking less than
+ * a microsecond are not rounded down to zero, and sizes in bytes. The exports
+ * convert them to their own unit.
+ */
+class CommandMetrics {
+ public:
+  /**
+   * @brief Histograms of one command.
+   */
+  struct Snapshot {
+    Histogram::Snapshot serialize_time_ns;
+    Histogram::Snapshot round_trip_time_ns;
+    Histogram::Snapshot parse_time_ns;
+    Histogram::Snapshot bytes_sent;
+    Histogram::Snapshot bytes_received;
+  };
+
+  /**
+   * @brief Records a command.
+   *
+   * Only the first command of a given name recorded on a thread takes a lock,
+   * to find or create its histograms. The thread then keeps them in a cache.
+   *
+   * @param command Name of the command, e.g. "ccd_getAcquisitionData"
+   * @param sample Timings and sizes of the command
+   */
+  void record(const std::string& command, const CommandSample& sample);
+
+  /**
+   * @brief Reads the histograms of all the recorded commands.
+   *
+   * @return Histograms by command name
+   */
+  [[nodiscard]] std::map<std::string, Snapshot> snapshot() const;
+
+  /**
+   * @brief Histograms of all the recorded commands as json, by command name,
+   * with durations in nanoseconds.
+   *
+   * @return The json
+   */
+  [[nodiscard]] nlohmann::json to_json() const;
+
+  /**
+   * @brief Histograms of all the recorded commands in the Prometheus text
+   * exposition format, with durations in seconds.
+   *
+   * @return The text
+   */
+  [[nodiscard]] std::string to_prometheus() const;
+
+ private:
+  struct Histograms {
+    Histogram serialize_time_ns;
+    Histogram round_trip_time_ns;
+    Histogram parse_time_ns;
+    Histogram bytes_sent;
+    Histogram bytes_received;
+  };
+
+  // tells the per-thread caches of histograms apart, never reused
+  const std::uint64_t id = CommandMetrics::next_id();
+  mutable std::shared_mutex commands_mutex;
+  std::unordered_map<std::string, std::unique_ptr<Histograms>> commands;
+
+  static std::uint64_t next_id();
+  Histograms& histograms(const std::string& command);
+};
+} /* namespace horiba::communication */
+
+#endif /* ifndef COMMAND_METRICS_H */
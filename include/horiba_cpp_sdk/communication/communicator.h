@@ -1,16 +1,102 @@
 #ifndef COMMUNICATOR_H
 #define COMMUNICATOR_H
 
+#include <horiba_cpp_sdk/common/buffer_pool.h>
+
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+
 namespace horiba::communication {
 
 class Command;
+class CommandMetrics;
 class Response;
 
+/**
+ * @brief Error of a request whose response did not arrive before its deadline.
+ */
+class RequestTimeoutError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief Error of a request cancelled before its response arrived.
+ */
+class RequestCancelledError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief Error of a request lost with the connection to the ICL. The request
+ * may succeed when sent again once the connection is back, see
+ * ReconnectingCommunicator.
+ */
+class RetryableRequestError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief Deadline and cancellation of a request.
+ *
+ * A request failing on either is completed with a RequestTimeoutError or a
+ * RequestCancelledError, a response arriving afterwards is dropped.
+ */
+struct RequestOptions {
+  /**
+   * @brief Time by which the response must have arrived, none to wait for as
+   * long as it takes.
+   */
+  std::optional<std::chrono::steady_clock::time_point> deadline;
+  /**
+   * @brief Cancels the request once a stop is requested on its source.
+   */
+  std::stop_token stop_token;
+
+  /**
+   * @brief Options of a request whose response must arrive within a timeout.
+   *
+   * @param timeout Time from now by which the response must have arrived
+   * @param stop_token Token to cancel the request, if any
+   *
+   * @return The options
+   */
+  static RequestOptions within(std::chrono::steady_clock::duration timeout,
+                               std::stop_token stop_token = {});
+
+  /**
+   * @brief Checks whether the request was cancelled or its deadline passed.
+   *
+   * @param command_name Name of the command, for the error message
+   *
+   * @return The error the request fails with, null if it can still complete
+   */
+  [[nodiscard]] std::exception_ptr failure(
+      const std::string& command_name) const;
+};
+
 /**
  * @brief Interface representing a communication channel with the ICL.
  */
 class Communicator {
  public:
+  /**
+   * @brief Completion handler of an asynchronous request.
+   *
+   * The exception pointer is null on success. On failure it holds the error
+   * and the response is empty.
+   */
+  using ResponseHandler = std::function<void(std::exception_ptr, Response)>;
+
   virtual ~Communicator() = default;
 
   /**
@@ -18,6 +104,22 @@ class Communicator {
    */
   virtual void open() = 0;
 
+  /**
+   * @brief Opens the communication channel with the ICL, giving up on the
+   * deadline.
+   *
+   * The default implementation cannot interrupt open(), it only fails if the
+   * deadline passed before opening. Communicators able to wait on a timer
+   * override it, so that opening a channel to an ICL that does not answer
+   * fails on time.
+   *
+   * @param deadline Time by which the channel must be open
+   *
+   * @throw std::runtime_error if the channel could not be opened by the
+   * deadline
+   */
+  virtual void open_until(std::chrono::steady_clock::time_point deadline);
+
   /**
    * @brief Closes the communication channel with the ICL
    */
@@ -38,6 +140,111 @@ class Communicator {
    * @return The response from the ICL
    */
   virtual Response request_with_response(const Command& command) = 0;
+
+  /**
+   * @brief Sends a command to the ICL and returns the response, giving up on
+   * the deadline or the cancellation of the options.
+   *
+   * @param command The command for the ICL
+   * @param options Deadline and cancellation of the request
+   *
+   * @return The response from the ICL
+   *
+   * @throw RequestTimeoutError if the deadline passed before the response
+   * arrived
+   * @throw RequestCancelledError if the request got cancelled before the
+   * response arrived
+   */
+  Response request_with_response(const Command& command,
+                                 const RequestOptions& options);
+
+  /**
+   * @brief Sends a command to the ICL without waiting for the response.
+   *
+   * The handler is called once the response carrying the id of the command has
+   * been received. The default implementation is blocking and calls the
+   * handler before returning; communicators able to keep several commands in
+   * flight override it.
+   *
+   * @param command The command for the ICL
+   * @param handler Called with the response, or with the error
+   */
+  virtual void async_request(const Command& command, ResponseHandler handler);
+
+  /**
+   * @brief Sends a command to the ICL without waiting for the response, giving
+   * up on the deadline or the cancellation of the options.
+   *
+   * The default implementation cannot interrupt a request. It fails requests
+   * cancelled or past their deadline before they are sent, and the ones whose
+   * response arrives after the deadline or the cancellation. Communicators
+   * able to wait on a timer override it, so that a request to an ICL that
+   * does not answer fails on time.
+   *
+   * @param command The command for the ICL
+   * @param options Deadline and cancellation of the request
+   * @param handler Called with the response, or with the error, a
+   * RequestTimeoutError or RequestCancelledError when giving up
+   */
+  virtual void async_request(const Command& command,
+                             const RequestOptions& options,
+                             ResponseHandler handler);
+
+  /**
+   * @brief Sends a command to the ICL and returns a future of the response.
+   *
+   * Several commands can be sent back to back before waiting on any of the
+   * futures, see async_request().
+   *
+   * @param command The command for the ICL
+   *
+   * @return Future of the response from the ICL
+   */
+  std::future<Response> request_with_response_async(const Command& command);
+
+  /**
+   * @brief Sends a command to the ICL and returns a future of the response,
+   * giving up on the deadline or the cancellation of the options, see
+   * async_request(const Command&, const RequestOptions&, ResponseHandler).
+   *
+   * @param command The command for the ICL
+   * @param options Deadline and cancellation of the request
+   *
+   * @return Future of the response from the ICL
+   */
+  std::future<Response> request_with_response_async(
+      const Command& command, const RequestOptions& options);
+
+  /**
+   * @brief Records the timings and sizes of the commands sent from now on.
+   *
+   * Must be called before commands are sent, it is not synchronized with
+   * requests in flight. The default async_request() only measures the round
+   * trip, communicators that serialize and parse commands themselves also
+   * measure those phases.
+   *
+   * @param metrics Where to record the commands, null to stop recording
+   */
+  void set_metrics(std::shared_ptr<CommandMetrics> metrics);
+
+  /**
+   * @brief Metrics the commands are recorded in, see set_metrics().
+   *
+   * @return The metrics, null if the commands are not recorded
+   */
+  [[nodiscard]] const std::shared_ptr<CommandMetrics>& metrics() const;
+
+  /**
+   * @brief Pool the numeric data of the responses is written into, see
+   * Response::take_binary_blocks(). Buffers of numeric data no longer needed
+   * can be handed back to it, so that the next responses reuse them.
+   *
+   * @return The pool, null if the communicator does not reuse buffers
+   */
+  virtual std::shared_ptr<common::BufferPool<double>> buffer_pool();
+
+ private:
+  std::shared_ptr<CommandMetrics> command_metrics;
 };
 
 }  // namespace horiba::communication
@@ -0,0 +1,118 @@
+#ifndef RECONNECTING_COMMUNICATOR_H
+#define RECONNECTING_COMMUNICATOR_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+
+#include "horiba_cpp_sdk/communication/command.h"
+#include "horiba_cpp_sdk/communication/communicator.h"
+
+namespace horiba::communication {
+
+class Response;
+
+/**
+ * @brief How ReconnectingCommunicator reconnects to the ICL.
+ */
+struct ReconnectPolicy {
+  /**
+   * @brief Delay before the second attempt to reconnect, doubling after each
+   * failed attempt.
+   */
+  std::chrono::milliseconds initial_delay{10};
+  /**
+   * @brief Upper bound of the delay between two attempts.
+   */
+  std::chrono::milliseconds max_delay{1000};
+  /**
+   * @brief Time after which reconnecting is given up.
+   */
+  std::chrono::milliseconds timeout{std::chrono::minutes(1)};
+};
+
+/**
+ * @brief Communicator that reconnects another communicator when its connection
+ * to the ICL got lost, e.g. because the ICL restarted, and restores the state
+ * of the session.
+ *
+ * The session state is made of the commands last applied with success: the
+ * binary mode, the discoveries, the opening of the devices and the acquisition
+ * settings of the CCDs. A setting is kept per device, and per region of
+ * interest for "ccd_setRoi". Closing a device forgets its state. Moves of the
+ * monochromators are not part of it, the hardware keeps its position.
+ *
+ * The connection is restored on a thread of the communicator, started by the
+ * first request sent after it got lost. Requests sent meanwhile are queued
+ * without blocking the caller, and fail on their own deadline or cancellation
+ * if the connection is not restored before. After connecting, the session
+ * commands are sent again in the order they were first applied, then the
+ * queued requests. Requests in flight when the connection got lost fail with
+ * a RetryableRequestError.
+ *
+ * The communicator stays open from open() to close(), even while the
+ * connection is lost, so that devices keep sending their requests.
+ */
+class ReconnectingCommunicator : public Communicator {
+ public:
+  /**
+   * @brief Reconnects a communicator whenever its connection got lost.
+   *
+   * @param communicator The communicator sending the commands, which must be
+   * able to open again after losing its connection
+   * @param policy Delays and timeout of the reconnection
+   */
+  explicit ReconnectingCommunicator(std::shared_ptr<Communicator> communicator,
+                                    ReconnectPolicy policy = {});
+  ~ReconnectingCommunicator() override;
+
+  ReconnectingCommunicator(const ReconnectingCommunicator&) = delete;
+  ReconnectingCommunicator& operator=(const ReconnectingCommunicator&) = delete;
+  ReconnectingCommunicator(ReconnectingCommunicator&&) = delete;
+  ReconnectingCommunicator& operator=(ReconnectingCommunicator&&) = delete;
+
+  void open() override;
+  void open_until(std::chrono::steady_clock::time_point deadline) override;
+  void close() override;
+  bool is_open() override;
+
+  /**
+   * @brief Sends a command, waiting for the connection to be restored if it
+   * got lost.
+   *
+   * @param command The command for the ICL
+   *
+   * @return The response
+   *
+   * @throw RetryableRequestError if the connection got lost before the
+   * response arrived
+   * @throw std::runtime_error if the communicator is closed or reconnecting
+   * timed out
+   */
+  Response request_with_response(const Command& command) override;
+  using Communicator::request_with_response;
+  void async_request(const Command& command, ResponseHandler handler) override;
+  void async_request(const Command& command, const RequestOptions& options,
+                     ResponseHandler handler) override;
+  std::shared_ptr<common::BufferPool<double>> buffer_pool() override;
+
+  /**
+   * @brief Number of times the connection got restored since the
+   * communicator got created.
+   *
+   * @return Number of reconnections
+   */
+  [[nodiscard]] std::uint64_t reconnections() const;
+
+ private:
+  struct State;
+
+  // shared with the handlers of the requests in flight and the reconnect
+  // thread, which may complete after the communicator is destroyed
+  std::shared_ptr<State> state;
+  std::thread reconnect_thread;
+};
+} /* namespace horiba::communication */
+
+#endif /* ifndef RECONNECTING_COMMUNICATOR_H */
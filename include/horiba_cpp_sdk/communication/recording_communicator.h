@@ -0,0 +1,128 @@
+#ifndef RECORDING_COMMUNICATOR_H
+#define RECORDING_COMMUNICATOR_H
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+#include "horiba_cpp_sdk/communication/binary_message.h"
+#include "horiba_cpp_sdk/communication/communicator.h"
+
+namespace horiba::communication {
+
+class Command;
+class Response;
+
+/**
+ * @brief One command sent to the ICL and its response, as recorded by
+ * RecordingCommunicator.
+ */
+struct RecordedExchange {
+  /**
+   * @brief Time the command was sent, since the start of the first session of
+   * the recording.
+   */
+  std::chrono::microseconds sent_at{0};
+  /**
+   * @brief Index of the session the command was recorded in, in the order the
+   * sessions were appended.
+   */
+  std::size_t session = 0;
+  /**
+   * @brief Time from sending the command until its response was received.
+   */
+  std::chrono::microseconds round_trip_time{0};
+  std::string command;
+  nlohmann::json parameters;
+  nlohmann::json results;
+  std::vector<std::string> errors;
+  std::vector<BinaryBlock> binary_blocks;
+  /**
+   * @brief Message of the exception thrown instead of a response, empty if a
+   * response was received.
+   */
+  std::string failure;
+};
+
+/**
+ * @brief Communicator that records every command sent through another
+ * communicator, with its response and timing, see ReplayCommunicator.
+ *
+ * The recording is an append-only file of records, each made of its size as a
+ * little endian uint32 followed by the record in CBOR. A record is written and
+ * flushed as soon as its response is received, so a recording stays readable
+ * when the application crashes. Several sessions can be appended to the same
+ * file, each starting with a header holding its start time.
+ *
+ * Responses of async_request() are recorded on the thread calling the handler,
+ * e.g. the I/O thread of a WebSocketCommunicator. The deadline and the
+ * cancellation of a request are handed to the recorded communicator, a request
+ * given up on is recorded with its failure.
+ */
+class RecordingCommunicator : public Communicator {
+ public:
+  /**
+   * @brief Records the commands sent through a communicator.
+   *
+   * @param communicator The communicator sending the commands
+   * @param recording_file File the commands are appended to
+   *
+   * @throw std::runtime_error if the file cannot be opened
+   */
+  RecordingCommunicator(
+      std::shared_ptr<Communicator> communicator,
+      const std::filesystem::path& recording_file) noexcept(false);
+
+  void open() override;
+  void open_until(std::chrono::steady_clock::time_point deadline) override;
+  void close() override;
+  bool is_open() override;
+  Response request_with_response(const Command& command) override;
+  using Communicator::request_with_response;
+  void async_request(const Command& command, ResponseHandler handler) override;
+  void async_request(const Command& command, const RequestOptions& options,
+                     ResponseHandler handler) override;
+  std::shared_ptr<common::BufferPool<double>> buffer_pool() override;
+
+  /**
+   * @brief Reads all the commands of a recording, in the order their
+   * responses were received.
+   *
+   * The sessions are read in the order they were appended. The send times of
+   * a session are shifted by its start time, so that they all count from the
+   * start of the first session.
+   *
+   * A record cut short at the end of the file, e.g. by a crash while it was
+   * written, is ignored.
+   *
+   * @param recording_file The recording
+   *
+   * @return The recorded commands
+   *
+   * @throw std::runtime_error if the file cannot be read or is not a
+   * recording
+   */
+  static std::vector<RecordedExchange> read_recording(
+      const std::filesystem::path& recording_file) noexcept(false);
+
+ private:
+  std::shared_ptr<Communicator> communicator;
+  std::chrono::steady_clock::time_point recording_start;
+  std::mutex recording_mutex;
+  std::ofstream recording;
+
+  void record(const Command& command,
+              std::chrono::steady_clock::time_point sent_at,
+              const std::exception_ptr& error, const Response& response);
+  void write_record(const nlohmann::json& record);
+};
+} /* namespace horiba::communication */
+
+#endif /* ifndef RECORDING_COMMUNICATOR_H */
@@ -0,0 +1,117 @@
+#ifndef REPLAY_COMMUNICATOR_H
+#define REPLAY_COMMUNICATOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "horiba_cpp_sdk/communication/communicator.h"
+#include "horiba_cpp_sdk/communication/recording_communicator.h"
+#include "horiba_cpp_sdk/communication/response.h"
+
+namespace horiba::communication {
+
+/**
+ * @brief Communicator answering commands with the responses of a recording
+ * made by a RecordingCommunicator, without ICL nor hardware.
+ *
+ * A command is answered with the next recorded response of a command with the
+ * same name and parameters, or else with the same name only. Responses are
+ * delayed by their recorded round trip time multiplied by a time scale, a
+ * time scale of 0 answers immediately to measure the overhead of the SDK
+ * alone.
+ */
+class ReplayCommunicator : public Communicator {
+ public:
+  /**
+   * @brief Replays a recording.
+   *
+   * @param recording_file The recording
+   * @param time_scale Factor applied to the recorded round trip times
+   *
+   * @throw std::runtime_error if the recording cannot be read
+   */
+  explicit ReplayCommunicator(const std::filesystem::path& recording_file,
+                              double time_scale = 1.0) noexcept(false);
+
+  /**
+   * @brief Replays recorded commands.
+   *
+   * @param exchanges The recorded commands
+   * @param time_scale Factor applied to the recorded round trip times
+   */
+  explicit ReplayCommunicator(std::vector<RecordedExchange> exchanges,
+                              double time_scale = 1.0);
+
+  ~ReplayCommunicator() override;
+
+  ReplayCommunicator(const ReplayCommunicator&) = delete;
+  ReplayCommunicator& operator=(const ReplayCommunicator&) = delete;
+  ReplayCommunicator(ReplayCommunicator&&) = delete;
+  ReplayCommunicator& operator=(ReplayCommunicator&&) = delete;
+
+  void open() override;
+  void close() override;
+  bool is_open() override;
+
+  /**
+   * @brief Answers a command with its recorded response.
+   *
+   * @param command Command to answer
+   *
+   * @return Response The recorded response, with the id of the command
+   *
+   * @throw std::runtime_error if the communicator is closed, if the command is
+   * not in the recording or if it failed when it was recorded
+   */
+  Response request_with_response(const Command& command) override;
+  using Communicator::request_with_response;
+  void async_request(const Command& command, ResponseHandler handler) override;
+  using Communicator::async_request;
+
+  /**
+   * @brief Number of recorded responses not replayed yet.
+   */
+  [[nodiscard]] std::size_t remaining_exchanges() const;
+
+ private:
+  struct Delivery {
+    std::chrono::steady_clock::time_point due;
+    std::uint64_t sequence;
+    ResponseHandler handler;
+    std::exception_ptr error;
+    Response response;
+  };
+
+  double time_scale;
+  std::atomic<bool> opened{false};
+
+  mutable std::mutex exchanges_mutex;
+  // recorded responses by command name, in recording order
+  std::unordered_map<std::string, std::deque<RecordedExchange>> exchanges;
+  std::size_t remaining = 0;
+
+  std::mutex deliveries_mutex;
+  std::condition_variable_any deliveries_changed;
+  std::vector<Delivery> deliveries;
+  std::uint64_t next_sequence = 0;
+  std::jthread delivery_thread;
+
+  RecordedExchange take_exchange(const Command& command);
+  [[nodiscard]] std::chrono::steady_clock::duration scaled(
+      std::chrono::microseconds round_trip_time) const;
+  void deliver(const std::stop_token& stop_token);
+};
+} /* namespace horiba::communication */
+
+#endif /* ifndef REPLAY_COMMUNICATOR_H */
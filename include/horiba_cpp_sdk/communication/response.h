@@ -1,6 +1,8 @@
 #ifndef RESPONSE_H
 #define RESPONSE_H
 
+#include <horiba_cpp_sdk/communication/binary_message.h>
+
 #include <any>
 #include <nlohmann/json.hpp>
 #include <string>
@@ -19,29 +21,66 @@ class Response {
    * @param command The sent command
    * @param results The results, if any, of the command
    * @param errors The errors, if any, of the command
+   * @param binary_blocks The numeric blocks, if the response was received as a
+   * binary message
    */
   Response(unsigned long long int id, std::string command,
-           nlohmann::json::object_t results, std::vector<std::string> errors);
+           nlohmann::json::object_t results, std::vector<std::string> errors,
+           std::vector<BinaryBlock> binary_blocks = {});
 
   /**
    * @brief JSON representation of the "results" field of the response.
    *
-   * @return JSON of response["results"]
+   * @return JSON of response["results"], valid as long as the response
    */
-  [[nodiscard]] nlohmann::json json_results() const;
+  [[nodiscard]] const nlohmann::json& json_results() const;
 
   /**
    * @brief Errors, if any, from the ICL.
    *
-   * @return Errors happened during the call to the ICL
+   * @return Errors happened during the call to the ICL, valid as long as the
+   * response
+   */
+  [[nodiscard]] const std::vector<std::string>& errors() const;
+
+  /**
+   * @brief Id of the command this response belongs to.
+   *
+   * @return Id of the sent command
+   */
+  [[nodiscard]] unsigned long long int id() const;
+
+  /**
+   * @brief Name of the command this response belongs to.
+   *
+   * @return Name of the sent command
+   */
+  [[nodiscard]] const std::string& command_name() const;
+
+  /**
+   * @brief Numeric blocks of the response. Filled if the ICL answered with a
+   * binary message, see ICLDeviceManager enable_binary_messages, or if the
+   * parser of the text response moved the numeric data into blocks, see
+   * NumericDataResponseParser.
+   *
+   * @return The numeric blocks of the response
+   */
+  [[nodiscard]] const std::vector<BinaryBlock>& binary_blocks() const;
+
+  /**
+   * @brief Moves the numeric blocks out of the response, to keep their values
+   * without copying them.
+   *
+   * @return The numeric blocks of the response, empty afterwards
    */
-  [[nodiscard]] std::vector<std::string> errors() const;
+  [[nodiscard]] std::vector<BinaryBlock> take_binary_blocks();
 
  private:
-  unsigned long long int id;
+  unsigned long long int command_id;
   std::string command;
-  nlohmann::json::object_t results;
+  nlohmann::json results;
   std::vector<std::string> icl_errors;
+  std::vector<BinaryBlock> numeric_blocks;
 };
 } /* namespace horiba::communication */
 #endif /* ifndef RESPONSE_H */
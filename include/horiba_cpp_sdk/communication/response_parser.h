@@ -0,0 +1,89 @@
+#ifndef RESPONSE_PARSER_H
+#define RESPONSE_PARSER_H
+
+#include <horiba_cpp_sdk/common/buffer_pool.h>
+#include <horiba_cpp_sdk/communication/binary_message.h>
+
+#include <cstddef>
+#include <nlohmann/json.hpp>
+#include <string_view>
+#include <vector>
+
+namespace horiba::communication {
+
+/**
+ * @brief Parses the text responses of the ICL, see
+ * WebSocketCommunicator::set_response_parser().
+ */
+class ResponseParser {
+ public:
+  virtual ~ResponseParser() = default;
+
+  /**
+   * @brief Parses a text response.
+   *
+   * @param raw_response The response as received from the ICL
+   * @param binary_blocks Numeric data the parser took out of the json, the
+   * same way the ICL sends them in a binary message
+   * @param buffers Pool the buffers of the numeric data are taken from, if any
+   *
+   * @return nlohmann::json The response, without the numeric data moved to
+   * the binary blocks
+   *
+   * @throw nlohmann::json::exception if the response is not valid json
+   */
+  virtual nlohmann::json parse(
+      std::string_view raw_response, std::vector<BinaryBlock>& binary_blocks,
+      common::BufferPool<double>* buffers = nullptr) noexcept(false) = 0;
+};
+
+/**
+ * @brief Parses responses into a nlohmann::json document, numeric data
+ * included.
+ */
+class DomResponseParser final : public ResponseParser {
+ public:
+  nlohmann::json parse(std::string_view raw_response,
+                       std::vector<BinaryBlock>& binary_blocks,
+                       common::BufferPool<double>* buffers =
+                           nullptr) noexcept(false) override;
+};
+
+/**
+ * @brief Parses large responses in a single pass, writing the "xData",
+ * "yData" and "xyData" arrays of acquisitions straight into binary blocks
+ * instead of json nodes. Only the small metadata of the acquisitions is built
+ * as a json document.
+ *
+ * The y values are written into buffers taken from the pool given to parse(),
+ * reserved for BufferPool::buffer_size() values, so that frames of a known size
+ * do not grow their buffers while being parsed.
+ *
+ * Responses smaller than a threshold, e.g. the replies to control commands,
+ * are parsed with a DomResponseParser. So are responses whose numeric data
+ * does not have the layout of an acquisition.
+ */
+class NumericDataResponseParser final : public ResponseParser {
+ public:
+  static constexpr std::size_t DEFAULT_MIN_RESPONSE_SIZE = 16 * 1024;
+
+  /**
+   * @brief Creates the parser.
+   *
+   * @param min_response_size Size in bytes from which a response is parsed
+   * into binary blocks
+   */
+  explicit NumericDataResponseParser(
+      std::size_t min_response_size = DEFAULT_MIN_RESPONSE_SIZE);
+
+  nlohmann::json parse(std::string_view raw_response,
+                       std::vector<BinaryBlock>& binary_blocks,
+                       common::BufferPool<double>* buffers =
+                           nullptr) noexcept(false) override;
+
+ private:
+  std::size_t min_response_size;
+  DomResponseParser dom_parser;
+};
+} /* namespace horiba::communication */
+#endif /* ifndef RESPONSE_PARSER_H */
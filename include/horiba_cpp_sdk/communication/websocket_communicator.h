@@ -1,13 +1,35 @@
 #ifndef WEBSOCKET_COMMUNICATOR_H
 #define WEBSOCKET_COMMUNICATOR_H
 
+#include <atomic>
 #include <boost/asio/connect.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
 #include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
 #include <boost/beast/core.hpp>
 #include <boost/beast/websocket.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
+#include "horiba_cpp_sdk/communication/binary_message.h"
 #include "horiba_cpp_sdk/communication/communicator.h"
+#include "horiba_cpp_sdk/communication/response_parser.h"
 
 namespace horiba::communication {
 
@@ -16,6 +38,39 @@ class Response;
 
 /**
  * @brief Represents a communication channel with the ICL using a websocket.
+ *
+ * Once opened, all reads and writes happen on internal I/O threads. Commands
+ * are written back to back and responses are matched to their command by id,
+ * so several commands can be in flight on the same websocket. Handlers given to
+ * async_request() are called on an I/O thread and must not block on another
+ * request of this communicator.
+ *
+ * The communicator can be shared by devices driven from different threads:
+ * any thread can send requests, and open() and close() are serialized.
+ * Commands are written in the order they are sent. With more than one I/O
+ * thread, the handlers of each device, e.g. "ccd" 0 or "mono" 1, run on a
+ * strand of the device, one at a time and in the order their responses
+ * arrived, while the handlers of other devices run in parallel.
+ *
+ * Binary messages, sent by the ICL when binary mode is enabled, are decoded
+ * straight into the numeric blocks of the response, see BinaryMessage. Text
+ * responses are parsed by a NumericDataResponseParser by default, so the
+ * numeric data of large acquisitions also ends up in the numeric blocks.
+ *
+ * The read buffer and the buffers of written commands are kept for the whole
+ * connection and reused, and responses are parsed straight from the read
+ * buffer, so that a request does not allocate intermediate copies of its
+ * command and response.
+ *
+ * The numeric data of responses is written into buffers of buffer_pool(), so
+ * that handing the buffers of consumed data back to the pool saves allocating
+ * new ones for the next responses.
+ *
+ * When metrics are set, see Communicator::set_metrics(), the serialization,
+ * the round trip and the parsing of each command are measured.
+ *
+ * Deadlines of requests are waited on with timers of the I/O thread, so a
+ * request to an ICL that does not answer fails on time, see RequestOptions.
  */
 class WebSocketCommunicator : public Communicator {
  public:
@@ -25,18 +80,39 @@ class WebSocketCommunicator : public Communicator {
    *
    * @param host The host to connect to
    * @param port The port to connect to
+   * @param io_threads Number of threads reading, writing and calling the
+   * handlers of the requests
    */
-  WebSocketCommunicator(std::string host, std::string port);
+  WebSocketCommunicator(std::string host, std::string port,
+                        std::size_t io_threads = 1);
 
-  ~WebSocketCommunicator() override = default;
+  ~WebSocketCommunicator() override;
+
+  WebSocketCommunicator(const WebSocketCommunicator&) = delete;
+  WebSocketCommunicator& operator=(const WebSocketCommunicator&) = delete;
+  WebSocketCommunicator(WebSocketCommunicator&&) = delete;
+  WebSocketCommunicator& operator=(WebSocketCommunicator&&) = delete;
 
   /**
    * @brief Opens the communication channel with the ICL
    */
   void open() override;
 
+  /**
+   * @brief Opens the communication channel with the ICL, giving up on the
+   * deadline. The resolution, the connection and the websocket handshake all
+   * have to be done by then.
+   *
+   * @param deadline Time by which the channel must be open
+   *
+   * @throw std::runtime_error if the channel was not open by the deadline
+   */
+  void open_until(std::chrono::steady_clock::time_point deadline) override;
+
   /**
    * @brief Closes the communication channel with the ICL
+   *
+   * Requests still waiting for a response are failed.
    */
   void close() override;
   /**
@@ -54,13 +130,132 @@ class WebSocketCommunicator : public Communicator {
    * @return The response from the ICL
    */
   Response request_with_response(const Command& command) override;
+  using Communicator::request_with_response;
+
+  /**
+   * @brief Sends a command to the ICL without waiting for the response.
+   *
+   * @param command The command for the ICL
+   * @param handler Called on an I/O thread with the response, or with the
+   * error if the websocket failed or got closed before the response arrived
+   */
+  void async_request(const Command& command, ResponseHandler handler) override;
+
+  /**
+   * @brief Sends a command to the ICL without waiting for the response,
+   * giving up on the deadline or the cancellation of the options.
+   *
+   * @param command The command for the ICL
+   * @param options Deadline and cancellation of the request
+   * @param handler Called on an I/O thread with the response, or with the
+   * error if the websocket failed, got closed, the deadline passed or the
+   * request got cancelled before the response arrived. Called on the calling
+   * thread if the request is cancelled or past its deadline before being sent.
+   */
+  void async_request(const Command& command, const RequestOptions& options,
+                     ResponseHandler handler) override;
+
+  /**
+   * @brief Sets the parser of the text responses. Must be called while the
+   * communication channel is closed.
+   *
+   * @param parser The parser of the text responses
+   *
+   * @throw std::runtime_error if the communication channel is open
+   */
+  void set_response_parser(std::shared_ptr<ResponseParser> parser);
+
+  /**
+   * @brief Pool the numeric data of text and binary responses is written into.
+   *
+   * @return The pool
+   */
+  std::shared_ptr<common::BufferPool<double>> buffer_pool() override;
 
  private:
+  using Strand = boost::asio::strand<boost::asio::io_context::executor_type>;
+
   std::string host;
   std::string port;
+  std::size_t io_thread_count;
   boost::asio::io_context context;
+  // the websocket, the read buffer, the write queue and the deadline timers
+  // are only accessed from this strand
+  Strand io_strand{boost::asio::make_strand(context)};
   boost::beast::websocket::stream<boost::asio::ip::tcp::socket> websocket{
-      context};
+      io_strand};
+  std::optional<
+      boost::asio::executor_work_guard<boost::asio::io_context::executor_type>>
+      work_guard;
+  std::vector<std::thread> io_threads;
+  // serializes open() and close()
+  std::mutex lifecycle_mutex;
+  std::atomic<bool> opened{false};
+  // counts the connections, so that writes posted while closing are not sent
+  // on the next connection
+  std::atomic<std::uint64_t> connection_count{0};
+  std::shared_ptr<ResponseParser> response_parser =
+      std::make_shared<NumericDataResponseParser>();
+  std::shared_ptr<common::BufferPool<double>> value_buffers =
+      std::make_shared<common::BufferPool<double>>();
+
+  boost::beast::flat_buffer read_buffer;
+  std::deque<std::string> write_queue;
+
+  // buffers of written commands, handed back once written
+  std::mutex spare_write_buffers_mutex;
+  std::vector<std::string> spare_write_buffers;
+
+  /**
+   * @brief Request waiting for its response.
+   */
+  struct PendingRequest {
+    ResponseHandler handler;
+    std::chrono::steady_clock::time_point sent_at;
+    std::chrono::nanoseconds serialize_time{0};
+    std::size_t bytes_sent = 0;
+    // strand the handler is called on, only used with several I/O threads
+    std::optional<Strand> device_strand;
+    // only set for requests with a deadline or a cancellation
+    std::unique_ptr<boost::asio::steady_timer> deadline_timer;
+    std::unique_ptr<std::stop_callback<std::function<void()>>> cancellation;
+  };
+
+  /**
+   * @brief Measures of a received response.
+   */
+  struct ReceivedFrame {
+    std::chrono::steady_clock::time_point received_at;
+    std::chrono::nanoseconds parse_time{0};
+    std::size_t bytes = 0;
+  };
+
+  std::mutex pending_requests_mutex;
+  std::unordered_map<unsigned long long int, PendingRequest> pending_requests;
+
+  std::mutex device_strands_mutex;
+  std::unordered_map<std::string, Strand> device_strands;
+
+  void join_io_threads();
+  Strand device_strand(const Command& command);
+  void finish_request(PendingRequest& request, std::exception_ptr error,
+                      Response response);
+  void do_read();
+  void on_read(boost::beast::error_code error);
+  void do_write();
+  void on_write(boost::beast::error_code error);
+  void dispatch_response(std::string_view raw_response);
+  void dispatch_binary_response();
+  void complete_request(nlohmann::json& json_response,
+                        std::vector<BinaryBlock> binary_blocks,
+                        const ReceivedFrame& frame);
+  void start_deadline_timer(unsigned long long int id,
+                            std::chrono::steady_clock::time_point deadline,
+                            const std::string& command_name);
+  void fail_request(unsigned long long int id, const std::exception_ptr& error);
+  std::string take_write_buffer();
+  void give_back_write_buffer(std::string buffer);
+  void fail_pending_requests(const std::string& reason);
 };
 } /* namespace horiba::communication */
 
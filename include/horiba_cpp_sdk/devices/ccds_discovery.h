@@ -39,9 +39,18 @@ class ChargeCoupledDevicesDiscovery : public DeviceDiscovery {
   std::vector<std::shared_ptr<single_devices::ChargeCoupledDevice>>
   charge_coupled_devices() const;
 
+  /**
+   * @brief The "devices" listed by the ICL after calling the execute()
+   * function
+   *
+   * @return Json array of the detected CCDs
+   */
+  [[nodiscard]] const nlohmann::json& raw_devices() const;
+
  private:
   std::shared_ptr<horiba::communication::Communicator> communicator;
   std::vector<std::shared_ptr<single_devices::ChargeCoupledDevice>> ccds;
+  nlohmann::json listed_ccds = nlohmann::json::array();
 
   std::vector<std::shared_ptr<single_devices::ChargeCoupledDevice>> parse_ccds(
       nlohmann::json raw_ccds);
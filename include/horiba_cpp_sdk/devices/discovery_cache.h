@@ -0,0 +1,86 @@
+#ifndef DISCOVERY_CACHE_H
+#define DISCOVERY_CACHE_H
+
+#include <filesystem>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace horiba::devices {
+
+/**
+ * @brief File holding the devices found by the last discovery, so that they can
+ * be built at startup without waiting for the ICL to discover them again.
+ *
+ * An entry is only meant to be reused with the ICL version it was discovered
+ * with. Whether the hardware changed is decided by comparing the serial numbers
+ * of the devices, see Entry::same_devices().
+ */
+class DiscoveryCache {
+ public:
+  /**
+   * @brief Devices found by a discovery.
+   */
+  struct Entry {
+    /**
+     * @brief "nodeVersion" of "icl_info"
+     */
+    std::string icl_version;
+    /**
+     * @brief "devices" of "ccd_list"
+     */
+    nlohmann::json ccds = nlohmann::json::array();
+    /**
+     * @brief "devices" of "mono_list"
+     */
+    nlohmann::json monos = nlohmann::json::array();
+
+    /**
+     * @brief Checks if both entries have the same ICL version and the same
+     * device serial numbers, in the same order.
+     *
+     * @param other The entry to compare to
+     *
+     * @return True if the devices are the same
+     */
+    [[nodiscard]] bool same_devices(const Entry& other) const;
+  };
+
+  /**
+   * @brief Creates a cache stored in the given file. The file is only accessed
+   * by load() and store().
+   *
+   * @param path The file of the cache
+   */
+  explicit DiscoveryCache(std::filesystem::path path);
+
+  /**
+   * @brief Reads the entry of the cache.
+   *
+   * @return The entry, or nothing if the file does not exist or is not a valid
+   * entry
+   */
+  [[nodiscard]] std::optional<Entry> load() const;
+
+  /**
+   * @brief Replaces the entry of the cache. Failures are logged and otherwise
+   * ignored, the cache being an optimization only.
+   *
+   * @param entry The entry to store
+   */
+  void store(const Entry& entry) const;
+
+  /**
+   * @brief The file of the cache.
+   *
+   * @return Path of the file
+   */
+  [[nodiscard]] const std::filesystem::path& path() const;
+
+ private:
+  std::filesystem::path cache_path;
+};
+} /* namespace horiba::devices */
+
+#endif /* ifndef DISCOVERY_CACHE_H */
@@ -2,9 +2,18 @@
 #define ICL_DEVICE_MANAGER_H
 
 #include <horiba_cpp_sdk/communication/communicator.h>
+#include <horiba_cpp_sdk/communication/reconnecting_communicator.h>
 #include <horiba_cpp_sdk/devices/device_manager.h>
+#include <horiba_cpp_sdk/devices/discovery_cache.h>
 #include <horiba_cpp_sdk/os/process.h>
 
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
 #include <string>
 
 namespace horiba::communication {
@@ -13,6 +22,15 @@ class Communicator;
 
 namespace horiba::devices {
 
+/**
+ * @brief Error of a background discovery that found other devices than the
+ * cached ones, see ICLDeviceManager::wait_for_discovery().
+ */
+class OutdatedDiscoveryCacheError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
 /**
  * @brief Device Manager using the ICL to communicate with connected Horiba
  * devices
@@ -29,16 +47,32 @@ class ICLDeviceManager final : public DeviceManager {
    * @param manage_icl_lifetime Whether to start and stop the icl.exe
    * @param enable_binary_messages Whether to enable or not binary messages
    * comming from the ICL
+   * @param open_devices_on_start Whether to open all discovered devices when
+   * starting, see open_all_devices()
    */
   explicit ICLDeviceManager(std::shared_ptr<horiba::os::Process> icl_process,
                             std::string websocket_ip = "127.0.0.1",
                             std::string websocket_port = "25010",
                             bool manage_icl_lifetime = true,
-                            bool enable_binary_messages = false);
+                            bool enable_binary_messages = false,
+                            bool open_devices_on_start = false);
 
   /**
    * @brief Starts the ICL device manager. Also starts the icl.exe if managing
    * its lifecycle.
+   *
+   * The ICL may still be booting, connecting to it is retried every few
+   * milliseconds at first, then less and less often, until it accepts the
+   * connection or the start timeout is reached, see set_start_timeout() and
+   * icl_ready_time().
+   *
+   * When a discovery cache is used and holds devices discovered with the same
+   * ICL version, the devices are built from the cache and the discovery runs in
+   * the background, see wait_for_discovery(). The devices are then only opened
+   * once the discovery confirmed or replaced them.
+   *
+   * @throw std::runtime_error if the ICL did not accept the connection within
+   * the start timeout
    */
   void start() override;
 
@@ -48,14 +82,88 @@ class ICLDeviceManager final : public DeviceManager {
    */
   void stop() override;
 
+  /**
+   * @brief Sets the time start() waits for the ICL to accept the connection,
+   * 30 s by default. Must be called before start().
+   *
+   * @param timeout Maximum time from starting the ICL until it is ready
+   */
+  void set_start_timeout(std::chrono::milliseconds timeout);
+
+  /**
+   * @brief Time the ICL took to accept the connection in the last start(),
+   * from the moment it got started.
+   *
+   * @return Time until the ICL was ready
+   */
+  [[nodiscard]] std::chrono::milliseconds icl_ready_time() const;
+
+  /**
+   * @brief Keeps the devices found by each discovery in the given file, so that
+   * the next start() does not have to wait for the discovery. Must be called
+   * before start().
+   *
+   * @param cache_file The file of the cache, see DiscoveryCache
+   */
+  void use_discovery_cache(const std::filesystem::path& cache_file);
+
+  /**
+   * @brief Reconnects to the ICL whenever the connection got lost, e.g. after
+   * the ICL restarted, restoring the discovery and the state of the opened
+   * devices, see communication::ReconnectingCommunicator. Requests in flight
+   * when the connection got lost fail with a
+   * communication::RetryableRequestError. Must be called before start().
+   *
+   * @param policy Delays and timeout of the reconnection
+   */
+  void use_automatic_reconnect(communication::ReconnectPolicy policy = {});
+
+  /**
+   * @brief Waits for the background discovery started by start(), if any, and
+   * for the devices to be opened if opening them on start.
+   *
+   * @throw OutdatedDiscoveryCacheError if the ICL reported other devices than
+   * the cached ones, the devices of the device manager have then been replaced
+   * by the discovered ones
+   * @throw std::runtime_error if the background discovery failed
+   */
+  void wait_for_discovery() noexcept(false);
+
   /**
    * @brief Discovers connected Horiba devices to the ICL
    *
+   * The CCDs and the monochromators are discovered concurrently over the same
+   * communicator.
+   *
    * @param error_on_no_device Whether to throw an exception if no devices have
    * been found.
    */
   void discover_devices(bool error_on_no_device = false) override;
 
+  /**
+   * @brief Opens all discovered devices concurrently.
+   *
+   * @throw std::runtime_error if one of the devices could not be opened, after
+   * all the others got opened
+   */
+  void open_all_devices() noexcept(false);
+
+  /**
+   * @brief Time taken by the last CCD discovery, see discover_devices().
+   *
+   * @return Duration of the last CCD discovery
+   */
+  [[nodiscard]] std::chrono::milliseconds
+  charge_coupled_devices_discovery_time() const;
+
+  /**
+   * @brief Time taken by the last monochromator discovery, see
+   * discover_devices().
+   *
+   * @return Duration of the last monochromator discovery
+   */
+  [[nodiscard]] std::chrono::milliseconds monochromators_discovery_time() const;
+
   /**
    * @brief The connected monochromators
    *
@@ -79,14 +187,32 @@ class ICLDeviceManager final : public DeviceManager {
   std::string websocket_port;
   bool manage_icl_lifetime;
   bool enable_binary_messages;
+  bool open_devices_on_start;
   std::shared_ptr<horiba::communication::Communicator> communicator;
   std::vector<std::shared_ptr<horiba::devices::single_devices::Monochromator>>
       monos;
   std::vector<
       std::shared_ptr<horiba::devices::single_devices::ChargeCoupledDevice>>
       ccds;
+  // written by the discovery threads, read by any caller
+  std::atomic<std::chrono::milliseconds> ccds_discovery_time{
+      std::chrono::milliseconds(0)};
+  std::atomic<std::chrono::milliseconds> monos_discovery_time{
+      std::chrono::milliseconds(0)};
+  std::chrono::milliseconds start_timeout{std::chrono::seconds(30)};
+  std::chrono::milliseconds ready_time{0};
+  std::string icl_version;
+  std::optional<DiscoveryCache> discovery_cache;
+  // guards ccds, monos and cached_devices, replaced by the background discovery
+  mutable std::mutex devices_mutex;
+  std::optional<DiscoveryCache::Entry> cached_devices;
+  // last member, so that the discovery is done before the others are destroyed
+  std::future<void> background_discovery;
 
+  void connect_when_ready(std::chrono::steady_clock::time_point icl_start);
   void enable_binary_messages_on_icl();
+  bool restore_cached_devices();
+  bool update_devices(bool error_on_no_device);
 };
 } /* namespace horiba::devices */
 
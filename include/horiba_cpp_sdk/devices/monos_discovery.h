@@ -40,9 +40,18 @@ class MonochromatorsDiscovery : public DeviceDiscovery {
   [[nodiscard]] std::vector<std::shared_ptr<single_devices::Monochromator>>
   monochromators() const;
 
+  /**
+   * @brief The "devices" listed by the ICL after calling the execute()
+   * function
+   *
+   * @return Json array of the detected monochromators
+   */
+  [[nodiscard]] const nlohmann::json& raw_devices() const;
+
  private:
   std::shared_ptr<horiba::communication::Communicator> communicator;
   std::vector<std::shared_ptr<single_devices::Monochromator>> monos;
+  nlohmann::json listed_monos = nlohmann::json::array();
 
   std::vector<std::shared_ptr<single_devices::Monochromator>> parse_monos(
       const nlohmann::json& raw_monos_list);
@@ -0,0 +1,175 @@
+#ifndef ACQUISITION_DATA_H
+#define ACQUISITION_DATA_H
+
+#include <horiba_cpp_sdk/common/aligned_allocator.h>
+#include <horiba_cpp_sdk/common/buffer_pool.h>
+#include <horiba_cpp_sdk/communication/binary_message.h>
+
+#include <cstddef>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace horiba::devices::single_devices {
+
+/**
+ * @brief Data of one region of interest of an acquisition.
+ *
+ * The x and y values are stored in separate contiguous, cache line aligned
+ * arrays. For images, the values are stored row after row.
+ */
+struct RegionOfInterestData {
+  int index = 0;
+  int x_origin = 0;
+  int y_origin = 0;
+  int x_size = 0;
+  int y_size = 0;
+  int x_binning = 1;
+  int y_binning = 1;
+  /**
+   * @brief Number of rows of the y values, 1 for spectra.
+   */
+  std::size_t rows = 1;
+  common::AlignedVector<double> x_values;
+  common::AlignedVector<double> y_values;
+
+  /**
+   * @brief Number of values in a row of y values.
+   *
+   * @return Number of columns
+   */
+  [[nodiscard]] std::size_t columns() const;
+
+  /**
+   * @brief Y values of one row.
+   *
+   * @param row Index of the row, starting at 0
+   *
+   * @return View on the values of the row
+   *
+   * @throw std::out_of_range if the row does not exist
+   */
+  [[nodiscard]] std::span<const double> y_row(std::size_t row) const
+      noexcept(false);
+};
+
+/**
+ * @brief Data of one acquisition of a CCD.
+ */
+struct Acquisition {
+  int index = 0;
+  std::vector<RegionOfInterestData> regions_of_interest;
+};
+
+/**
+ * @brief Acquisition data returned by
+ * ChargeCoupledDevice::get_acquisition_data().
+ *
+ * Built either from the json results of "ccd_getAcquisitionData", with the
+ * values in "xData"/"yData" rows or in "xyData" pairs, or from the numeric
+ * blocks of a binary message.
+ *
+ * Data bound to a buffer pool, see set_buffer_pool(), hands its buffers back
+ * to the pool when it is destroyed or assigned another data, so that the
+ * buffers of dropped frames are reused for the next ones.
+ */
+class AcquisitionData {
+ public:
+  AcquisitionData() = default;
+  AcquisitionData(const AcquisitionData& other) = default;
+  AcquisitionData(AcquisitionData&& other) noexcept = default;
+  AcquisitionData& operator=(const AcquisitionData& other);
+  AcquisitionData& operator=(AcquisitionData&& other) noexcept;
+  ~AcquisitionData();
+
+  /**
+   * @brief Builds the acquisition data from the json results of the ICL.
+   *
+   * @param results Results of "ccd_getAcquisitionData"
+   *
+   * @return The acquisition data
+   *
+   * @throw nlohmann::json::exception if the results are malformed
+   */
+  static AcquisitionData from_json(const nlohmann::json& results) noexcept(
+      false);
+
+  /**
+   * @brief Builds the acquisition data from a binary message of the ICL.
+   *
+   * @param results Results of "ccd_getAcquisitionData", without the values
+   * @param blocks Numeric blocks of the message
+   *
+   * @return The acquisition data
+   *
+   * @throw std::runtime_error if a block does not belong to any region of
+   * interest
+   */
+  static AcquisitionData from_binary_message(
+      const nlohmann::json& results,
+      const std::vector<communication::BinaryBlock>& blocks) noexcept(false);
+
+  /**
+   * @brief Builds the acquisition data from a binary message of the ICL,
+   * moving the values of the blocks instead of copying them.
+   *
+   * @param results Results of "ccd_getAcquisitionData", without the values
+   * @param blocks Numeric blocks of the message, moved from
+   *
+   * @return The acquisition data
+   *
+   * @throw std::runtime_error if a block does not belong to any region of
+   * interest
+   */
+  static AcquisitionData from_binary_message(
+      const nlohmann::json& results,
+      std::vector<communication::BinaryBlock>&& blocks) noexcept(false);
+
+  /**
+   * @brief Binds the data to the pool its buffers were taken from.
+   *
+   * @param buffers The pool receiving the buffers once the data is dropped
+   */
+  void set_buffer_pool(std::shared_ptr<common::BufferPool<double>> buffers);
+
+  /**
+   * @brief Hands the buffers of the values to a pool and empties the data.
+   *
+   * @param buffers The pool receiving the buffers
+   */
+  void release_buffers(common::BufferPool<double>& buffers);
+
+  /**
+   * @brief Hands the buffers of the values to the pool the data is bound to,
+   * if any, and empties the data.
+   */
+  void release_buffers();
+
+  /**
+   * @brief Acquisitions, in the order sent by the ICL.
+   *
+   * @return The acquisitions
+   */
+  [[nodiscard]] const std::vector<Acquisition>& acquisitions() const;
+
+  /**
+   * @brief Time at which all the programmed acquisitions completed. The same
+   * timestamp is used for all the acquisitions.
+   *
+   * @return The timestamp, empty if the ICL did not send one
+   */
+  [[nodiscard]] const std::string& timestamp() const;
+
+ private:
+  std::vector<Acquisition> acquisition_list;
+  std::string acquisition_timestamp;
+  std::shared_ptr<common::BufferPool<double>> buffer_pool;
+
+  static AcquisitionData parse_metadata(const nlohmann::json& results);
+  RegionOfInterestData& block_region(const communication::BinaryBlock& block);
+};
+
+} /* namespace horiba::devices::single_devices */
+#endif /* ifndef ACQUISITION_DATA_H */
@@ -2,13 +2,27 @@
 #define CCD_H
 
 #include <horiba_cpp_sdk/communication/communicator.h>
+#include <horiba_cpp_sdk/devices/single_devices/acquisition_data.h>
+#include <horiba_cpp_sdk/devices/single_devices/ccd_configuration.h>
 #include <horiba_cpp_sdk/devices/single_devices/device.h>
 
-#include <any>
+#include <horiba_cpp_sdk/common/spsc_ring_buffer.h>
+
+#include <atomic>
+#include <boost/asio/awaitable.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <nlohmann/json.hpp>
+#include <optional>
 #include <stdexcept>
+#include <stop_token>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -59,6 +73,40 @@ class ChargeCoupledDevice final : public Device {
     ONE_MICROSECOND
   };
 
+  /**
+   * @brief Region of interest of an acquisition, see set_region_of_interest().
+   */
+  struct RegionOfInterest {
+    int index = 1;
+    int x_origin = 0;
+    int y_origin = 0;
+    int x_size = 1024;
+    int y_size = 256;
+    int x_bin = 1;
+    int y_bin = 256;
+
+    bool operator==(const RegionOfInterest& other) const = default;
+  };
+
+  /**
+   * @brief Settings of an acquisition, applied in one batch with
+   * apply_acquisition_settings(). Settings left unset are not sent.
+   */
+  struct AcquisitionSettings {
+    std::optional<AcquisitionFormat> acquisition_format;
+    /**
+     * @brief Number of regions of interest, sent with the acquisition format.
+     */
+    int number_of_rois = 1;
+    std::optional<int> acquisition_count;
+    std::optional<XAxisConversionType> x_axis_conversion_type;
+    std::optional<TimerResolution> timer_resolution;
+    std::optional<int> exposure_time;
+    std::optional<int> gain_token;
+    std::optional<int> speed_token;
+    std::vector<RegionOfInterest> regions_of_interest;
+  };
+
   ChargeCoupledDevice(
       int id, std::shared_ptr<communication::Communicator> communicator);
   ~ChargeCoupledDevice() override = default;
@@ -99,12 +147,26 @@ class ChargeCoupledDevice final : public Device {
   /**
    * @brief Returns the configuration of the CCD.
    *
+   * The configuration is fetched from the ICL on the first call and kept until
+   * the CCD is opened, closed or restarted.
+   *
    * @return Configuration of the CCD
    *
    * @throw std::runtime_error when an error occurred on the device side
    */
   nlohmann::json get_configuration();
 
+  /**
+   * @brief Returns the parsed configuration of the CCD, see
+   * get_configuration().
+   *
+   * @return Configuration of the CCD, stays valid after the cache is cleared
+   *
+   * @throw std::runtime_error when an error occurred on the device side
+   */
+  std::shared_ptr<const ChargeCoupledDeviceConfiguration>
+  configuration() noexcept(false);
+
   /**
    * @brief Returns the gain token of the CCD.
    *
@@ -124,11 +186,14 @@ class ChargeCoupledDevice final : public Device {
    *
    * Note: The CCD can have different sensors installed, which can have
    * different gain values. Therefore you need to first check what gain values
-   * are available for the CCD using the get_configuration function.
+   * are available for the CCD using the get_configuration function. The gain
+   * is checked against the configuration, which is fetched on the first call
+   * after the CCD got opened or restarted, see configuration().
    *
    * @param gain_token Token of the gain to set
    *
-   * @throw std::runtime_error when an error occurred on the device side
+   * @throw std::runtime_error when the configuration has no gains, the gain is
+   * not part of it or an error occurred on the device side
    */
   void set_gain(int gain_token) noexcept(false);
 
@@ -150,11 +215,14 @@ class ChargeCoupledDevice final : public Device {
    *
    * Note: The CCD can have different sensors installed, which can have
    * different speed values. Therefore you need to first check what speed values
-   * are available for the CCD using the get_configuration function.
+   * are available for the CCD using the get_configuration function. The speed
+   * is checked against the configuration, which is fetched on the first call
+   * after the CCD got opened or restarted, see configuration().
    *
    * @param speed_token Token of the speed to set
    *
-   * @throw std::runtime_error when an error occurred on the device side
+   * @throw std::runtime_error when the configuration has no speeds, the speed
+   * is not part of it or an error occurred on the device side
    */
   void set_speed(int speed_token) noexcept(false);
 
@@ -493,11 +561,51 @@ class ChargeCoupledDevice final : public Device {
    * acquisitions are retrieve from the CCD after all acquisitions have
    * completed, therefore the same timestamp is used for all acquisitions.
    *
-   * @return std::any Acquisition data.
+   * The x and y data of each ROI end up in contiguous arrays, whether the ICL
+   * sent them as json or, with binary messages enabled, as numeric blocks.
+   * Large responses are parsed straight into those arrays, see
+   * communication::NumericDataResponseParser.
+   *
+   * Values parsed into the buffers of the communicator's pool go back to the
+   * pool once the returned data is dropped, see AcquisitionData.
+   *
+   * @return AcquisitionData Acquisition data.
    *
    * @throws std::exception When an error occurs on the device side.
    */
-  std::any get_acquisition_data() noexcept(false);
+  AcquisitionData get_acquisition_data() noexcept(false);
+
+  /**
+   * @brief Gets the acquisition data, see get_acquisition_data(), reusing the
+   * buffers of a previous one.
+   *
+   * The buffers of data are handed to the buffer pool of the communicator
+   * before the request, so that the new values are written into them.
+   * Acquisitions of the same size do not allocate buffers once the pool is
+   * warmed up. Calling set_acquisition_buffer_size() beforehand sizes the
+   * buffers of the first acquisitions too.
+   *
+   * @param data Receives the acquisition data
+   *
+   * @throws std::exception When an error occurs on the device side.
+   */
+  void get_acquisition_data(AcquisitionData& data) noexcept(false);
+
+  /**
+   * @brief Sizes the buffers the acquisition data is parsed into, if the
+   * communicator reuses buffers, see
+   * communication::Communicator::buffer_pool().
+   *
+   * The size is the one of the largest region of interest once binned, or of
+   * the whole chip when no region of interest was set. The buffers of the
+   * given number of frames are allocated up front, as many as the pool holds,
+   * so that the first acquisitions do not allocate either.
+   *
+   * @param frames Number of frames whose buffers are allocated
+   *
+   * @throws std::exception When an error occurs on the device side.
+   */
+  void set_acquisition_buffer_size(std::size_t frames = 1) noexcept(false);
 
   /**
    * @brief Returns true if the CCD is busy with the acquisition.
@@ -508,6 +616,113 @@ class ChargeCoupledDevice final : public Device {
    */
   bool get_acquisition_busy() noexcept(false);
 
+  /**
+   * @brief Applies the settings of an acquisition in one batch.
+   *
+   * The commands of the settings are sent back to back and their responses are
+   * collected at the end, so that applying the settings costs about one round
+   * trip to the ICL. Settings matching the last known state of the CCD, i.e.
+   * the last value set or read since the CCD got opened, are not sent.
+   *
+   * The acquisition format is sent first, then the regions of interest, the
+   * acquisition count, the x axis conversion type, the timer resolution, the
+   * exposure time, the gain and the speed.
+   *
+   * @param settings The settings to apply
+   *
+   * If the ICL rejects one of the settings, the settings it accepted are set
+   * back to their last known value, so that the CCD keeps the settings it had
+   * before the batch. Settings without a known value cannot be set back, the
+   * known state is dropped then and all the settings are sent again by the
+   * next batch.
+   *
+   * @throws std::runtime_error When the gain or speed is not part of the
+   * configuration, nothing is sent then, or when the ICL reports an error for
+   * one of the settings.
+   */
+  void apply_acquisition_settings(const AcquisitionSettings& settings) noexcept(
+      false);
+
+  /**
+   * @brief Blocking waits until the acquisition started with
+   * set_acquisition_start() is done.
+   *
+   * Nothing is polled during the configured exposure time, the last one set or
+   * read if known, queried otherwise. Afterwards, the busy state is polled
+   * with a delay starting at a tenth of the exposure time, between 1 ms and
+   * 100 ms, and doubling up to 500 ms.
+   *
+   * @param timeout Maximum time to wait for the acquisition
+   * @param stop_token Token to stop waiting before the timeout
+   *
+   * @throws std::runtime_error When the timeout is reached, the wait got
+   * cancelled or an error occurs on the device side.
+   */
+  void wait_for_acquisition(std::chrono::milliseconds timeout,
+                            std::stop_token stop_token = {}) noexcept(false);
+
+  /**
+   * @brief Waits until the acquisition is done in a coroutine, see
+   * wait_for_acquisition().
+   *
+   * The exposure time and the delays between the polls are waited on timers of
+   * the executor of the coroutine, so that one thread can wait on many
+   * devices. The exposure time is only waited for if known, it is not queried.
+   * The wait is cancelled with the coroutine, e.g. through the cancellation
+   * slot given to co_spawn().
+   *
+   * @param timeout Maximum time to wait for the acquisition
+   *
+   * @throws std::runtime_error When the timeout is reached or an error occurs
+   * on the device side.
+   */
+  boost::asio::awaitable<void> wait_for_acquisition_async(
+      std::chrono::milliseconds timeout);
+
+  /**
+   * @brief Returns true if the CCD is busy with the acquisition, in a
+   * coroutine, see get_acquisition_busy().
+   *
+   * The awaitable operations of the CCD are resumed on the executor of the
+   * awaiting coroutine, so that one thread can drive many devices. The CCD
+   * must outlive them.
+   *
+   * @return bool True if the CCD is busy.
+   *
+   * @throws std::exception When an error occurs on the device side.
+   */
+  boost::asio::awaitable<bool> get_acquisition_busy_async();
+
+  /**
+   * @brief Gets the acquisition data in a coroutine, see
+   * get_acquisition_data().
+   *
+   * @return AcquisitionData Acquisition data.
+   *
+   * @throws std::exception When an error occurs on the device side.
+   */
+  boost::asio::awaitable<AcquisitionData> get_acquisition_data_async();
+
+  /**
+   * @brief Starts an acquisition, waits until it is done and gets its data,
+   * in a coroutine.
+   *
+   * The coroutine sleeps during the exposure time if it is known, i.e. it got
+   * set or read since the CCD got opened. Afterwards, the busy state is polled
+   * as in wait_for_acquisition(), without blocking the thread.
+   *
+   * @param open_shutter Whether the shutter of the camera should be open
+   * @param timeout Maximum time to wait for the acquisition
+   *
+   * @return AcquisitionData Acquisition data.
+   *
+   * @throws std::runtime_error When the timeout is reached or an error occurs
+   * on the device side.
+   */
+  boost::asio::awaitable<AcquisitionData> acquire_async(
+      bool open_shutter = true,
+      std::chrono::milliseconds timeout = std::chrono::minutes(1));
+
   /**
    * @brief Stops the acquisition of the CCD.
    *
@@ -515,7 +730,113 @@ class ChargeCoupledDevice final : public Device {
    */
   void abort_acquisition(bool reset_port) noexcept(false);
 
+  /**
+   * @brief Starts acquiring continuously on a background thread.
+   *
+   * The thread starts an acquisition, waits for it, fetches its data and starts
+   * the next one right away. The data of each acquisition is pushed into a ring
+   * of frame_slots frames, popped with try_pop_frame(). The thread never waits
+   * for the consumer: frames acquired while the ring is full are dropped, see
+   * dropped_frames().
+   *
+   * The acquisition settings are the ones of the CCD when streaming starts.
+   * The frames are parsed into the buffers of the frames popped before them,
+   * see get_acquisition_data(AcquisitionData&).
+   *
+   * @param frame_slots Number of frames the ring can hold
+   * @param open_shutter Whether the shutter of the camera should be open
+   * @param frame_timeout Maximum time to wait for each acquisition
+   *
+   * @throws std::runtime_error When already streaming
+   */
+  void start_streaming(std::size_t frame_slots = 8, bool open_shutter = true,
+                       std::chrono::milliseconds frame_timeout =
+                           std::chrono::seconds(10)) noexcept(false);
+
+  /**
+   * @brief Stops streaming, aborting the ongoing acquisition. Frames still in
+   * the ring can be popped afterwards.
+   *
+   * @throws std::exception The error that stopped the streaming thread, if
+   * any
+   */
+  void stop_streaming() noexcept(false);
+
+  /**
+   * @brief Checks if the streaming thread is acquiring.
+   *
+   * @return False once stopped, or after the streaming thread failed
+   */
+  [[nodiscard]] bool is_streaming() const;
+
+  /**
+   * @brief Pops the oldest streamed frame, without waiting. Only one thread
+   * may pop frames.
+   *
+   * @param frame Receives the frame. Its previous buffers are handed back to
+   * the streaming thread.
+   *
+   * @return True if a frame got popped, false if none is waiting
+   */
+  bool try_pop_frame(AcquisitionData& frame);
+
+  /**
+   * @brief Number of frames dropped since streaming started, because the ring
+   * was full.
+   *
+   * @return Number of dropped frames
+   */
+  [[nodiscard]] std::uint64_t dropped_frames() const;
+
  private:
+  std::mutex configuration_mutex;
+  std::shared_ptr<const ChargeCoupledDeviceConfiguration> cached_configuration;
+
+  void clear_configuration();
+
+  std::mutex known_settings_mutex;
+  AcquisitionSettings known_settings;
+
+  void update_known_settings(
+      const communication::Response& response,
+      const std::function<void(AcquisitionSettings&)>& update);
+  void clear_known_settings();
+  void restore_acquisition_settings(
+      const std::vector<communication::Response>& responses,
+      const std::vector<
+          std::function<std::optional<communication::Command>()>>& restores);
+
+  [[nodiscard]] communication::Command acquisition_format_command(
+      int number_of_rois, AcquisitionFormat acquisition_format) const;
+  [[nodiscard]] communication::Command acquisition_count_command(
+      int count) const;
+  [[nodiscard]] communication::Command x_axis_conversion_type_command(
+      XAxisConversionType conversion_type) const;
+  [[nodiscard]] communication::Command timer_resolution_command(
+      TimerResolution timer_resolution) const;
+  [[nodiscard]] communication::Command exposure_time_command(
+      int exposure_time_ms) const;
+  [[nodiscard]] communication::Command gain_command(int gain_token) const;
+  [[nodiscard]] communication::Command speed_command(int speed_token) const;
+  [[nodiscard]] communication::Command region_of_interest_command(
+      const RegionOfInterest& roi) const;
+
+  [[nodiscard]] std::chrono::microseconds exposure_duration();
+  [[nodiscard]] std::optional<std::chrono::microseconds>
+  known_exposure_duration();
+
+  AcquisitionData acquisition_data(communication::Response& response);
+
+  std::unique_ptr<common::SpscRingBuffer<AcquisitionData>> streamed_frames;
+  std::atomic<bool> streaming{false};
+  // only read once the streaming thread got joined
+  std::exception_ptr streaming_error;
+  // last member, so that the thread is joined before the others are destroyed
+  std::jthread streaming_thread;
+
+  void stream(std::stop_token stop_token, bool open_shutter,
+              std::chrono::milliseconds frame_timeout);
+  void join_streaming_thread();
 };
 } /* namespace horiba::devices::single_devices */
 #endif /* ifndef CCD_H */
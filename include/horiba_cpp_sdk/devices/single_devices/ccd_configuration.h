@@ -0,0 +1,132 @@
+#ifndef CCD_CONFIGURATION_H
+#define CCD_CONFIGURATION_H
+
+#include <array>
+#include <cstddef>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <unordered_set>
+
+namespace horiba::devices::single_devices {
+
+/**
+ * @brief Parsed configuration of a CCD, as returned by "ccd_getConfig".
+ *
+ * The gain and speed tokens and the (address, event, type) tokens of the
+ * trigger inputs and signal outputs are indexed once when the configuration is
+ * built, so that validating a setting does not require walking the json.
+ */
+class ChargeCoupledDeviceConfiguration {
+ public:
+  /**
+   * @brief Builds the configuration from the json sent by the ICL.
+   *
+   * @param configuration The "configuration" field of "ccd_getConfig"
+   */
+  explicit ChargeCoupledDeviceConfiguration(nlohmann::json configuration);
+
+  /**
+   * @brief The configuration as sent by the ICL.
+   *
+   * @return Json of the configuration
+   */
+  [[nodiscard]] const nlohmann::json& json() const;
+
+  /**
+   * @brief Checks if the gain token exists in the configuration.
+   *
+   * @param gain_token Token of the gain
+   *
+   * @return True if the gain exists
+   */
+  [[nodiscard]] bool has_gain(int gain_token) const;
+
+  /**
+   * @brief Checks if the speed token exists in the configuration.
+   *
+   * @param speed_token Token of the speed
+   *
+   * @return True if the speed exists
+   */
+  [[nodiscard]] bool has_speed(int speed_token) const;
+
+  /**
+   * @brief Checks that a gain exists in the configuration.
+   *
+   * @param gain_token Token of the gain
+   *
+   * @throw std::runtime_error if the configuration has no gains or not this one
+   */
+  void validate_gain(int gain_token) const noexcept(false);
+
+  /**
+   * @brief Checks that a speed exists in the configuration.
+   *
+   * @param speed_token Token of the speed
+   *
+   * @throw std::runtime_error if the configuration has no speeds or not this
+   * one
+   */
+  void validate_speed(int speed_token) const noexcept(false);
+
+  /**
+   * @brief Checks that a trigger input exists in the configuration.
+   *
+   * @param address Token of the trigger address
+   * @param event Token of the trigger event
+   * @param signal_type Token of the trigger type
+   *
+   * @throw std::runtime_error naming the first token not found
+   */
+  void validate_trigger_input(int address, int event, int signal_type) const
+      noexcept(false);
+
+  /**
+   * @brief Checks that a signal output exists in the configuration.
+   *
+   * @param address Token of the signal address
+   * @param event Token of the signal event
+   * @param signal_type Token of the signal type
+   *
+   * @throw std::runtime_error naming the first token not found
+   */
+  void validate_signal_output(int address, int event, int signal_type) const
+      noexcept(false);
+
+ private:
+  /**
+   * @brief Tokens of an address, an event of the address and a type of the
+   * event. Unused trailing tokens are set to -1, so that the same set holds
+   * the addresses, events and types.
+   */
+  using TokenPath = std::array<int, 3>;
+
+  struct TokenPathHash {
+    std::size_t operator()(const TokenPath& path) const noexcept;
+  };
+
+  /**
+   * @brief Index of the "gains", "speeds", "triggers" or "signals" of the
+   * configuration. Not available if the configuration does not list them.
+   */
+  struct TokenIndex {
+    bool available = false;
+    std::unordered_set<TokenPath, TokenPathHash> paths;
+  };
+
+  nlohmann::json configuration;
+  TokenIndex gain_tokens;
+  TokenIndex speed_tokens;
+  TokenIndex trigger_inputs;
+  TokenIndex signal_outputs;
+
+  static TokenIndex index_tokens(const nlohmann::json& entries);
+  static TokenIndex index_token_paths(const nlohmann::json& entries);
+  static void validate(const TokenIndex& index, const std::string& kind,
+                       int token);
+  static void validate(const TokenIndex& index, const std::string& kind,
+                       int address, int event, int signal_type);
+};
+
+} /* namespace horiba::devices::single_devices */
+#endif /* ifndef CCD_CONFIGURATION_H */
@@ -4,6 +4,13 @@
 #include <horiba_cpp_sdk/communication/communicator.h>
 #include <horiba_cpp_sdk/communication/response.h>
 
+#include <boost/asio/awaitable.hpp>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
 namespace horiba::devices::single_devices {
 /**
  * @brief Interface for devices connected to the ICL
@@ -14,7 +21,8 @@ class Device {
   virtual ~Device() = default;
 
   /**
-   * @brief Opens the device.
+   * @brief Opens the device, and the communicator if it is closed. Devices
+   * sharing a communicator can be opened from different threads.
    */
   virtual void open();
 
@@ -23,16 +31,106 @@ class Device {
    */
   virtual void close() = 0;
 
+  /**
+   * @brief Sets the time within which the ICL has to answer each command of
+   * the device. Must be called before commands are sent, it is not
+   * synchronized with requests in flight.
+   *
+   * @param timeout The timeout, none to wait for as long as it takes
+   */
+  void set_command_timeout(std::optional<std::chrono::milliseconds> timeout);
+
  protected:
+  /**
+   * @brief Sends a command and waits for its response, within the timeout of
+   * the device, see set_command_timeout().
+   *
+   * @param command The command to send
+   *
+   * @return The response
+   *
+   * @throw std::runtime_error if the communicator is closed or the response
+   * could not be received
+   * @throw communication::RequestTimeoutError if the ICL did not answer in
+   * time
+   */
   communication::Response execute_command(
       const communication::Command& command);
 
+  /**
+   * @brief Sends a command and waits for its response, giving up on the
+   * deadline or the cancellation of the options.
+   *
+   * @param command The command to send
+   * @param options Deadline and cancellation of the request, replacing the
+   * timeout of the device
+   *
+   * @return The response
+   *
+   * @throw std::runtime_error if the communicator is closed or the response
+   * could not be received
+   * @throw communication::RequestTimeoutError if the deadline passed
+   * @throw communication::RequestCancelledError if the request got cancelled
+   */
+  communication::Response execute_command(
+      const communication::Command& command,
+      const communication::RequestOptions& options);
+
+  /**
+   * @brief Sends a command and awaits its response, within the timeout of the
+   * device, see set_command_timeout(). The coroutine is resumed on its own
+   * executor, no thread waits for the ICL meanwhile.
+   *
+   * Cancelling the coroutine, e.g. through an awaitable operator, cancels the
+   * request.
+   *
+   * @param command The command to send
+   *
+   * @return The response
+   *
+   * @throw std::runtime_error if the communicator is closed or the response
+   * could not be received
+   * @throw communication::RequestTimeoutError if the ICL did not answer in
+   * time
+   * @throw communication::RequestCancelledError if the request got cancelled
+   */
+  boost::asio::awaitable<communication::Response> execute_command_async(
+      communication::Command command);
+
+  /**
+   * @brief Sends the commands back to back, without waiting for the response
+   * of a command before sending the next one, then waits for all responses.
+   *
+   * Errors reported by the ICL are logged and left in the responses.
+   *
+   * @param commands The commands to send, in order
+   *
+   * @return The responses, in the order of the commands
+   *
+   * @throw std::runtime_error if the communicator is closed or a response
+   * could not be received
+   * @throw communication::RequestTimeoutError if the ICL did not answer all
+   * the commands within the timeout of the device
+   */
+  std::vector<communication::Response> execute_commands(
+      const std::vector<communication::Command>& commands);
+
   [[nodiscard]] int device_id() const;
 
+  /**
+   * @brief Pool of the communicator the numeric data of the responses is
+   * written into, see communication::Communicator::buffer_pool().
+   *
+   * @return The pool, null if the communicator does not reuse buffers
+   */
+  [[nodiscard]] std::shared_ptr<common::BufferPool<double>> buffer_pool() const;
+
  private:
   int id;
   std::shared_ptr<communication::Communicator> communicator;
+  std::optional<std::chrono::milliseconds> command_timeout;
 
+  [[nodiscard]] communication::RequestOptions command_options() const;
   void handle_errors(const std::vector<std::string>& errors);
 };
 } /* namespace horiba::devices::single_devices */
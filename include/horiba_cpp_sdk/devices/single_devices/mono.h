@@ -4,6 +4,8 @@
 #include <horiba_cpp_sdk/communication/communicator.h>
 #include <horiba_cpp_sdk/devices/single_devices/device.h>
 
+#include <boost/asio/awaitable.hpp>
+#include <chrono>
 #include <string>
 
 namespace horiba::devices::single_devices {
@@ -293,12 +295,76 @@ class Monochromator final : public Device {
   /**
    * @brief Blocking waits until the monochromator is ready.
    *
-   * @param timeout Maximum time, in seconds [s], to wait for the monochromator
-   * to be ready.
+   * The busy state is polled every few milliseconds at first, then less and
+   * less often, so that short moves are noticed quickly without flooding the
+   * ICL during long ones.
+   *
+   * @param timeout Maximum time to wait for the monochromator to be ready.
+   *
+   * @throw std::runtime_error when the timeout is reached
+   */
+  void wait_until_ready(std::chrono::milliseconds timeout) noexcept(false);
+
+  /**
+   * @brief Checks if the monochromator is busy, in a coroutine, see is_busy().
+   *
+   * The awaitable operations of the monochromator are resumed on the executor
+   * of the awaiting coroutine, so that one thread can drive many devices. The
+   * monochromator must outlive them.
+   *
+   * @return True if busy, false otherwise
+   *
+   * @throw std::runtime_error when an error occurred on the device side
+   */
+  boost::asio::awaitable<bool> is_busy_async();
+
+  /**
+   * @brief Current wavelength of the monochromator's position in nm, in a
+   * coroutine, see get_current_wavelength().
+   *
+   * @return The current wavelength in nm
+   *
+   * @throw std::runtime_error when an error occurred on the device side
+   */
+  boost::asio::awaitable<double> get_current_wavelength_async();
+
+  /**
+   * @brief Moves the monochromator to the requested wavelength and waits until
+   * it is ready, in a coroutine.
+   *
+   * @param wavelength Wavelength in nm
+   * @param timeout Maximum time to wait for the monochromator to be ready
+   *
+   * @throw std::runtime_error when an error occurred on the device side or the
+   * timeout is reached
+   */
+  boost::asio::awaitable<void> move_to_target_wavelength_async(
+      double wavelength,
+      std::chrono::milliseconds timeout = std::chrono::minutes(1));
+
+  /**
+   * @brief Homes the monochromator and waits until it is ready, in a
+   * coroutine, see home().
+   *
+   * @param timeout Maximum time to wait for the monochromator to be ready
+   *
+   * @throw std::runtime_error when an error occurred on the device side or the
+   * timeout is reached
+   */
+  boost::asio::awaitable<void> home_async(
+      std::chrono::milliseconds timeout = std::chrono::minutes(1));
+
+  /**
+   * @brief Waits until the monochromator is ready in a coroutine, polling as
+   * wait_until_ready() does on a timer of the executor of the coroutine, so
+   * that one thread can wait on many devices.
+   *
+   * @param timeout Maximum time to wait for the monochromator to be ready.
    *
    * @throw std::runtime_error when the timeout is reached
    */
-  void wait_until_ready(std::chrono::seconds timeout) noexcept(false);
+  boost::asio::awaitable<void> wait_until_ready_async(
+      std::chrono::milliseconds timeout);
 };
 }  // namespace horiba::devices::single_devices
 #endif /* ifndef MONO_H */
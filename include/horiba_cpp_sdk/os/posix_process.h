@@ -0,0 +1,115 @@
+#ifndef POSIX_PROCESS_H
+#define POSIX_PROCESS_H
+
+#include <horiba_cpp_sdk/os/process.h>
+#include <sys/types.h>
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace horiba::os {
+/**
+ * @brief Represents a process on Linux and other POSIX systems, e.g. the ICL
+ * or a local server standing in for it, that can be started and stopped.
+ *
+ * The process is spawned with posix_spawn(). On Linux, it is signaled and
+ * waited for through a pidfd, so that a recycled process id is never
+ * signaled.
+ */
+class PosixProcess : public Process {
+ public:
+  /**
+   * @brief Builds a POSIX process
+   *
+   * @param process_path Folder where the executable is located, with a
+   * trailing '/'. Empty to search the executable in the PATH.
+   * @param process_name Name of the executable
+   * @param arguments Arguments given to the executable
+   */
+  explicit PosixProcess(std::string process_path, std::string process_name,
+                        std::vector<std::string> arguments = {});
+  ~PosixProcess() override;
+
+  PosixProcess(const PosixProcess&) = delete;
+  PosixProcess& operator=(const PosixProcess&) = delete;
+  PosixProcess(PosixProcess&&) = delete;
+  PosixProcess& operator=(PosixProcess&&) = delete;
+
+  /**
+   * @brief Makes start() wait until the process accepts connections on the
+   * given port, polled with delays growing from a few milliseconds. Must be
+   * called before start().
+   *
+   * @param host Host the process listens on
+   * @param port Port the process listens on, e.g. the websocket port of the
+   * ICL
+   * @param timeout Maximum time to wait for the process to accept connections
+   */
+  void wait_for_port(std::string host, std::string port,
+                     std::chrono::milliseconds timeout);
+
+  /**
+   * @brief Starts the process if not already started. With wait_for_port(),
+   * returns once the process accepts connections.
+   *
+   * @throw std::runtime_error if the process could not be spawned, or exited
+   * or did not accept connections in time, in which case it is stopped
+   */
+  void start() override;
+
+  /**
+   * @brief Returns whether the process is running or not. Without a process
+   * started by this instance, looks for a process of the same executable on
+   * Linux.
+   *
+   * @return True if the process is running, false otherwise.
+   */
+  bool running() override;
+
+  /**
+   * @brief Stops the process if currently running, asking it to terminate
+   * with SIGTERM and killing it if it did not exit within the stop timeout.
+   *
+   * @throw std::runtime_error if the process could not be signaled
+   */
+  void stop() override;
+
+  /**
+   * @brief Sets the time the process gets to exit after SIGTERM before being
+   * killed, 5 s by default.
+   *
+   * @param timeout The time to exit
+   */
+  void set_stop_timeout(std::chrono::milliseconds timeout);
+
+ private:
+  struct ReadinessProbe {
+    std::string host;
+    std::string port;
+    std::chrono::milliseconds timeout;
+  };
+
+  std::string process_path;
+  std::string process_name;
+  std::vector<std::string> arguments;
+  std::optional<ReadinessProbe> readiness_probe;
+  std::chrono::milliseconds stop_timeout{std::chrono::seconds(5)};
+  // process started by this instance, or found by running()
+  pid_t process_id = 0;
+  bool child = false;
+  int process_fd = -1;
+
+  void spawn();
+  void wait_until_ready(const ReadinessProbe& probe);
+  [[nodiscard]] bool exited();
+  bool wait_for_exit(std::chrono::milliseconds timeout);
+  void signal(int signal_number);
+  void forget_process();
+  void track_process(pid_t pid, bool spawned);
+  [[nodiscard]] std::optional<pid_t> find_process() const;
+};
+} /* namespace horiba::os */
+
+#endif /* ifndef POSIX_PROCESS_H */
@@ -0,0 +1,220 @@
+#include "horiba_cpp_sdk/communication/binary_message.h"
+
+#include <bit>
+#include <boost/endian/conversion.hpp>
+#include <cstring>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace horiba::communication {
+
+namespace {
+
+constexpr std::size_t BLOCK_HEADER_SIZE = 12;
+
+/**
+ * @brief Reads little endian values from a frame, checking the bounds.
+ */
+class FrameReader {
+ public:
+  explicit FrameReader(std::span<const std::byte> frame) : frame{frame} {}
+
+  template <typename T>
+  T read() {
+    return load<T>(this->take(sizeof(T)).data());
+  }
+
+  std::span<const std::byte> take(std::size_t size) {
+    if (size > this->remaining()) {
+      throw std::runtime_error("malformed binary message: frame too short");
+    }
+    auto bytes = this->frame.subspan(this->offset, size);
+    this->offset += size;
+    return bytes;
+  }
+
+  [[nodiscard]] std::size_t remaining() const {
+    return this->frame.size() - this->offset;
+  }
+
+  [[nodiscard]] bool at_end() const {
+    return this->offset == this->frame.size();
+  }
+
+  template <typename T>
+  static T load(const std::byte* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return boost::endian::little_to_native(value);
+  }
+
+ private:
+  std::span<const std::byte> frame;
+  std::size_t offset = 0;
+};
+
+class FrameWriter {
+ public:
+  template <typename T>
+  void write(T value) {
+    boost::endian::native_to_little_inplace(value);
+    const auto* bytes = reinterpret_cast<const std::byte*>(&value);
+    this->frame.insert(this->frame.end(), bytes, bytes + sizeof(T));
+  }
+
+  void write(const std::string& text) {
+    const auto* bytes = reinterpret_cast<const std::byte*>(text.data());
+    this->frame.insert(this->frame.end(), bytes, bytes + text.size());
+  }
+
+  std::vector<std::byte> frame;
+};
+
+std::size_t element_size(BinaryBlock::ElementType element_type) {
+  switch (element_type) {
+    case BinaryBlock::ElementType::UINT16:
+      return sizeof(std::uint16_t);
+    case BinaryBlock::ElementType::UINT32:
+      return sizeof(std::uint32_t);
+    case BinaryBlock::ElementType::FLOAT32:
+      return sizeof(float);
+    case BinaryBlock::ElementType::FLOAT64:
+      return sizeof(double);
+  }
+  throw std::runtime_error("malformed binary message: unknown element type " +
+                           std::to_string(static_cast<int>(element_type)));
+}
+
+void decode_values(std::span<const std::byte> raw_values,
+                   BinaryBlock::ElementType element_type,
+                   common::AlignedVector<double>& values) {
+  const auto size = element_size(element_type);
+  const auto count = raw_values.size() / size;
+  values.resize(count);
+  const std::byte* data = raw_values.data();
+  for (std::size_t i = 0; i < count; ++i, data += size) {
+    switch (element_type) {
+      case BinaryBlock::ElementType::UINT16:
+        values[i] = FrameReader::load<std::uint16_t>(data);
+        break;
+      case BinaryBlock::ElementType::UINT32:
+        values[i] = FrameReader::load<std::uint32_t>(data);
+        break;
+      case BinaryBlock::ElementType::FLOAT32:
+        values[i] =
+            std::bit_cast<float>(FrameReader::load<std::uint32_t>(data));
+        break;
+      case BinaryBlock::ElementType::FLOAT64:
+        values[i] =
+            std::bit_cast<double>(FrameReader::load<std::uint64_t>(data));
+        break;
+    }
+  }
+}
+
+void encode_values(const common::AlignedVector<double>& values,
+                   BinaryBlock::ElementType element_type, FrameWriter& writer) {
+  for (const double value : values) {
+    switch (element_type) {
+      case BinaryBlock::ElementType::UINT16:
+        writer.write(static_cast<std::uint16_t>(value));
+        break;
+      case BinaryBlock::ElementType::UINT32:
+        writer.write(static_cast<std::uint32_t>(value));
+        break;
+      case BinaryBlock::ElementType::FLOAT32:
+        writer.write(std::bit_cast<std::uint32_t>(static_cast<float>(value)));
+        break;
+      case BinaryBlock::ElementType::FLOAT64:
+        writer.write(std::bit_cast<std::uint64_t>(value));
+        break;
+    }
+  }
+}
+
+} /* namespace */
+
+BinaryMessage BinaryMessage::decode(std::span<const std::byte> frame,
+                                    common::BufferPool<double>* buffers) {
+  FrameReader reader{frame};
+
+  if (reader.read<std::uint32_t>() != MAGIC) {
+    throw std::runtime_error("malformed binary message: wrong magic number");
+  }
+
+  BinaryMessage message;
+  const auto metadata_size = reader.read<std::uint32_t>();
+  const auto raw_metadata = reader.take(metadata_size);
+  message.json_metadata = nlohmann::json::parse(
+      reinterpret_cast<const char*>(raw_metadata.data()),
+      reinterpret_cast<const char*>(raw_metadata.data() + raw_metadata.size()));
+
+  // the counts come from the frame, they are checked against its size before
+  // anything gets allocated for them
+  const auto block_count = reader.read<std::uint32_t>();
+  if (block_count > reader.remaining() / BLOCK_HEADER_SIZE) {
+    throw std::runtime_error("malformed binary message: too many blocks");
+  }
+  message.numeric_blocks.resize(block_count);
+  for (auto& block : message.numeric_blocks) {
+    block.acquisition_index = reader.read<std::uint16_t>();
+    block.roi_index = reader.read<std::uint16_t>();
+    block.axis = static_cast<BinaryBlock::Axis>(reader.read<std::uint8_t>());
+    block.element_type =
+        static_cast<BinaryBlock::ElementType>(reader.read<std::uint8_t>());
+    block.rows = reader.read<std::uint16_t>();
+    const auto element_count = reader.read<std::uint32_t>();
+    const auto raw_values =
+        reader.take(element_count * element_size(block.element_type));
+    if (buffers != nullptr) {
+      block.values = buffers->acquire(element_count);
+    }
+    decode_values(raw_values, block.element_type, block.values);
+  }
+
+  if (!reader.at_end()) {
+    throw std::runtime_error("malformed binary message: trailing bytes");
+  }
+
+  return message;
+}
+
+std::vector<std::byte> BinaryMessage::encode(
+    const nlohmann::json& metadata, const std::vector<BinaryBlock>& blocks) {
+  const std::string raw_metadata = metadata.dump();
+
+  std::size_t frame_size = 3 * sizeof(std::uint32_t) + raw_metadata.size();
+  for (const auto& block : blocks) {
+    frame_size += BLOCK_HEADER_SIZE +
+                  block.values.size() * element_size(block.element_type);
+  }
+
+  FrameWriter writer;
+  writer.frame.reserve(frame_size);
+  writer.write(MAGIC);
+  writer.write(static_cast<std::uint32_t>(raw_metadata.size()));
+  writer.write(raw_metadata);
+  writer.write(static_cast<std::uint32_t>(blocks.size()));
+  for (const auto& block : blocks) {
+    writer.write(static_cast<std::uint16_t>(block.acquisition_index));
+    writer.write(static_cast<std::uint16_t>(block.roi_index));
+    writer.write(static_cast<std::uint8_t>(block.axis));
+    writer.write(static_cast<std::uint8_t>(block.element_type));
+    writer.write(static_cast<std::uint16_t>(block.rows));
+    writer.write(static_cast<std::uint32_t>(block.values.size()));
+    encode_values(block.values, block.element_type, writer);
+  }
+  return writer.frame;
+}
+
+const nlohmann::json& BinaryMessage::metadata() const {
+  return this->json_metadata;
+}
+
+std::vector<BinaryBlock>& BinaryMessage::blocks() {
+  return this->numeric_blocks;
+}
+
+} /* namespace horiba::communication */
@@ -1,16 +1,140 @@
 #include "horiba_cpp_sdk/communication/command.h"
 
+#include <array>
 #include <atomic>
+#include <charconv>
+#include <cmath>
 #include <nlohmann/json.hpp>
 #include <string>
+#include <string_view>
 #include <utility>
 
 namespace horiba::communication {
 
+namespace {
+
+template <typename Number>
+void write_number(std::string& buffer, Number number) {
+  std::array<char, 32> digits{};
+  const auto result =
+      std::to_chars(digits.data(), digits.data() + digits.size(), number);
+  buffer.append(digits.data(), result.ptr);
+}
+
+void write_float(std::string& buffer, double number) {
+  // same as nlohmann::json::dump()
+  if (!std::isfinite(number)) {
+    buffer += "null";
+    return;
+  }
+  const auto start = buffer.size();
+  write_number(buffer, number);
+  if (buffer.find_first_of(".e", start) == std::string::npos) {
+    buffer += ".0";
+  }
+}
+
+void write_string(std::string& buffer, std::string_view text) {
+  static constexpr std::string_view hex_digits = "0123456789abcdef";
+  buffer += '"';
+  for (const char character : text) {
+    switch (character) {
+      case '"':
+        buffer += "\\\"";
+        break;
+      case '\\':
+        buffer += "\\\\";
+        break;
+      case '\b':
+        buffer += "\\b";
+        break;
+      case '\f':
+        buffer += "\\f";
+        break;
+      case '\n':
+        buffer += "\\n";
+        break;
+      case '\r':
+        buffer += "\\r";
+        break;
+      case '\t':
+        buffer += "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(character) < 0x20) {
+          buffer += "\\u00";
+          buffer += hex_digits[static_cast<unsigned char>(character) >> 4U];
+          buffer += hex_digits[static_cast<unsigned char>(character) & 0xFU];
+        } else {
+          buffer += character;
+        }
+    }
+  }
+  buffer += '"';
+}
+
+void write_json(std::string& buffer, const nlohmann::json& value) {
+  switch (value.type()) {
+    case nlohmann::json::value_t::null:
+    case nlohmann::json::value_t::discarded:
+      buffer += "null";
+      break;
+    case nlohmann::json::value_t::boolean:
+      buffer += value.get<bool>() ? "true" : "false";
+      break;
+    case nlohmann::json::value_t::number_integer:
+      write_number(buffer, value.get<nlohmann::json::number_integer_t>());
+      break;
+    case nlohmann::json::value_t::number_unsigned:
+      write_number(buffer, value.get<nlohmann::json::number_unsigned_t>());
+      break;
+    case nlohmann::json::value_t::number_float:
+      write_float(buffer, value.get<nlohmann::json::number_float_t>());
+      break;
+    case nlohmann::json::value_t::string:
+      write_string(buffer, value.get_ref<const std::string&>());
+      break;
+    case nlohmann::json::value_t::array: {
+      buffer += '[';
+      bool first = true;
+      for (const auto& element : value) {
+        if (!first) {
+          buffer += ',';
+        }
+        first = false;
+        write_json(buffer, element);
+      }
+      buffer += ']';
+      break;
+    }
+    case nlohmann::json::value_t::object: {
+      buffer += '{';
+      bool first = true;
+      for (const auto& [key, element] : value.items()) {
+        if (!first) {
+          buffer += ',';
+        }
+        first = false;
+        write_string(buffer, key);
+        buffer += ':';
+        write_json(buffer, element);
+      }
+      buffer += '}';
+      break;
+    }
+    case nlohmann::json::value_t::binary:
+      // never sent to the ICL
+      buffer += value.dump();
+      break;
+  }
+}
+
+} /* namespace */
+
 std::atomic<unsigned long long int> Command::next_id{0};
 
 Command::Command(std::string command, nlohmann::json parameters)
-    : id{this->next_id++},
+    : command_id{this->next_id++},
       command{std::move(command)},
       // we cannot use braces {} here, as the library transforms the json into a
       // list. see:
@@ -18,8 +142,28 @@ Command::Command(std::string command, nlohmann::json parameters)
       parameters(std::move(parameters)) {}
 
 nlohmann::json Command::json() const {
-  return {{"id", this->id},
+  return {{"id", this->command_id},
           {"command", this->command},
           {"parameters", this->parameters}};
 }
+
+void Command::serialize(std::string& buffer) const {
+  // same member order as json().dump(), which sorts the keys
+  buffer.clear();
+  buffer += "{\"command\":";
+  write_string(buffer, this->command);
+  buffer += ",\"id\":";
+  write_number(buffer, this->command_id);
+  buffer += ",\"parameters\":";
+  write_json(buffer, this->parameters);
+  buffer += '}';
+}
+
+unsigned long long int Command::id() const { return this->command_id; }
+
+const std::string& Command::name() const { return this->command; }
+
+const nlohmann::json& Command::json_parameters() const {
+  return this->parameters;
+}
 } /* namespace horiba::communication */
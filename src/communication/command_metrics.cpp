@@ -0,0 +1,238 @@
+#include "horiba_cpp_sdk/communication/command_metrics.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <nlohmann/json.hpp>
+#include <shared_mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace horiba::communication {
+
+namespace {
+
+std::uint64_t nanoseconds(std::chrono::nanoseconds duration) {
+  return static_cast<std::uint64_t>(
+      std::max<std::int64_t>(duration.count(), 0));
+}
+
+nlohmann::json histogram_json(const Histogram::Snapshot& histogram) {
+  // only the buckets up to the last non empty one are written
+  std::size_t used_buckets = Histogram::BUCKETS;
+  while (used_buckets > 0 && histogram.buckets[used_buckets - 1] == 0) {
+    --used_buckets;
+  }
+  return {{"count", histogram.count},
+          {"sum", histogram.sum},
+          {"max", histogram.max},
+          {"buckets", std::vector<std::uint64_t>(
+                          histogram.buckets.begin(),
+                          histogram.buckets.begin() +
+                              static_cast<std::ptrdiff_t>(used_buckets))}};
+}
+
+/**
+ * @brief Writes one command of a Prometheus histogram.
+ *
+ * @param scale Factor converting the recorded values to the unit of the metric
+ */
+void write_prometheus_histogram(std::ostringstream& text,
+                                const std::string& name,
+                                const std::string& command,
+                                const Histogram::Snapshot& histogram,
+                                double scale) {
+  std::uint64_t cumulative_count = 0;
+  for (std::size_t bucket = 0; bucket + 1 < Histogram::BUCKETS; ++bucket) {
+    cumulative_count += histogram.buckets[bucket];
+    if (histogram.buckets[bucket] == 0 && cumulative_count == 0) {
+      continue;
+    }
+    // the values are integers, the largest one of the bucket is inclusive
+    text << name << "_bucket{command=\"" << command << "\",le=\""
+         << static_cast<double>(Histogram::Snapshot::upper_bound(bucket) - 1) *
+                scale
+         << "\"} " << cumulative_count << '\n';
+    if (cumulative_count == histogram.count) {
+      break;
+    }
+  }
+  text << name << "_bucket{command=\"" << command << "\",le=\"+Inf\"} "
+       << histogram.count << '\n';
+  text << name << "_sum{command=\"" << command << "\"} "
+       << static_cast<double>(histogram.sum) * scale << '\n';
+  text << name << "_count{command=\"" << command << "\"} " << histogram.count
+       << '\n';
+}
+
+} /* namespace */
+
+std::uint64_t Histogram::Snapshot::upper_bound(std::size_t bucket) {
+  if (bucket + 1 >= BUCKETS) {
+    return std::numeric_limits<std::uint64_t>::max();
+  }
+  return std::uint64_t{1} << bucket;
+}
+
+void Histogram::add(std::uint64_t value) {
+  const auto bucket =
+      std::min<std::size_t>(std::bit_width(value), BUCKETS - 1);
+  this->buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+  this->sum.fetch_add(value, std::memory_order_relaxed);
+  this->count.fetch_add(1, std::memory_order_relaxed);
+
+  auto current_max = this->max.load(std::memory_order_relaxed);
+  while (value > current_max &&
+         !this->max.compare_exchange_weak(current_max, value,
+                                          std::memory_order_relaxed)) {
+  }
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+  Snapshot snapshot;
+  snapshot.count = this->count.load(std::memory_order_relaxed);
+  snapshot.sum = this->sum.load(std::memory_order_relaxed);
+  snapshot.max = this->max.load(std::memory_order_relaxed);
+  for (std::size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+    snapshot.buckets[bucket] =
+        this->buckets[bucket].load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+void CommandMetrics::record(const std::string& command,
+                            const CommandSample& sample) {
+  auto& command_histograms = this->histograms(command);
+  command_histograms.serialize_time_ns.add(nanoseconds(sample.serialize_time));
+  command_histograms.round_trip_time_ns.add(
+      nanoseconds(sample.round_trip_time));
+  command_histograms.parse_time_ns.add(nanoseconds(sample.parse_time));
+  command_histograms.bytes_sent.add(sample.bytes_sent);
+  command_histograms.bytes_received.add(sample.bytes_received);
+}
+
+std::map<std::string, CommandMetrics::Snapshot> CommandMetrics::snapshot()
+    const {
+  std::map<std::string, Snapshot> snapshots;
+  const std::shared_lock<std::shared_mutex> lock(this->commands_mutex);
+  for (const auto& [command, command_histograms] : this->commands) {
+    snapshots.emplace(
+        command, Snapshot{command_histograms->serialize_time_ns.snapshot(),
+                          command_histograms->round_trip_time_ns.snapshot(),
+                          command_histograms->parse_time_ns.snapshot(),
+                          command_histograms->bytes_sent.snapshot(),
+                          command_histograms->bytes_received.snapshot()});
+  }
+  return snapshots;
+}
+
+nlohmann::json CommandMetrics::to_json() const {
+  nlohmann::json json_metrics = nlohmann::json::object();
+  for (const auto& [command, command_snapshot] : this->snapshot()) {
+    json_metrics[command] = {
+        {"serializeTimeNs", histogram_json(command_snapshot.serialize_time_ns)},
+        {"roundTripTimeNs",
+         histogram_json(command_snapshot.round_trip_time_ns)},
+        {"parseTimeNs", histogram_json(command_snapshot.parse_time_ns)},
+        {"bytesSent", histogram_json(command_snapshot.bytes_sent)},
+        {"bytesReceived", histogram_json(command_snapshot.bytes_received)}};
+  }
+  return json_metrics;
+}
+
+std::string CommandMetrics::to_prometheus() const {
+  constexpr double SECONDS_PER_NANOSECOND = 1e-9;
+  const auto snapshots = this->snapshot();
+
+  struct Family {
+    std::string name;
+    std::string help;
+    Histogram::Snapshot Snapshot::*histogram;
+    double scale;
+  };
+  const std::array<Family, 5> families{
+      {{"horiba_icl_command_serialize_seconds",
+        "Time to serialize an ICL command", &Snapshot::serialize_time_ns,
+        SECONDS_PER_NANOSECOND},
+       {"horiba_icl_command_round_trip_seconds",
+        "Time from sending an ICL command to receiving its response",
+        &Snapshot::round_trip_time_ns, SECONDS_PER_NANOSECOND},
+       {"horiba_icl_command_parse_seconds",
+        "Time to parse the response of an ICL command",
+        &Snapshot::parse_time_ns, SECONDS_PER_NANOSECOND},
+       {"horiba_icl_command_sent_bytes", "Size of an ICL command",
+        &Snapshot::bytes_sent, 1.0},
+       {"horiba_icl_command_received_bytes",
+        "Size of the response of an ICL command", &Snapshot::bytes_received,
+        1.0}}};
+
+  std::ostringstream text;
+  text << std::setprecision(9);
+  for (const auto& family : families) {
+    text << "# HELP " << family.name << ' ' << family.help << '\n';
+    text << "# TYPE " << family.name << " histogram\n";
+    for (const auto& [command, command_snapshot] : snapshots) {
+      write_prometheus_histogram(text, family.name, command,
+                                 command_snapshot.*family.histogram,
+                                 family.scale);
+    }
+  }
+  return text.str();
+}
+
+std::uint64_t CommandMetrics::next_id() {
+  static std::atomic<std::uint64_t> last_id{0};
+  return ++last_id;
+}
+
+CommandMetrics::Histograms& CommandMetrics::histograms(
+    const std::string& command) {
+  // histograms are never removed, so the pointers stay valid as long as the
+  // metrics they were found in, which the id tells apart. Only the metrics
+  // last recorded to on a thread are cached.
+  struct Cache {
+    std::uint64_t metrics_id = 0;
+    std::unordered_map<std::string, Histograms*> histograms;
+  };
+  thread_local Cache cache;
+  if (cache.metrics_id != this->id) {
+    cache.metrics_id = this->id;
+    cache.histograms.clear();
+  }
+  auto cached = cache.histograms.find(command);
+  if (cached != cache.histograms.end()) {
+    return *cached->second;
+  }
+
+  Histograms* command_histograms = nullptr;
+  {
+    const std::shared_lock<std::shared_mutex> lock(this->commands_mutex);
+    auto known_command = this->commands.find(command);
+    if (known_command != this->commands.end()) {
+      command_histograms = known_command->second.get();
+    }
+  }
+  if (command_histograms == nullptr) {
+    const std::unique_lock<std::shared_mutex> lock(this->commands_mutex);
+    auto& created_histograms = this->commands[command];
+    if (!created_histograms) {
+      created_histograms = std::make_unique<Histograms>();
+    }
+    command_histograms = created_histograms.get();
+  }
+  cache.histograms.emplace(command, command_histograms);
+  return *command_histograms;
+}
+
+} /* namespace horiba::communication */
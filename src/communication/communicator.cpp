@@ -0,0 +1,139 @@
+#include "horiba_cpp_sdk/communication/communicator.h"
+
+#include <chrono>
+#include <exception>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "horiba_cpp_sdk/communication/command.h"
+#include "horiba_cpp_sdk/communication/command_metrics.h"
+#include "horiba_cpp_sdk/communication/response.h"
+
+namespace horiba::communication {
+
+namespace {
+
+Communicator::ResponseHandler promise_handler(
+    const std::shared_ptr<std::promise<Response>>& promise) {
+  return [promise](std::exception_ptr error, Response response) {
+    if (error) {
+      promise->set_exception(error);
+      return;
+    }
+    promise->set_value(std::move(response));
+  };
+}
+
+}  // namespace
+
+RequestOptions RequestOptions::within(
+    std::chrono::steady_clock::duration timeout, std::stop_token stop_token) {
+  return RequestOptions{std::chrono::steady_clock::now() + timeout,
+                        std::move(stop_token)};
+}
+
+std::exception_ptr RequestOptions::failure(
+    const std::string& command_name) const {
+  if (this->stop_token.stop_requested()) {
+    return std::make_exception_ptr(
+        RequestCancelledError("request " + command_name + " cancelled"));
+  }
+  if (this->deadline && std::chrono::steady_clock::now() >= *this->deadline) {
+    return std::make_exception_ptr(RequestTimeoutError(
+        "no response to " + command_name + " before the deadline"));
+  }
+  return nullptr;
+}
+
+Response Communicator::request_with_response(const Command& command,
+                                             const RequestOptions& options) {
+  if (!options.deadline && !options.stop_token.stop_possible()) {
+    return this->request_with_response(command);
+  }
+  return this->request_with_response_async(command, options).get();
+}
+
+void Communicator::open_until(std::chrono::steady_clock::time_point deadline) {
+  if (std::chrono::steady_clock::now() >= deadline) {
+    throw std::runtime_error("deadline passed before opening");
+  }
+  this->open();
+}
+
+void Communicator::async_request(const Command& command,
+                                 ResponseHandler handler) {
+  std::exception_ptr error = nullptr;
+  Response response{command.id(), command.name(), {}, {}};
+  const auto sent_at = std::chrono::steady_clock::now();
+  try {
+    response = this->request_with_response(command);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  if (this->command_metrics && !error) {
+    CommandSample sample;
+    sample.round_trip_time = std::chrono::steady_clock::now() - sent_at;
+    this->command_metrics->record(command.name(), sample);
+  }
+  handler(error, std::move(response));
+}
+
+void Communicator::async_request(const Command& command,
+                                 const RequestOptions& options,
+                                 ResponseHandler handler) {
+  if (auto error = options.failure(command.name())) {
+    handler(error, Response{command.id(), command.name(), {}, {}});
+    return;
+  }
+  if (!options.deadline && !options.stop_token.stop_possible()) {
+    this->async_request(command, std::move(handler));
+    return;
+  }
+
+  // without a timer, a request can only be given up once its response arrived
+  this->async_request(
+      command, [options, id = command.id(), name = command.name(),
+                handler = std::move(handler)](std::exception_ptr error,
+                                              Response response) {
+        if (!error) {
+          if (auto late = options.failure(name)) {
+            handler(late, Response{id, name, {}, {}});
+            return;
+          }
+        }
+        handler(error, std::move(response));
+      });
+}
+
+std::future<Response> Communicator::request_with_response_async(
+    const Command& command) {
+  auto promise = std::make_shared<std::promise<Response>>();
+  auto future = promise->get_future();
+  this->async_request(command, promise_handler(promise));
+  return future;
+}
+
+std::future<Response> Communicator::request_with_response_async(
+    const Command& command, const RequestOptions& options) {
+  auto promise = std::make_shared<std::promise<Response>>();
+  auto future = promise->get_future();
+  this->async_request(command, options, promise_handler(promise));
+  return future;
+}
+
+void Communicator::set_metrics(std::shared_ptr<CommandMetrics> metrics) {
+  this->command_metrics = std::move(metrics);
+}
+
+const std::shared_ptr<CommandMetrics>& Communicator::metrics() const {
+  return this->command_metrics;
+}
+
+std::shared_ptr<common::BufferPool<double>> Communicator::buffer_pool() {
+  return nullptr;
+}
+
+} /* namespace horiba::communication */
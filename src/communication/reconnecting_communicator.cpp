@@ -0,0 +1,527 @@
+#include "horiba_cpp_sdk/communication/reconnecting_communicator.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "horiba_cpp_sdk/common/exponential_backoff.h"
+#include "horiba_cpp_sdk/communication/response.h"
+
+namespace horiba::communication {
+
+namespace {
+
+using json = nlohmann::json;
+
+// commands whose effect is lost when the ICL restarts
+constexpr std::array<std::string_view, 17> SESSION_COMMANDS = {
+    "icl_binMode",
+    "ccd_discover",
+    "mono_discover",
+    "ccd_open",
+    "mono_open",
+    "ccd_setAcqCount",
+    "ccd_setAcqFormat",
+    "ccd_setCleanCount",
+    "ccd_setExposureTime",
+    "ccd_setFitParams",
+    "ccd_setGain",
+    "ccd_setRoi",
+    "ccd_setSignalOut",
+    "ccd_setSpeed",
+    "ccd_setTimerResolution",
+    "ccd_setTriggerIn",
+    "ccd_setXAxisConversionType"};
+
+bool is_session_command(const Command& command) {
+  return std::find(SESSION_COMMANDS.begin(), SESSION_COMMANDS.end(),
+                   command.name()) != SESSION_COMMANDS.end();
+}
+
+std::string_view device_type(const Command& command) {
+  const std::string_view name = command.name();
+  return name.substr(0, name.find('_'));
+}
+
+json parameter(const Command& command, const char* name) {
+  const auto& parameters = command.json_parameters();
+  if (!parameters.is_object()) {
+    return nullptr;
+  }
+  return parameters.value(name, json());
+}
+
+bool same_device(const Command& first, const Command& second) {
+  return device_type(first) == device_type(second) &&
+         parameter(first, "index") == parameter(second, "index");
+}
+
+/**
+ * @brief Whether the second command replaces the state applied by the first
+ * one, e.g. the same setting of the same device.
+ */
+bool same_setting(const Command& first, const Command& second) {
+  return first.name() == second.name() && same_device(first, second) &&
+         parameter(first, "roiIndex") == parameter(second, "roiIndex");
+}
+
+bool is_close_command(const Command& command) {
+  return command.name() == "ccd_close" || command.name() == "mono_close";
+}
+
+}  // namespace
+
+/**
+ * @brief State of the communicator, kept alive by the requests in flight and
+ * the reconnect thread.
+ */
+struct ReconnectingCommunicator::State
+    : std::enable_shared_from_this<ReconnectingCommunicator::State> {
+  /**
+   * @brief A request waiting for the connection to be restored.
+   */
+  struct QueuedRequest {
+    Command command;
+    RequestOptions options;
+    ResponseHandler handler;
+    // wakes up the reconnect thread, which fails the request
+    std::unique_ptr<std::stop_callback<std::function<void()>>> cancellation;
+  };
+
+  State(std::shared_ptr<Communicator> communicator, ReconnectPolicy policy)
+      : communicator{std::move(communicator)}, policy{policy} {}
+
+  std::shared_ptr<Communicator> communicator;
+  ReconnectPolicy policy;
+  std::atomic<bool> opened{false};
+  std::atomic<std::uint64_t> reconnection_count{0};
+  std::mutex session_mutex;
+  std::vector<Command> session_commands;
+  // guards the queued requests and the flags of the reconnect thread
+  std::mutex queue_mutex;
+  std::condition_variable queue_changed;
+  std::deque<QueuedRequest> queued_requests;
+  // set from the first queued request until the queue is sent, so that the
+  // requests sent meanwhile are not sent before the queued ones
+  bool reconnecting = false;
+  bool stopping = false;
+
+  void request(const Command& command, const RequestOptions& options,
+               ResponseHandler handler);
+  void send(const Command& command, const RequestOptions& options,
+            ResponseHandler handler);
+  void run();
+  void reconnect();
+  bool wait_until_attempt(std::chrono::steady_clock::time_point attempt);
+  bool try_reconnect(std::chrono::steady_clock::time_point deadline);
+  std::optional<QueuedRequest> next_queued_request();
+  void fail_expired_requests();
+  void fail_queued_requests(const std::exception_ptr& error);
+  static void complete(QueuedRequest& queued, const std::exception_ptr& error);
+  std::exception_ptr retryable(const Command& command,
+                               std::exception_ptr error);
+  void remember(const Command& command, const Response& response);
+};
+
+ReconnectingCommunicator::ReconnectingCommunicator(
+    std::shared_ptr<Communicator> communicator, ReconnectPolicy policy)
+    : state{std::make_shared<State>(std::move(communicator), policy)} {}
+
+ReconnectingCommunicator::~ReconnectingCommunicator() {
+  if (this->is_open()) {
+    try {
+      this->close();
+    } catch (const std::exception& e) {
+      spdlog::error("[ReconnectingCommunicator] Failed to close: {}",
+                    e.what());
+    }
+  }
+}
+
+void ReconnectingCommunicator::open() {
+  this->open_until(std::chrono::steady_clock::time_point::max());
+}
+
+void ReconnectingCommunicator::open_until(
+    std::chrono::steady_clock::time_point deadline) {
+  if (this->is_open()) {
+    spdlog::error("[ReconnectingCommunicator] Failed to open: already opened");
+    throw std::runtime_error("communicator is already open");
+  }
+  this->state->communicator->open_until(deadline);
+  {
+    const std::lock_guard<std::mutex> lock(this->state->queue_mutex);
+    this->state->stopping = false;
+    this->state->reconnecting = false;
+  }
+  this->state->opened.store(true);
+  this->reconnect_thread =
+      std::thread([state = this->state] { state->run(); });
+}
+
+void ReconnectingCommunicator::close() {
+  this->state->opened.store(false);
+  {
+    const std::lock_guard<std::mutex> lock(this->state->queue_mutex);
+    this->state->stopping = true;
+  }
+  this->state->queue_changed.notify_all();
+  if (this->reconnect_thread.joinable()) {
+    // the handler of a queued request failed by the reconnect thread may
+    // close the communicator, the thread ends on its own then
+    if (this->reconnect_thread.get_id() == std::this_thread::get_id()) {
+      this->reconnect_thread.detach();
+    } else {
+      this->reconnect_thread.join();
+    }
+  }
+  this->state->fail_queued_requests(
+      std::make_exception_ptr(std::runtime_error("communicator closed")));
+  {
+    const std::lock_guard<std::mutex> lock(this->state->session_mutex);
+    this->state->session_commands.clear();
+  }
+  // the connection may be lost already
+  if (this->state->communicator->is_open()) {
+    this->state->communicator->close();
+  }
+}
+
+bool ReconnectingCommunicator::is_open() { return this->state->opened.load(); }
+
+Response ReconnectingCommunicator::request_with_response(
+    const Command& command) {
+  return this->request_with_response_async(command).get();
+}
+
+void ReconnectingCommunicator::async_request(const Command& command,
+                                             ResponseHandler handler) {
+  this->state->request(command, RequestOptions{}, std::move(handler));
+}
+
+void ReconnectingCommunicator::async_request(const Command& command,
+                                             const RequestOptions& options,
+                                             ResponseHandler handler) {
+  this->state->request(command, options, std::move(handler));
+}
+
+std::shared_ptr<common::BufferPool<double>>
+ReconnectingCommunicator::buffer_pool() {
+  return this->state->communicator->buffer_pool();
+}
+
+std::uint64_t ReconnectingCommunicator::reconnections() const {
+  return this->state->reconnection_count.load();
+}
+
+void ReconnectingCommunicator::State::request(const Command& command,
+                                              const RequestOptions& options,
+                                              ResponseHandler handler) {
+  if (!this->opened.load()) {
+    handler(std::make_exception_ptr(
+                std::runtime_error("communicator is not open")),
+            Response{command.id(), command.name(), {}, {}});
+    return;
+  }
+  if (auto error = options.failure(command.name())) {
+    handler(error, Response{command.id(), command.name(), {}, {}});
+    return;
+  }
+
+  bool connected = false;
+  {
+    const std::lock_guard<std::mutex> lock(this->queue_mutex);
+    connected = !this->reconnecting && this->communicator->is_open();
+  }
+  if (connected) {
+    this->send(command, options, std::move(handler));
+    return;
+  }
+
+  QueuedRequest queued{command, options, std::move(handler), nullptr};
+  if (options.stop_token.stop_possible()) {
+    // created without the lock, the callback runs right away if a stop was
+    // requested since the check above
+    queued.cancellation =
+        std::make_unique<std::stop_callback<std::function<void()>>>(
+            options.stop_token, [this] {
+              { const std::lock_guard<std::mutex> lock(this->queue_mutex); }
+              this->queue_changed.notify_all();
+            });
+  }
+  {
+    const std::lock_guard<std::mutex> lock(this->queue_mutex);
+    this->queued_requests.push_back(std::move(queued));
+    this->reconnecting = true;
+  }
+  this->queue_changed.notify_all();
+}
+
+void ReconnectingCommunicator::State::send(const Command& command,
+                                           const RequestOptions& options,
+                                           ResponseHandler handler) {
+  try {
+    this->communicator->async_request(
+        command, options,
+        [self = this->shared_from_this(), command, handler](
+            std::exception_ptr error, Response response) {
+          if (error) {
+            handler(self->retryable(command, error), std::move(response));
+            return;
+          }
+          self->remember(command, response);
+          handler(nullptr, std::move(response));
+        });
+  } catch (...) {
+    // the connection got lost since it was checked, the request was not sent
+    handler(this->retryable(command, std::current_exception()),
+            Response{command.id(), command.name(), {}, {}});
+  }
+}
+
+void ReconnectingCommunicator::State::run() {
+  std::unique_lock<std::mutex> lock(this->queue_mutex);
+  while (true) {
+    this->queue_changed.wait(
+        lock, [this] { return this->stopping || this->reconnecting; });
+    if (this->stopping) {
+      return;
+    }
+    lock.unlock();
+    this->reconnect();
+    lock.lock();
+  }
+}
+
+void ReconnectingCommunicator::State::reconnect() {
+  const bool was_connected = this->communicator->is_open();
+  if (!was_connected) {
+    spdlog::warn("[ReconnectingCommunicator] Connection lost, reconnecting");
+  }
+  const auto start = std::chrono::steady_clock::now();
+  const auto deadline = start + this->policy.timeout;
+  common::ExponentialBackoff backoff{this->policy.initial_delay,
+                                     this->policy.max_delay};
+  auto next_attempt = start;
+  bool connected = was_connected;
+  while (!connected) {
+    // the last attempt is made at the deadline, never after
+    if (!this->wait_until_attempt(std::min(next_attempt, deadline))) {
+      return;
+    }
+    connected = this->try_reconnect(deadline);
+    const auto now = std::chrono::steady_clock::now();
+    if (!connected && now >= deadline) {
+      spdlog::error(
+          "[ReconnectingCommunicator] Failed to reconnect within {} ms",
+          this->policy.timeout.count());
+      this->fail_queued_requests(std::make_exception_ptr(
+          std::runtime_error("cannot reconnect to the ICL")));
+      return;
+    }
+    next_attempt = now + backoff.next_delay();
+  }
+  if (!was_connected) {
+    spdlog::info("[ReconnectingCommunicator] Reconnected in {} ms",
+                 std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::steady_clock::now() - start)
+                     .count());
+  }
+
+  while (auto queued = this->next_queued_request()) {
+    queued->cancellation.reset();
+    if (auto error = queued->options.failure(queued->command.name())) {
+      complete(*queued, error);
+      continue;
+    }
+    this->send(queued->command, queued->options, std::move(queued->handler));
+  }
+}
+
+bool ReconnectingCommunicator::State::wait_until_attempt(
+    std::chrono::steady_clock::time_point attempt) {
+  while (true) {
+    this->fail_expired_requests();
+    std::unique_lock<std::mutex> lock(this->queue_mutex);
+    if (this->stopping) {
+      return false;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= attempt) {
+      return true;
+    }
+    // woken up by the first deadline, a cancellation or close()
+    auto wake_up = attempt;
+    bool expired = false;
+    for (const auto& queued : this->queued_requests) {
+      expired = expired || queued.options.stop_token.stop_requested();
+      if (queued.options.deadline) {
+        wake_up = std::min(wake_up, *queued.options.deadline);
+      }
+    }
+    if (!expired && wake_up > now) {
+      this->queue_changed.wait_until(lock, wake_up);
+    }
+  }
+}
+
+bool ReconnectingCommunicator::State::try_reconnect(
+    std::chrono::steady_clock::time_point deadline) {
+  try {
+    this->communicator->open_until(deadline);
+  } catch (const std::exception& e) {
+    spdlog::debug("[ReconnectingCommunicator] Failed to reconnect: {}",
+                  e.what());
+    return false;
+  }
+
+  std::vector<Command> commands;
+  {
+    const std::lock_guard<std::mutex> lock(this->session_mutex);
+    commands = this->session_commands;
+  }
+  try {
+    for (const auto& session_command : commands) {
+      const auto response = this->communicator->request_with_response(
+          Command(session_command.name(), session_command.json_parameters()),
+          RequestOptions{deadline, {}});
+      for (const auto& error : response.errors()) {
+        spdlog::warn("[ReconnectingCommunicator] Failed to restore {}: {}",
+                     session_command.name(), error);
+      }
+    }
+  } catch (const std::exception& e) {
+    spdlog::debug("[ReconnectingCommunicator] Failed to restore session: {}",
+                  e.what());
+    // the next attempt restores the session on a new connection
+    if (this->communicator->is_open()) {
+      this->communicator->close();
+    }
+    return false;
+  }
+
+  this->reconnection_count++;
+  return true;
+}
+
+std::optional<ReconnectingCommunicator::State::QueuedRequest>
+ReconnectingCommunicator::State::next_queued_request() {
+  const std::lock_guard<std::mutex> lock(this->queue_mutex);
+  if (this->queued_requests.empty()) {
+    this->reconnecting = false;
+    return std::nullopt;
+  }
+  auto queued = std::move(this->queued_requests.front());
+  this->queued_requests.pop_front();
+  return queued;
+}
+
+void ReconnectingCommunicator::State::fail_expired_requests() {
+  std::vector<std::pair<QueuedRequest, std::exception_ptr>> expired;
+  {
+    const std::lock_guard<std::mutex> lock(this->queue_mutex);
+    auto& queue = this->queued_requests;
+    for (auto queued = queue.begin(); queued != queue.end();) {
+      if (auto error = queued->options.failure(queued->command.name())) {
+        expired.emplace_back(std::move(*queued), std::move(error));
+        queued = queue.erase(queued);
+      } else {
+        ++queued;
+      }
+    }
+  }
+  // the cancellations are destroyed without the lock their callback takes
+  for (auto& [queued, error] : expired) {
+    complete(queued, error);
+  }
+}
+
+void ReconnectingCommunicator::State::fail_queued_requests(
+    const std::exception_ptr& error) {
+  std::deque<QueuedRequest> failed;
+  {
+    const std::lock_guard<std::mutex> lock(this->queue_mutex);
+    failed.swap(this->queued_requests);
+    this->reconnecting = false;
+  }
+  for (auto& queued : failed) {
+    complete(queued, error);
+  }
+}
+
+void ReconnectingCommunicator::State::complete(
+    QueuedRequest& queued, const std::exception_ptr& error) {
+  queued.cancellation.reset();
+  try {
+    queued.handler(error, Response{queued.command.id(),
+                                   queued.command.name(), {}, {}});
+  } catch (const std::exception& e) {
+    spdlog::error("[ReconnectingCommunicator] Response handler failed: {}",
+                  e.what());
+  }
+}
+
+std::exception_ptr ReconnectingCommunicator::State::retryable(
+    const Command& command, std::exception_ptr error) {
+  try {
+    std::rethrow_exception(error);
+  } catch (const RequestTimeoutError&) {
+    return error;
+  } catch (const RequestCancelledError&) {
+    return error;
+  } catch (const std::exception& e) {
+    // requests failing because of close() are not retried
+    if (this->communicator->is_open() || !this->opened.load()) {
+      return error;
+    }
+    return std::make_exception_ptr(RetryableRequestError(
+        command.name() + " lost with the connection to the ICL: " + e.what()));
+  } catch (...) {
+    return error;
+  }
+}
+
+void ReconnectingCommunicator::State::remember(const Command& command,
+                                        const Response& response) {
+  const bool close_command = is_close_command(command);
+  if (!response.errors().empty() ||
+      (!close_command && !is_session_command(command))) {
+    return;
+  }
+
+  const std::lock_guard<std::mutex> lock(this->session_mutex);
+  auto& commands = this->session_commands;
+  if (close_command) {
+    std::erase_if(commands, [&command](const Command& session_command) {
+      return same_device(session_command, command);
+    });
+    return;
+  }
+  const auto setting = std::find_if(
+      commands.begin(), commands.end(),
+      [&command](const Command& session_command) {
+        return same_setting(session_command, command);
+      });
+  if (setting != commands.end()) {
+    *setting = command;
+    return;
+  }
+  commands.push_back(command);
+}
+
+} /* namespace horiba::communication */
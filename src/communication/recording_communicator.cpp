@@ -0,0 +1,289 @@
+#include "horiba_cpp_sdk/communication/recording_communicator.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+#include "horiba_cpp_sdk/communication/command.h"
+#include "horiba_cpp_sdk/communication/response.h"
+
+namespace horiba::communication {
+
+namespace {
+
+using json = nlohmann::json;
+
+constexpr auto RECORDING_FORMAT = "horiba-icl-recording";
+constexpr int RECORDING_VERSION = 1;
+// largest double below which all integers are exactly representable
+constexpr double MAX_EXACT_INTEGER = 9007199254740992.0;
+
+json block_to_json(const BinaryBlock& block) {
+  // acquisitions are mostly counts, CBOR encodes them as integers in 1 to 5
+  // bytes instead of 9 for a double
+  json values = json::array();
+  values.get_ref<json::array_t&>().reserve(block.values.size());
+  for (const double value : block.values) {
+    if (std::trunc(value) == value && std::fabs(value) < MAX_EXACT_INTEGER) {
+      values.push_back(static_cast<std::int64_t>(value));
+    } else {
+      values.push_back(value);
+    }
+  }
+  return {{"acquisition", block.acquisition_index},
+          {"roi", block.roi_index},
+          {"axis", static_cast<int>(block.axis)},
+          {"type", static_cast<int>(block.element_type)},
+          {"rows", block.rows},
+          {"values", std::move(values)}};
+}
+
+BinaryBlock block_from_json(const json& json_block) {
+  BinaryBlock block;
+  block.acquisition_index = json_block.at("acquisition").get<int>();
+  block.roi_index = json_block.at("roi").get<int>();
+  block.axis =
+      static_cast<BinaryBlock::Axis>(json_block.at("axis").get<int>());
+  block.element_type =
+      static_cast<BinaryBlock::ElementType>(json_block.at("type").get<int>());
+  block.rows = json_block.at("rows").get<int>();
+  const auto& values = json_block.at("values");
+  block.values.reserve(values.size());
+  for (const auto& value : values) {
+    block.values.push_back(value.get<double>());
+  }
+  return block;
+}
+
+RecordedExchange exchange_from_json(const json& record) {
+  RecordedExchange exchange;
+  exchange.sent_at =
+      std::chrono::microseconds(record.at("sentAt").get<std::int64_t>());
+  exchange.round_trip_time =
+      std::chrono::microseconds(record.at("roundTrip").get<std::int64_t>());
+  exchange.command = record.at("command").get<std::string>();
+  exchange.parameters = record.at("parameters");
+  exchange.results = record.at("results");
+  exchange.errors = record.at("errors").get<std::vector<std::string>>();
+  for (const auto& json_block : record.at("blocks")) {
+    exchange.binary_blocks.push_back(block_from_json(json_block));
+  }
+  exchange.failure = record.value("failure", "");
+  return exchange;
+}
+
+}  // namespace
+
+RecordingCommunicator::RecordingCommunicator(
+    std::shared_ptr<Communicator> communicator,
+    const std::filesystem::path& recording_file) noexcept(false)
+    : communicator{std::move(communicator)},
+      recording_start{std::chrono::steady_clock::now()},
+      recording{recording_file, std::ios::binary | std::ios::app} {
+  if (!this->recording) {
+    spdlog::error("[RecordingCommunicator] Failed to open recording {}",
+                  recording_file.string());
+    throw std::runtime_error("cannot open recording " +
+                             recording_file.string());
+  }
+
+  const auto started_at = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::system_clock::now().time_since_epoch());
+  this->write_record({{"format", RECORDING_FORMAT},
+                      {"version", RECORDING_VERSION},
+                      {"startedAt", started_at.count()}});
+  spdlog::debug("[RecordingCommunicator] Recording to {}",
+                recording_file.string());
+}
+
+void RecordingCommunicator::open() { this->communicator->open(); }
+
+void RecordingCommunicator::open_until(
+    std::chrono::steady_clock::time_point deadline) {
+  this->communicator->open_until(deadline);
+}
+
+void RecordingCommunicator::close() { this->communicator->close(); }
+
+bool RecordingCommunicator::is_open() { return this->communicator->is_open(); }
+
+Response RecordingCommunicator::request_with_response(const Command& command) {
+  const auto sent_at = std::chrono::steady_clock::now();
+  std::optional<Response> response;
+  try {
+    response = this->communicator->request_with_response(command);
+  } catch (...) {
+    this->record(command, sent_at, std::current_exception(),
+                 Response{command.id(), command.name(), {}, {}});
+    throw;
+  }
+  this->record(command, sent_at, nullptr, *response);
+  return std::move(*response);
+}
+
+void RecordingCommunicator::async_request(const Command& command,
+                                          ResponseHandler handler) {
+  this->async_request(command, RequestOptions{}, std::move(handler));
+}
+
+void RecordingCommunicator::async_request(const Command& command,
+                                          const RequestOptions& options,
+                                          ResponseHandler handler) {
+  const auto sent_at = std::chrono::steady_clock::now();
+  this->communicator->async_request(
+      command, options,
+      [this, command, sent_at, handler = std::move(handler)](
+          std::exception_ptr error, Response response) {
+        try {
+          this->record(command, sent_at, error, response);
+        } catch (const std::exception& e) {
+          spdlog::error("[RecordingCommunicator] Failed to record {}: {}",
+                        command.name(), e.what());
+        }
+        handler(std::move(error), std::move(response));
+      });
+}
+
+std::shared_ptr<common::BufferPool<double>>
+RecordingCommunicator::buffer_pool() {
+  return this->communicator->buffer_pool();
+}
+
+void RecordingCommunicator::record(
+    const Command& command, std::chrono::steady_clock::time_point sent_at,
+    const std::exception_ptr& error, const Response& response) {
+  const auto received_at = std::chrono::steady_clock::now();
+  json record = {
+      {"sentAt", std::chrono::duration_cast<std::chrono::microseconds>(
+                     sent_at - this->recording_start)
+                     .count()},
+      {"roundTrip", std::chrono::duration_cast<std::chrono::microseconds>(
+                        received_at - sent_at)
+                        .count()},
+      {"command", command.name()},
+      {"parameters", command.json_parameters()},
+      {"results", response.json_results()},
+      {"errors", response.errors()},
+      {"blocks", json::array()}};
+  for (const auto& block : response.binary_blocks()) {
+    record["blocks"].push_back(block_to_json(block));
+  }
+  if (error) {
+    try {
+      std::rethrow_exception(error);
+    } catch (const std::exception& e) {
+      record["failure"] = e.what();
+    } catch (...) {
+      record["failure"] = "unknown error";
+    }
+  }
+  this->write_record(record);
+}
+
+void RecordingCommunicator::write_record(const json& record) {
+  const auto cbor = json::to_cbor(record);
+  const auto size = static_cast<std::uint32_t>(cbor.size());
+  const std::array<char, 4> size_bytes{
+      static_cast<char>(size & 0xFFU), static_cast<char>((size >> 8U) & 0xFFU),
+      static_cast<char>((size >> 16U) & 0xFFU),
+      static_cast<char>((size >> 24U) & 0xFFU)};
+
+  std::lock_guard<std::mutex> lock(this->recording_mutex);
+  this->recording.write(size_bytes.data(), size_bytes.size());
+  this->recording.write(reinterpret_cast<const char*>(cbor.data()),
+                        static_cast<std::streamsize>(cbor.size()));
+  this->recording.flush();
+  if (!this->recording) {
+    throw std::runtime_error("cannot write to recording");
+  }
+}
+
+std::vector<RecordedExchange> RecordingCommunicator::read_recording(
+    const std::filesystem::path& recording_file) noexcept(false) {
+  std::ifstream recording{recording_file, std::ios::binary};
+  if (!recording) {
+    throw std::runtime_error("cannot open recording " +
+                             recording_file.string());
+  }
+
+  std::vector<RecordedExchange> exchanges;
+  bool first_record = true;
+  std::int64_t first_started_at = 0;
+  std::chrono::microseconds session_start{0};
+  std::size_t session = 0;
+  bool truncated = false;
+  std::vector<std::uint8_t> cbor;
+  while (true) {
+    std::array<unsigned char, 4> size_bytes{};
+    recording.read(reinterpret_cast<char*>(size_bytes.data()),
+                   size_bytes.size());
+    if (recording.gcount() == 0) {
+      break;
+    }
+    if (recording.gcount() != static_cast<std::streamsize>(size_bytes.size())) {
+      truncated = true;
+      break;
+    }
+    const std::uint32_t size = size_bytes[0] | (size_bytes[1] << 8U) |
+                               (size_bytes[2] << 16U) | (size_bytes[3] << 24U);
+    cbor.resize(size);
+    recording.read(reinterpret_cast<char*>(cbor.data()), size);
+    if (recording.gcount() != static_cast<std::streamsize>(size)) {
+      truncated = true;
+      break;
+    }
+
+    try {
+      const auto record = json::from_cbor(cbor);
+      if (record.contains("format")) {
+        if (record.at("format") != RECORDING_FORMAT ||
+            record.at("version").get<int>() > RECORDING_VERSION) {
+          throw std::runtime_error("unsupported recording format");
+        }
+        // the send times count from the start of their session
+        const auto started_at = record.at("startedAt").get<std::int64_t>();
+        if (first_record) {
+          first_started_at = started_at;
+        } else {
+          ++session;
+        }
+        session_start = std::chrono::microseconds(
+            std::max<std::int64_t>(started_at - first_started_at, 0));
+        first_record = false;
+        continue;
+      }
+      if (first_record) {
+        throw std::runtime_error("missing recording header");
+      }
+      auto exchange = exchange_from_json(record);
+      exchange.sent_at += session_start;
+      exchange.session = session;
+      exchanges.push_back(std::move(exchange));
+    } catch (const json::exception& e) {
+      throw std::runtime_error(recording_file.string() +
+                               " is not a recording: " + e.what());
+    } catch (const std::runtime_error& e) {
+      throw std::runtime_error(recording_file.string() +
+                               " is not a recording: " + e.what());
+    }
+  }
+
+  if (truncated) {
+    if (first_record) {
+      throw std::runtime_error(recording_file.string() + " is not a recording");
+    }
+    spdlog::warn("[RecordingCommunicator] Ignoring truncated record in {}",
+                 recording_file.string());
+  }
+  return exchanges;
+}
+
+} /* namespace horiba::communication */
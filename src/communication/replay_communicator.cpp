@@ -0,0 +1,190 @@
+#include "horiba_cpp_sdk/communication/replay_communicator.h"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "horiba_cpp_sdk/communication/command.h"
+
+namespace horiba::communication {
+
+namespace {
+
+// orders the deliveries as a min heap on their due time
+bool delivered_later(const auto& lhs, const auto& rhs) {
+  return lhs.due != rhs.due ? lhs.due > rhs.due : lhs.sequence > rhs.sequence;
+}
+
+}  // namespace
+
+ReplayCommunicator::ReplayCommunicator(
+    const std::filesystem::path& recording_file,
+    double time_scale) noexcept(false)
+    : ReplayCommunicator(RecordingCommunicator::read_recording(recording_file),
+                         time_scale) {}
+
+ReplayCommunicator::ReplayCommunicator(std::vector<RecordedExchange> exchanges,
+                                       double time_scale)
+    : time_scale{std::max(time_scale, 0.0)}, remaining{exchanges.size()} {
+  for (auto& exchange : exchanges) {
+    auto name = exchange.command;
+    this->exchanges[name].push_back(std::move(exchange));
+  }
+  if (this->time_scale > 0.0) {
+    this->delivery_thread =
+        std::jthread([this](const std::stop_token& stop_token) {
+          this->deliver(stop_token);
+        });
+  }
+}
+
+ReplayCommunicator::~ReplayCommunicator() {
+  if (this->delivery_thread.joinable()) {
+    this->delivery_thread.request_stop();
+    this->delivery_thread.join();
+  }
+}
+
+void ReplayCommunicator::open() {
+  if (this->opened.exchange(true)) {
+    spdlog::error("[ReplayCommunicator] Failed to open: already opened");
+    throw std::runtime_error("replay is already open");
+  }
+}
+
+void ReplayCommunicator::close() {
+  if (!this->opened.exchange(false)) {
+    spdlog::error("[ReplayCommunicator] Failed to close: not open");
+    throw std::runtime_error("replay is not open");
+  }
+}
+
+bool ReplayCommunicator::is_open() { return this->opened; }
+
+Response ReplayCommunicator::request_with_response(const Command& command) {
+  auto exchange = this->take_exchange(command);
+  std::this_thread::sleep_for(this->scaled(exchange.round_trip_time));
+  if (!exchange.failure.empty()) {
+    throw std::runtime_error(exchange.failure);
+  }
+  return Response{
+      command.id(), command.name(),
+      std::move(exchange.results.get_ref<nlohmann::json::object_t&>()),
+      std::move(exchange.errors), std::move(exchange.binary_blocks)};
+}
+
+void ReplayCommunicator::async_request(const Command& command,
+                                       ResponseHandler handler) {
+  std::exception_ptr error = nullptr;
+  Response response{command.id(), command.name(), {}, {}};
+  auto delay = std::chrono::steady_clock::duration::zero();
+  try {
+    auto exchange = this->take_exchange(command);
+    delay = this->scaled(exchange.round_trip_time);
+    if (!exchange.failure.empty()) {
+      throw std::runtime_error(exchange.failure);
+    }
+    response = Response{
+        command.id(), command.name(),
+        std::move(exchange.results.get_ref<nlohmann::json::object_t&>()),
+        std::move(exchange.errors), std::move(exchange.binary_blocks)};
+  } catch (...) {
+    error = std::current_exception();
+  }
+
+  if (!this->delivery_thread.joinable()) {
+    handler(error, std::move(response));
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(this->deliveries_mutex);
+    this->deliveries.push_back(
+        Delivery{std::chrono::steady_clock::now() + delay,
+                 this->next_sequence++, std::move(handler), error,
+                 std::move(response)});
+    std::push_heap(this->deliveries.begin(), this->deliveries.end(),
+                   delivered_later<Delivery, Delivery>);
+  }
+  this->deliveries_changed.notify_one();
+}
+
+std::size_t ReplayCommunicator::remaining_exchanges() const {
+  std::lock_guard<std::mutex> lock(this->exchanges_mutex);
+  return this->remaining;
+}
+
+RecordedExchange ReplayCommunicator::take_exchange(const Command& command) {
+  if (!this->opened) {
+    spdlog::error("[ReplayCommunicator] Cannot send request: not open");
+    throw std::runtime_error("cannot send request if replay is not open");
+  }
+
+  std::lock_guard<std::mutex> lock(this->exchanges_mutex);
+  auto recorded = this->exchanges.find(command.name());
+  if (recorded == this->exchanges.end() || recorded->second.empty()) {
+    spdlog::error("[ReplayCommunicator] No recorded response for {}",
+                  command.name());
+    throw std::runtime_error("no recorded response for " + command.name());
+  }
+
+  auto& candidates = recorded->second;
+  auto match = std::find_if(
+      candidates.begin(), candidates.end(), [&command](const auto& exchange) {
+        return exchange.parameters == command.json_parameters();
+      });
+  if (match == candidates.end()) {
+    // parameters such as timestamps can differ between the recording and
+    // the replay, fall back to the next response of the same command
+    match = candidates.begin();
+  }
+  auto exchange = std::move(*match);
+  candidates.erase(match);
+  this->remaining--;
+  return exchange;
+}
+
+std::chrono::steady_clock::duration ReplayCommunicator::scaled(
+    std::chrono::microseconds round_trip_time) const {
+  return std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double, std::micro>(
+          static_cast<double>(round_trip_time.count()) * this->time_scale));
+}
+
+void ReplayCommunicator::deliver(const std::stop_token& stop_token) {
+  std::unique_lock<std::mutex> lock(this->deliveries_mutex);
+  while (!stop_token.stop_requested()) {
+    if (this->deliveries.empty()) {
+      this->deliveries_changed.wait(lock, stop_token, [this] {
+        return !this->deliveries.empty();
+      });
+      continue;
+    }
+
+    const auto due = this->deliveries.front().due;
+    if (std::chrono::steady_clock::now() < due) {
+      // wakes up when a delivery due earlier is queued
+      this->deliveries_changed.wait_until(lock, stop_token, due, [this, due] {
+        return this->deliveries.front().due < due;
+      });
+      continue;
+    }
+
+    std::pop_heap(this->deliveries.begin(), this->deliveries.end(),
+                  delivered_later<Delivery, Delivery>);
+    auto delivery = std::move(this->deliveries.back());
+    this->deliveries.pop_back();
+    lock.unlock();
+    try {
+      delivery.handler(delivery.error, std::move(delivery.response));
+    } catch (const std::exception& e) {
+      spdlog::error("[ReplayCommunicator] Response handler failed: {}",
+                    e.what());
+    }
+    lock.lock();
+  }
+}
+
+} /* namespace horiba::communication */
@@ -8,13 +8,30 @@
 namespace horiba::communication {
 Response::Response(unsigned long long int id, std::string command,
                    nlohmann::json::object_t results,
-                   std::vector<std::string> errors)
-    : id{id},
+                   std::vector<std::string> errors,
+                   std::vector<BinaryBlock> binary_blocks)
+    : command_id{id},
       command{std::move(command)},
-      results{std::move(results)},
-      icl_errors{std::move(errors)} {}
+      // parentheses, braces would wrap the object into an array
+      results(std::move(results)),
+      icl_errors{std::move(errors)},
+      numeric_blocks{std::move(binary_blocks)} {}
 
-nlohmann::json Response::json_results() const { return this->results; }
+const nlohmann::json& Response::json_results() const { return this->results; }
 
-std::vector<std::string> Response::errors() const { return this->icl_errors; }
+const std::vector<std::string>& Response::errors() const {
+  return this->icl_errors;
+}
+
+unsigned long long int Response::id() const { return this->command_id; }
+
+const std::string& Response::command_name() const { return this->command; }
+
+const std::vector<BinaryBlock>& Response::binary_blocks() const {
+  return this->numeric_blocks;
+}
+
+std::vector<BinaryBlock> Response::take_binary_blocks() {
+  return std::exchange(this->numeric_blocks, {});
+}
 } /* namespace horiba::communication */
@@ -0,0 +1,310 @@
+#include "horiba_cpp_sdk/communication/response_parser.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace horiba::communication {
+
+namespace {
+
+using json = nlohmann::json;
+
+/**
+ * @brief SAX handler building the json document of a response, except for the
+ * numeric data of the acquisitions that is appended to binary blocks.
+ *
+ * Returns false as soon as the numeric data does not have the layout of an
+ * acquisition, rows of numbers for "xData" and "yData" and pairs of numbers
+ * for "xyData", so that the response can be parsed again as a document.
+ */
+class NumericDataHandler {
+ public:
+  using number_integer_t = json::number_integer_t;
+  using number_unsigned_t = json::number_unsigned_t;
+  using number_float_t = json::number_float_t;
+  using string_t = json::string_t;
+  using binary_t = json::binary_t;
+
+  NumericDataHandler(std::vector<BinaryBlock>& binary_blocks,
+                     common::BufferPool<double>* buffers)
+      : binary_blocks{binary_blocks}, buffers{buffers} {}
+
+  bool null() { return this->handle_value(nullptr); }
+
+  bool boolean(bool value) { return this->handle_value(value); }
+
+  bool number_integer(number_integer_t value) {
+    if (this->capture != Capture::NONE) {
+      return this->capture_number(static_cast<double>(value));
+    }
+    return this->handle_value(value);
+  }
+
+  bool number_unsigned(number_unsigned_t value) {
+    if (this->capture != Capture::NONE) {
+      return this->capture_number(static_cast<double>(value));
+    }
+    return this->handle_value(value);
+  }
+
+  bool number_float(number_float_t value, const string_t& /*raw_value*/) {
+    if (this->capture != Capture::NONE) {
+      return this->capture_number(value);
+    }
+    return this->handle_value(value);
+  }
+
+  bool string(string_t& value) { return this->handle_value(std::move(value)); }
+
+  bool binary(binary_t& value) { return this->handle_value(std::move(value)); }
+
+  bool start_object(std::size_t /*elements*/) {
+    if (!this->handle_value(json::object())) {
+      return false;
+    }
+    this->object_first_blocks.push_back(this->binary_blocks.size());
+    return true;
+  }
+
+  bool key(string_t& key) {
+    if (key == "xData") {
+      this->pending_capture = Capture::X_ROWS;
+    } else if (key == "yData") {
+      this->pending_capture = Capture::Y_ROWS;
+    } else if (key == "xyData") {
+      this->pending_capture = Capture::PAIRS;
+    }
+    this->current_key = std::move(key);
+    return true;
+  }
+
+  bool end_object() {
+    const auto& object = *this->containers.back();
+    const auto first_block = this->object_first_blocks.back();
+    if (const auto roi_index = object.find("roiIndex");
+        roi_index != object.end() && roi_index->is_number_integer()) {
+      this->set_roi_index(first_block, roi_index->get<int>());
+    }
+    if (const auto acquisition_index = object.find("acqIndex");
+        acquisition_index != object.end() &&
+        acquisition_index->is_number_integer()) {
+      this->set_acquisition_index(first_block, acquisition_index->get<int>());
+    }
+    this->object_first_blocks.pop_back();
+    this->containers.pop_back();
+    return true;
+  }
+
+  bool start_array(std::size_t /*elements*/) {
+    if (this->capture != Capture::NONE) {
+      return this->start_nested_array();
+    }
+    if (this->pending_capture != Capture::NONE) {
+      this->start_capture();
+      return true;
+    }
+    return this->handle_value(json::array());
+  }
+
+  bool end_array() {
+    if (this->capture != Capture::NONE) {
+      if (this->capture == Capture::PAIRS && this->capture_depth == 2 &&
+          this->pair_position != 2) {
+        return false;
+      }
+      if (--this->capture_depth == 0) {
+        this->capture = Capture::NONE;
+      }
+      return true;
+    }
+    this->containers.pop_back();
+    return true;
+  }
+
+  template <class Exception>
+  bool parse_error(std::size_t /*position*/, const std::string& /*last_token*/,
+                   const Exception& exception) {
+    throw exception;
+  }
+
+  /**
+   * @brief Whether every block got the indices of its acquisition and roi.
+   */
+  [[nodiscard]] bool blocks_complete(std::size_t first_block) const {
+    for (std::size_t i = first_block; i < this->binary_blocks.size(); ++i) {
+      if (this->binary_blocks[i].acquisition_index < 0 ||
+          this->binary_blocks[i].roi_index < 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  json result;
+
+ private:
+  enum class Capture : std::uint8_t { NONE, X_ROWS, Y_ROWS, PAIRS };
+
+  std::vector<BinaryBlock>& binary_blocks;
+  common::BufferPool<double>* buffers;
+  std::vector<json*> containers;
+  std::vector<std::size_t> object_first_blocks;
+  string_t current_key;
+
+  Capture pending_capture = Capture::NONE;
+  Capture capture = Capture::NONE;
+  int capture_depth = 0;
+  int pair_position = 0;
+
+  template <typename Value>
+  bool handle_value(Value&& value) {
+    if (this->capture != Capture::NONE) {
+      return false;
+    }
+    this->pending_capture = Capture::NONE;
+
+    json* added = nullptr;
+    if (this->containers.empty()) {
+      this->result = json(std::forward<Value>(value));
+      added = &this->result;
+    } else if (this->containers.back()->is_array()) {
+      auto& array = this->containers.back()->get_ref<json::array_t&>();
+      array.emplace_back(std::forward<Value>(value));
+      added = &array.back();
+    } else {
+      auto& object = this->containers.back()->get_ref<json::object_t&>();
+      auto& slot = object[this->current_key];
+      slot = json(std::forward<Value>(value));
+      added = &slot;
+    }
+    if (added->is_structured()) {
+      this->containers.push_back(added);
+    }
+    return true;
+  }
+
+  void start_capture() {
+    this->capture = this->pending_capture;
+    this->pending_capture = Capture::NONE;
+    this->capture_depth = 1;
+
+    BinaryBlock block;
+    block.acquisition_index = -1;
+    block.roi_index = -1;
+    block.element_type = BinaryBlock::ElementType::FLOAT64;
+    block.rows = 0;
+    if (this->capture == Capture::PAIRS) {
+      block.rows = 1;
+      block.axis = BinaryBlock::Axis::X;
+      block.values = this->frame_buffer();
+      this->binary_blocks.push_back(std::move(block));
+      block.axis = BinaryBlock::Axis::Y;
+      block.values = this->frame_buffer();
+      this->binary_blocks.push_back(std::move(block));
+      return;
+    }
+    if (this->capture == Capture::X_ROWS) {
+      block.axis = BinaryBlock::Axis::X;
+      // a single row, the smallest spare buffer is enough
+      if (this->buffers != nullptr) {
+        block.values = this->buffers->acquire();
+      }
+    } else {
+      block.axis = BinaryBlock::Axis::Y;
+      block.values = this->frame_buffer();
+    }
+    this->binary_blocks.push_back(std::move(block));
+  }
+
+  common::AlignedVector<double> frame_buffer() {
+    if (this->buffers == nullptr) {
+      return {};
+    }
+    return this->buffers->acquire(this->buffers->buffer_size());
+  }
+
+  bool start_nested_array() {
+    if (++this->capture_depth > 2) {
+      return false;
+    }
+    if (this->capture == Capture::PAIRS) {
+      this->pair_position = 0;
+    } else {
+      this->binary_blocks.back().rows++;
+    }
+    return true;
+  }
+
+  bool capture_number(double value) {
+    if (this->capture_depth != 2) {
+      return false;
+    }
+    if (this->capture != Capture::PAIRS) {
+      this->binary_blocks.back().values.push_back(value);
+      return true;
+    }
+    if (this->pair_position > 1) {
+      return false;
+    }
+    const auto block = this->binary_blocks.size() - 2 +
+                       static_cast<std::size_t>(this->pair_position);
+    this->binary_blocks[block].values.push_back(value);
+    this->pair_position++;
+    return true;
+  }
+
+  void set_roi_index(std::size_t first_block, int roi_index) {
+    for (std::size_t i = first_block; i < this->binary_blocks.size(); ++i) {
+      this->binary_blocks[i].roi_index = roi_index;
+    }
+  }
+
+  void set_acquisition_index(std::size_t first_block, int acquisition_index) {
+    for (std::size_t i = first_block; i < this->binary_blocks.size(); ++i) {
+      this->binary_blocks[i].acquisition_index = acquisition_index;
+    }
+  }
+};
+
+}  // namespace
+
+nlohmann::json DomResponseParser::parse(
+    std::string_view raw_response, std::vector<BinaryBlock>& /*binary_blocks*/,
+    common::BufferPool<double>* /*buffers*/) noexcept(false) {
+  return json::parse(raw_response.begin(), raw_response.end());
+}
+
+NumericDataResponseParser::NumericDataResponseParser(
+    std::size_t min_response_size)
+    : min_response_size{min_response_size} {}
+
+nlohmann::json NumericDataResponseParser::parse(
+    std::string_view raw_response, std::vector<BinaryBlock>& binary_blocks,
+    common::BufferPool<double>* buffers) noexcept(false) {
+  if (raw_response.size() < this->min_response_size) {
+    return this->dom_parser.parse(raw_response, binary_blocks);
+  }
+
+  const auto first_block = binary_blocks.size();
+  NumericDataHandler handler{binary_blocks, buffers};
+  if (json::sax_parse(raw_response.begin(), raw_response.end(), &handler) &&
+      handler.blocks_complete(first_block)) {
+    return std::move(handler.result);
+  }
+
+  // the numeric data is not laid out as in an acquisition, the response is
+  // parsed as is
+  if (buffers != nullptr) {
+    for (auto block = binary_blocks.begin() +
+                      static_cast<std::ptrdiff_t>(first_block);
+         block != binary_blocks.end(); ++block) {
+      buffers->release(std::move(block->values));
+    }
+  }
+  binary_blocks.resize(first_block);
+  return this->dom_parser.parse(raw_response, binary_blocks);
+}
+
+} /* namespace horiba::communication */
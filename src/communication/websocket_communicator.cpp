@@ -2,84 +2,616 @@
 
 #include <spdlog/spdlog.h>
 
-#include <boost/beast/core/buffers_to_string.hpp>
+#include <algorithm>
+#include <boost/asio/post.hpp>
 #include <boost/beast/core/flat_buffer.hpp>
 #include <boost/beast/core/make_printable.hpp>
+#include <boost/system/system_error.hpp>
+#include <chrono>
 #include <exception>
 #include <memory>
 #include <nlohmann/json.hpp>
+#include <optional>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 
+#include "horiba_cpp_sdk/common/logging.h"
+#include "horiba_cpp_sdk/communication/binary_message.h"
 #include "horiba_cpp_sdk/communication/command.h"
+#include "horiba_cpp_sdk/communication/command_metrics.h"
 #include "horiba_cpp_sdk/communication/response.h"
 
 namespace horiba::communication {
 
-WebSocketCommunicator::WebSocketCommunicator(std::string host, std::string port)
-    : host{std::move(host)}, port{std::move(port)} {}
+namespace {
+
+/**
+ * @brief Key of the device a command is sent to, e.g. "ccd:0". The commands of
+ * the ICL itself share the key "icl".
+ */
+std::string device_key(const Command& command) {
+  const auto& name = command.name();
+  std::string key = name.substr(0, name.find('_'));
+  const auto& parameters = command.json_parameters();
+  if (parameters.is_object()) {
+    const auto index = parameters.find("index");
+    if (index != parameters.end() && index->is_number_integer()) {
+      key += ':';
+      key += std::to_string(index->get<int>());
+    }
+  }
+  return key;
+}
+
+/**
+ * @brief Id of the request a response answers, if it can be read.
+ */
+std::optional<unsigned long long int> response_id(
+    const nlohmann::json& json_response) {
+  if (!json_response.is_object()) {
+    return std::nullopt;
+  }
+  const auto id = json_response.find("id");
+  if (id == json_response.end() || !id->is_number_unsigned()) {
+    return std::nullopt;
+  }
+  return id->get<unsigned long long int>();
+}
+
+}  // namespace
+
+WebSocketCommunicator::WebSocketCommunicator(std::string host, std::string port,
+                                             std::size_t io_threads)
+    : host{std::move(host)},
+      port{std::move(port)},
+      io_thread_count{std::max<std::size_t>(io_threads, 1)} {}
+
+WebSocketCommunicator::~WebSocketCommunicator() {
+  if (this->is_open()) {
+    try {
+      this->close();
+    } catch (const std::exception& e) {
+      spdlog::error("[WebSocketCommunicator] Failed to close WebSocket: {}",
+                    e.what());
+    }
+  }
+
+  this->work_guard.reset();
+  this->context.stop();
+  for (auto& io_thread : this->io_threads) {
+    io_thread.join();
+  }
+}
 
 void WebSocketCommunicator::open() {
+  this->open_until(std::chrono::steady_clock::time_point::max());
+}
+
+void WebSocketCommunicator::open_until(
+    std::chrono::steady_clock::time_point deadline) {
+  const std::lock_guard<std::mutex> lock(this->lifecycle_mutex);
   if (this->is_open()) {
     spdlog::error(
         "[WebSocketCommunicator] Failed to open WebSocket: already opened");
     throw std::runtime_error("websocket is already open");
   }
 
+  // the I/O threads of a previous connection lost by the remote are idle, they
+  // have to be joined before the context can be restarted
+  this->join_io_threads();
+  this->context.restart();
+
   spdlog::debug("[WebSocketCommunicator] Opening WebSocket on {}:{}",
                 this->host, this->port);
   boost::asio::ip::tcp::resolver resolver{this->context};
+  boost::asio::steady_timer timer{this->context};
+  boost::system::error_code error;
+  bool opening = true;
+  bool timed_out = false;
 
-  auto const results = resolver.resolve(this->host, this->port);
-  auto endpoint = boost::asio::connect(this->websocket.next_layer(), results);
+  // the I/O threads are not running yet, the opening runs on this thread so
+  // that neither the resolution, the connection nor the handshake with an ICL
+  // that does not answer outlasts the deadline
+  if (deadline != std::chrono::steady_clock::time_point::max()) {
+    timer.expires_at(deadline);
+    timer.async_wait([this, &resolver, &opening,
+                      &timed_out](boost::system::error_code timer_error) {
+      if (!timer_error && opening) {
+        timed_out = true;
+        resolver.cancel();
+        boost::system::error_code ignored;
+        this->websocket.next_layer().close(ignored);
+      }
+    });
+  }
+  const auto opened = [&timer, &opening,
+                       &error](boost::system::error_code open_error) {
+    opening = false;
+    error = open_error;
+    timer.cancel();
+  };
+  resolver.async_resolve(
+      this->host, this->port,
+      [this, opened](
+          boost::system::error_code resolve_error,
+          const boost::asio::ip::tcp::resolver::results_type& endpoints) {
+        if (resolve_error) {
+          opened(resolve_error);
+          return;
+        }
+        boost::asio::async_connect(
+            this->websocket.next_layer(), endpoints,
+            [this, opened](boost::system::error_code connect_error,
+                           const boost::asio::ip::tcp::endpoint& endpoint) {
+              if (connect_error) {
+                opened(connect_error);
+                return;
+              }
+              // pipelined commands are small writes, Nagle's algorithm would
+              // hold them back until the previous ones are acknowledged
+              this->websocket.next_layer().set_option(
+                  boost::asio::ip::tcp::no_delay(true));
 
-  this->websocket.set_option(boost::beast::websocket::stream_base::decorator(
-      [](boost::beast::websocket::request_type& req) {
-        req.set(
-            boost::beast::http::field::user_agent,
-            std::string(BOOST_BEAST_VERSION_STRING) + " websocket-client-coro");
-      }));
+              this->websocket.set_option(
+                  boost::beast::websocket::stream_base::decorator(
+                      [](boost::beast::websocket::request_type& req) {
+                        req.set(boost::beast::http::field::user_agent,
+                                std::string(BOOST_BEAST_VERSION_STRING) +
+                                    " websocket-client-coro");
+                      }));
 
-  this->websocket.handshake(host + ':' + std::to_string(endpoint.port()), "/");
+              this->websocket.async_handshake(
+                  this->host + ':' + std::to_string(endpoint.port()), "/",
+                  opened);
+            });
+      });
+  this->context.run();
+  this->context.restart();
+
+  if (timed_out) {
+    spdlog::error(
+        "[WebSocketCommunicator] Failed to open WebSocket: deadline passed");
+    throw std::runtime_error("websocket not opened before the deadline");
+  }
+  if (error) {
+    throw boost::system::system_error(error);
+  }
+
+  this->read_buffer.clear();
+  this->write_queue.clear();
+  this->connection_count++;
+  this->opened.store(true, std::memory_order_release);
+  this->work_guard.emplace(this->context.get_executor());
+  boost::asio::post(this->io_strand, [this] { this->do_read(); });
+  for (std::size_t i = 0; i < this->io_thread_count; i++) {
+    this->io_threads.emplace_back([this] { this->context.run(); });
+  }
 
   spdlog::debug("[WebSocketCommunicator] WebSocket opened");
 }
 
 void WebSocketCommunicator::close() {
+  const std::lock_guard<std::mutex> lock(this->lifecycle_mutex);
   if (!this->is_open()) {
     spdlog::error(
         "[WebSocketCommunicator] Failed to close WebSocket: not opened");
     throw std::runtime_error("websocket is not open");
   }
 
-  this->websocket.close(boost::beast::websocket::close_code::normal);
+  this->opened.store(false);
+  boost::asio::post(this->io_strand, [this] {
+    this->websocket.async_close(
+        boost::beast::websocket::close_code::normal,
+        [](boost::beast::error_code error) {
+          if (error) {
+            spdlog::debug("[WebSocketCommunicator] close: {}", error.message());
+          }
+        });
+  });
+  // the pending read completes once the close handshake is done, after which
+  // the I/O threads run out of work
+  this->join_io_threads();
+  this->fail_pending_requests("websocket closed");
+
   spdlog::debug("[WebSocketCommunicator] WebSocket closed");
 }
 
-bool WebSocketCommunicator::is_open() { return this->websocket.is_open(); }
+bool WebSocketCommunicator::is_open() {
+  return this->opened.load(std::memory_order_acquire);
+}
 
 Response WebSocketCommunicator::request_with_response(const Command& command) {
+  return this->request_with_response_async(command).get();
+}
+
+void WebSocketCommunicator::async_request(const Command& command,
+                                          ResponseHandler handler) {
+  this->async_request(command, RequestOptions{}, std::move(handler));
+}
+
+void WebSocketCommunicator::async_request(const Command& command,
+                                          const RequestOptions& options,
+                                          ResponseHandler handler) {
   if (!this->is_open()) {
     spdlog::error(
         "[WebSocketCommunicator] cannot send request, websocket is closed");
     throw std::runtime_error(
         "cannot send request if websocket communicator is closed");
   }
+  if (auto error = options.failure(command.name())) {
+    handler(error, Response{command.id(), command.name(), {}, {}});
+    return;
+  }
+  const auto connection = this->connection_count.load();
+
+  const auto serialize_start = std::chrono::steady_clock::now();
+  std::string json_command = this->take_write_buffer();
+  command.serialize(json_command);
+  const auto sent_at = std::chrono::steady_clock::now();
+  HORIBA_LOG_DEBUG("[WebSocketCommunicator] Sending request: {}",
+                   common::log_payload(json_command));
+
+  const auto id = command.id();
+  std::optional<Strand> device_strand;
+  if (this->io_thread_count > 1) {
+    device_strand = this->device_strand(command);
+  }
+  {
+    const std::lock_guard<std::mutex> lock(this->pending_requests_mutex);
+    auto& request =
+        this->pending_requests.insert_or_assign(id, PendingRequest{})
+            .first->second;
+    request.handler = std::move(handler);
+    request.sent_at = sent_at;
+    request.serialize_time = sent_at - serialize_start;
+    request.bytes_sent = json_command.size();
+    request.device_strand = std::move(device_strand);
+    if (options.stop_token.stop_possible()) {
+      // runs on the thread requesting the stop, the request is failed on the
+      // I/O thread like any other
+      request.cancellation =
+          std::make_unique<std::stop_callback<std::function<void()>>>(
+              options.stop_token, [this, id, name = command.name()] {
+                boost::asio::post(this->io_strand, [this, id, name] {
+                  this->fail_request(
+                      id, std::make_exception_ptr(RequestCancelledError(
+                              "request " + name + " cancelled")));
+                });
+              });
+    }
+  }
+
+  // a close() that started since the check above may already have failed
+  // the pending requests, this one would never complete
+  if (!this->is_open()) {
+    this->fail_request(id, std::make_exception_ptr(std::runtime_error(
+                               "cannot send request if websocket communicator "
+                               "is closed")));
+    return;
+  }
+
+  boost::asio::post(
+      this->io_strand,
+      [this, id, connection, deadline = options.deadline,
+       name = options.deadline ? command.name() : std::string{},
+       json_command = std::move(json_command)]() mutable {
+        // not sent on a connection opened after the one it was meant for
+        if (connection != this->connection_count.load()) {
+          this->give_back_write_buffer(std::move(json_command));
+          this->fail_request(id, std::make_exception_ptr(std::runtime_error(
+                                     "websocket closed before the request "
+                                     "was sent")));
+          return;
+        }
+        if (deadline) {
+          this->start_deadline_timer(id, *deadline, name);
+        }
+        this->write_queue.push_back(std::move(json_command));
+        if (this->write_queue.size() == 1) {
+          this->do_write();
+        }
+      });
+}
+
+void WebSocketCommunicator::set_response_parser(
+    std::shared_ptr<ResponseParser> parser) {
+  if (this->is_open()) {
+    spdlog::error(
+        "[WebSocketCommunicator] Cannot set the response parser: websocket is "
+        "open");
+    throw std::runtime_error(
+        "cannot set the response parser of an open websocket");
+  }
+  this->response_parser = std::move(parser);
+}
+
+std::shared_ptr<common::BufferPool<double>>
+WebSocketCommunicator::buffer_pool() {
+  return this->value_buffers;
+}
+
+void WebSocketCommunicator::join_io_threads() {
+  this->work_guard.reset();
+  for (auto& io_thread : this->io_threads) {
+    io_thread.join();
+  }
+  this->io_threads.clear();
+}
+
+WebSocketCommunicator::Strand WebSocketCommunicator::device_strand(
+    const Command& command) {
+  auto key = device_key(command);
+  const std::lock_guard<std::mutex> lock(this->device_strands_mutex);
+  auto strand = this->device_strands.find(key);
+  if (strand == this->device_strands.end()) {
+    strand =
+        this->device_strands
+            .emplace(std::move(key), boost::asio::make_strand(this->context))
+            .first;
+  }
+  return strand->second;
+}
+
+void WebSocketCommunicator::finish_request(PendingRequest& request,
+                                           std::exception_ptr error,
+                                           Response response) {
+  auto call_handler = [handler = std::move(request.handler),
+                       error = std::move(error),
+                       response = std::move(response)]() mutable {
+    try {
+      handler(error, std::move(response));
+    } catch (const std::exception& e) {
+      spdlog::error("[WebSocketCommunicator] Response handler failed: {}",
+                    e.what());
+    }
+  };
+  // requests failed by close() once the I/O threads are joined are completed
+  // on the closing thread
+  if (request.device_strand && this->io_strand.running_in_this_thread()) {
+    boost::asio::post(*request.device_strand, std::move(call_handler));
+    return;
+  }
+  call_handler();
+}
+
+void WebSocketCommunicator::do_read() {
+  this->websocket.async_read(
+      this->read_buffer,
+      [this](boost::beast::error_code error, std::size_t /*bytes_read*/) {
+        this->on_read(error);
+      });
+}
+
+void WebSocketCommunicator::on_read(boost::beast::error_code error) {
+  if (error) {
+    const bool was_open =
+        this->opened.exchange(false, std::memory_order_acq_rel);
+    if (was_open && error != boost::beast::websocket::error::closed) {
+      spdlog::error("[WebSocketCommunicator] Failed to read: {}",
+                    error.message());
+    }
+    this->fail_pending_requests(error.message());
+    return;
+  }
 
-  std::string json_command = command.json().dump();
-  spdlog::debug("[WebSocketCommunicator] Sending request: {}", json_command);
-  this->websocket.write(boost::asio::buffer(json_command));
+  if (this->websocket.got_binary()) {
+    this->dispatch_binary_response();
+  } else {
+    const auto frame = this->read_buffer.cdata();
+    const std::string_view raw_response{static_cast<const char*>(frame.data()),
+                                        frame.size()};
+    HORIBA_LOG_DEBUG("[WebSocketCommunicator] raw response: {}",
+                     common::log_payload(raw_response));
+    this->dispatch_response(raw_response);
+  }
 
-  boost::beast::flat_buffer buffer;
-  this->websocket.read(buffer);
+  this->read_buffer.consume(this->read_buffer.size());
+  this->do_read();
+}
 
-  std::string raw_response = boost::beast::buffers_to_string(buffer.data());
-  spdlog::debug("[WebSocketCommunicator] raw response: {}", raw_response);
+void WebSocketCommunicator::do_write() {
+  this->websocket.text(true);
+  this->websocket.async_write(
+      boost::asio::buffer(this->write_queue.front()),
+      [this](boost::beast::error_code error, std::size_t /*bytes_written*/) {
+        this->on_write(error);
+      });
+}
 
-  nlohmann::json json_response = nlohmann::json::parse(raw_response);
-  spdlog::debug("[WebSocketCommunicator] Received response: {}",
-                json_response.dump());
+void WebSocketCommunicator::on_write(boost::beast::error_code error) {
+  if (error) {
+    spdlog::error("[WebSocketCommunicator] Failed to write: {}",
+                  error.message());
+    this->write_queue.clear();
+    this->fail_pending_requests(error.message());
+    return;
+  }
 
-  return Response{json_response["id"], json_response["command"],
-                  json_response["results"], json_response["errors"]};
+  this->give_back_write_buffer(std::move(this->write_queue.front()));
+  this->write_queue.pop_front();
+  if (!this->write_queue.empty()) {
+    this->do_write();
+  }
+}
+
+void WebSocketCommunicator::dispatch_response(std::string_view raw_response) {
+  ReceivedFrame frame{std::chrono::steady_clock::now(),
+                      std::chrono::nanoseconds{0}, raw_response.size()};
+  nlohmann::json json_response;
+  std::vector<BinaryBlock> binary_blocks;
+  try {
+    json_response = this->response_parser->parse(raw_response, binary_blocks,
+                                                 this->value_buffers.get());
+  } catch (const std::exception& e) {
+    spdlog::error("[WebSocketCommunicator] Failed to parse response: {}",
+                  e.what());
+    // the request it answers is unknown, it would never complete otherwise
+    this->fail_pending_requests(std::string("malformed response: ") +
+                                e.what());
+    return;
+  }
+  frame.parse_time = std::chrono::steady_clock::now() - frame.received_at;
+
+  this->complete_request(json_response, std::move(binary_blocks), frame);
+}
+
+void WebSocketCommunicator::dispatch_binary_response() {
+  const auto raw_frame = this->read_buffer.cdata();
+  ReceivedFrame frame{std::chrono::steady_clock::now(),
+                      std::chrono::nanoseconds{0}, raw_frame.size()};
+  BinaryMessage message;
+  try {
+    message = BinaryMessage::decode(
+        {static_cast<const std::byte*>(raw_frame.data()), raw_frame.size()},
+        this->value_buffers.get());
+  } catch (const std::exception& e) {
+    spdlog::error(
+        "[WebSocketCommunicator] Failed to decode binary response: {}",
+        e.what());
+    this->fail_pending_requests(std::string("malformed binary response: ") +
+                                e.what());
+    return;
+  }
+  HORIBA_LOG_DEBUG(
+      "[WebSocketCommunicator] Received binary response: {} with {} blocks",
+      common::log_payload(message.metadata()), message.blocks().size());
+
+  frame.parse_time = std::chrono::steady_clock::now() - frame.received_at;
+
+  nlohmann::json metadata = message.metadata();
+  this->complete_request(metadata, std::move(message.blocks()), frame);
+}
+
+void WebSocketCommunicator::complete_request(
+    nlohmann::json& json_response, std::vector<BinaryBlock> binary_blocks,
+    const ReceivedFrame& frame) {
+  const auto parsed_id = response_id(json_response);
+  if (!parsed_id) {
+    spdlog::error("[WebSocketCommunicator] Response without a valid id: {}",
+                  common::log_payload(json_response));
+    this->fail_pending_requests("response without a valid id");
+    return;
+  }
+
+  const auto id = *parsed_id;
+  PendingRequest request;
+  {
+    const std::lock_guard<std::mutex> lock(this->pending_requests_mutex);
+    auto pending_request = this->pending_requests.find(id);
+    if (pending_request == this->pending_requests.end()) {
+      // also the late response of a request that timed out or got cancelled
+      spdlog::warn("[WebSocketCommunicator] No request waiting for id {}", id);
+      return;
+    }
+    request = std::move(pending_request->second);
+    this->pending_requests.erase(pending_request);
+  }
+
+  std::exception_ptr error = nullptr;
+  // named once the response is known to be well formed
+  Response response{id, "", {}, {}};
+  try {
+    // the parsed fields are moved into the response instead of being copied
+    std::vector<std::string> errors;
+    auto& json_errors = json_response.at("errors");
+    errors.reserve(json_errors.size());
+    for (auto& json_error : json_errors) {
+      errors.push_back(std::move(json_error.get_ref<std::string&>()));
+    }
+    response = Response{
+        id, std::move(json_response.at("command").get_ref<std::string&>()),
+        std::move(json_response.at("results")
+                      .get_ref<nlohmann::json::object_t&>()),
+        std::move(errors), std::move(binary_blocks)};
+  } catch (const nlohmann::json::exception& e) {
+    spdlog::error("[WebSocketCommunicator] Malformed response: {}", e.what());
+    error = std::current_exception();
+  }
+
+  if (const auto& metrics = this->metrics(); metrics && !error) {
+    metrics->record(response.command_name(),
+                    CommandSample{request.serialize_time,
+                                  frame.received_at - request.sent_at,
+                                  frame.parse_time, request.bytes_sent,
+                                  frame.bytes});
+  }
+
+  this->finish_request(request, error, std::move(response));
+}
+
+void WebSocketCommunicator::start_deadline_timer(
+    unsigned long long int id, std::chrono::steady_clock::time_point deadline,
+    const std::string& command_name) {
+  auto timer =
+      std::make_unique<boost::asio::steady_timer>(this->io_strand, deadline);
+  timer->async_wait([this, id, command_name](boost::beast::error_code error) {
+    // the timer is cancelled when the request completes first
+    if (error) {
+      return;
+    }
+    this->fail_request(id, std::make_exception_ptr(RequestTimeoutError(
+                               "no response to " + command_name +
+                               " before the deadline")));
+  });
+
+  const std::lock_guard<std::mutex> lock(this->pending_requests_mutex);
+  if (auto pending_request = this->pending_requests.find(id);
+      pending_request != this->pending_requests.end()) {
+    pending_request->second.deadline_timer = std::move(timer);
+  }
+}
+
+void WebSocketCommunicator::fail_request(unsigned long long int id,
+                                         const std::exception_ptr& error) {
+  PendingRequest request;
+  {
+    const std::lock_guard<std::mutex> lock(this->pending_requests_mutex);
+    auto pending_request = this->pending_requests.find(id);
+    if (pending_request == this->pending_requests.end()) {
+      // the response arrived first
+      return;
+    }
+    request = std::move(pending_request->second);
+    this->pending_requests.erase(pending_request);
+  }
+
+  this->finish_request(request, error, Response{id, "", {}, {}});
+}
+
+std::string WebSocketCommunicator::take_write_buffer() {
+  const std::lock_guard<std::mutex> lock(this->spare_write_buffers_mutex);
+  if (this->spare_write_buffers.empty()) {
+    return {};
+  }
+  std::string buffer = std::move(this->spare_write_buffers.back());
+  this->spare_write_buffers.pop_back();
+  return buffer;
+}
+
+void WebSocketCommunicator::give_back_write_buffer(std::string buffer) {
+  // enough for the commands pipelined by a batch, extra buffers are freed
+  static constexpr std::size_t MAX_SPARE_WRITE_BUFFERS = 16;
+  const std::lock_guard<std::mutex> lock(this->spare_write_buffers_mutex);
+  if (this->spare_write_buffers.size() < MAX_SPARE_WRITE_BUFFERS) {
+    this->spare_write_buffers.push_back(std::move(buffer));
+  }
+}
+
+void WebSocketCommunicator::fail_pending_requests(const std::string& reason) {
+  std::unordered_map<unsigned long long int, PendingRequest> failed_requests;
+  {
+    const std::lock_guard<std::mutex> lock(this->pending_requests_mutex);
+    failed_requests.swap(this->pending_requests);
+  }
+
+  for (auto& [id, request] : failed_requests) {
+    this->finish_request(request,
+                         std::make_exception_ptr(std::runtime_error(
+                             "no response received from the ICL: " + reason)),
+                         Response{id, "", {}, {}});
+  }
 }
 } /* namespace horiba::communication */
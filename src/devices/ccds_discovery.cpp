@@ -1,3 +1,4 @@
+#include <horiba_cpp_sdk/common/logging.h>
 #include <horiba_cpp_sdk/communication/command.h>
 #include <horiba_cpp_sdk/communication/response.h>
 #include <horiba_cpp_sdk/devices/ccds_discovery.h>
@@ -28,14 +29,17 @@ void ChargeCoupledDevicesDiscovery::execute(bool error_on_no_devices) {
   const auto response = this->communicator->request_with_response(
       communication::Command("ccd_list", {}));
 
-  spdlog::debug("[ChargeCoupledDevicesDiscovery] response: {}",
-                response.json_results().dump());
+  HORIBA_LOG_DEBUG("[ChargeCoupledDevicesDiscovery] response: {}",
+                   common::log_payload(response.json_results()));
 
   if (response.json_results().empty() && error_on_no_devices) {
     throw std::runtime_error("No CCDs connected");
   }
 
   auto raw_cdds = response.json_results();
+  this->listed_ccds = raw_cdds.contains("devices")
+                          ? raw_cdds["devices"]
+                          : nlohmann::json::array();
   this->ccds = this->parse_ccds(raw_cdds);
 }
 
@@ -44,6 +48,10 @@ ChargeCoupledDevicesDiscovery::charge_coupled_devices() const {
   return this->ccds;
 }
 
+const nlohmann::json& ChargeCoupledDevicesDiscovery::raw_devices() const {
+  return this->listed_ccds;
+}
+
 std::vector<std::shared_ptr<single_devices::ChargeCoupledDevice>>
 ChargeCoupledDevicesDiscovery::parse_ccds(nlohmann::json raw_ccds) {
   spdlog::info("[ChargeCoupledDevicesDiscovery] detected #{} CCDS",
@@ -52,7 +60,8 @@ ChargeCoupledDevicesDiscovery::parse_ccds(nlohmann::json raw_ccds) {
       detected_ccds;
   auto devices = raw_ccds["devices"];
   for (auto& device : devices) {
-    spdlog::info("[ChargeCoupledDevicesDiscovery] CCD: {}", device.dump());
+    HORIBA_LOG_INFO("[ChargeCoupledDevicesDiscovery] CCD: {}",
+                    common::log_payload(device));
     const int index = device["index"].get<int>();
     detected_ccds.push_back(
         std::make_shared<single_devices::ChargeCoupledDevice>(
@@ -0,0 +1,93 @@
+#include <horiba_cpp_sdk/devices/discovery_cache.h>
+#include <spdlog/spdlog.h>
+
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace horiba::devices {
+
+namespace {
+
+std::vector<std::string> serial_numbers(const nlohmann::json& devices) {
+  std::vector<std::string> serials;
+  serials.reserve(devices.size());
+  for (const auto& device : devices) {
+    serials.push_back(device.value("serialNumber", ""));
+  }
+  return serials;
+}
+
+} /* namespace */
+
+bool DiscoveryCache::Entry::same_devices(const Entry& other) const {
+  return this->icl_version == other.icl_version &&
+         serial_numbers(this->ccds) == serial_numbers(other.ccds) &&
+         serial_numbers(this->monos) == serial_numbers(other.monos);
+}
+
+DiscoveryCache::DiscoveryCache(std::filesystem::path path)
+    : cache_path{std::move(path)} {}
+
+std::optional<DiscoveryCache::Entry> DiscoveryCache::load() const {
+  std::ifstream file(this->cache_path);
+  if (!file) {
+    spdlog::debug("[DiscoveryCache] no cache at {}",
+                  this->cache_path.string());
+    return std::nullopt;
+  }
+
+  const auto json_cache = nlohmann::json::parse(file, nullptr, false);
+  if (json_cache.is_discarded() || !json_cache.is_object() ||
+      !json_cache.contains("iclVersion") ||
+      !json_cache["iclVersion"].is_string() ||
+      !json_cache.contains("ccds") || !json_cache["ccds"].is_array() ||
+      !json_cache.contains("monos") || !json_cache["monos"].is_array()) {
+    spdlog::warn("[DiscoveryCache] ignoring invalid cache at {}",
+                 this->cache_path.string());
+    return std::nullopt;
+  }
+
+  return Entry{json_cache["iclVersion"].get<std::string>(), json_cache["ccds"],
+               json_cache["monos"]};
+}
+
+void DiscoveryCache::store(const Entry& entry) const {
+  const nlohmann::json json_cache = {{"iclVersion", entry.icl_version},
+                                     {"ccds", entry.ccds},
+                                     {"monos", entry.monos}};
+
+  // written next to the cache and then renamed, so that a reader never sees a
+  // partially written file
+  auto temporary_path = this->cache_path;
+  temporary_path += ".tmp";
+  {
+    std::ofstream file(temporary_path, std::ios::trunc);
+    if (!(file << json_cache.dump(2))) {
+      spdlog::warn("[DiscoveryCache] failed to write cache {}",
+                   temporary_path.string());
+      return;
+    }
+  }
+
+  std::error_code error;
+  std::filesystem::rename(temporary_path, this->cache_path, error);
+  if (error) {
+    spdlog::warn("[DiscoveryCache] failed to replace cache {}: {}",
+                 this->cache_path.string(), error.message());
+    std::filesystem::remove(temporary_path, error);
+    return;
+  }
+  spdlog::debug("[DiscoveryCache] stored cache at {}",
+                this->cache_path.string());
+}
+
+const std::filesystem::path& DiscoveryCache::path() const {
+  return this->cache_path;
+}
+
+} /* namespace horiba::devices */
@@ -1,13 +1,23 @@
+#include <horiba_cpp_sdk/common/exponential_backoff.h>
+#include <horiba_cpp_sdk/common/logging.h>
 #include <horiba_cpp_sdk/communication/command.h>
+#include <horiba_cpp_sdk/communication/reconnecting_communicator.h>
 #include <horiba_cpp_sdk/communication/response.h>
 #include <horiba_cpp_sdk/communication/websocket_communicator.h>
 #include <horiba_cpp_sdk/devices/ccds_discovery.h>
 #include <horiba_cpp_sdk/devices/icl_device_manager.h>
 #include <horiba_cpp_sdk/devices/monos_discovery.h>
 #include <horiba_cpp_sdk/devices/single_devices/ccd.h>
+#include <horiba_cpp_sdk/devices/single_devices/mono.h>
 #include <spdlog/spdlog.h>
 
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <utility>
@@ -17,12 +27,13 @@ namespace horiba::devices {
 ICLDeviceManager::ICLDeviceManager(
     std::shared_ptr<horiba::os::Process> icl_process, std::string websocket_ip,
     std::string websocket_port, bool manage_icl_lifetime,
-    bool enable_binary_messages)
+    bool enable_binary_messages, bool open_devices_on_start)
     : icl_process{std::move(icl_process)},
       websocket_ip{std::move(websocket_ip)},
       websocket_port{std::move(websocket_port)},
       manage_icl_lifetime{manage_icl_lifetime},
       enable_binary_messages{enable_binary_messages},
+      open_devices_on_start{open_devices_on_start},
       communicator{
           std::make_shared<horiba::communication::WebSocketCommunicator>(
               this->websocket_ip, this->websocket_port)} {}
@@ -30,27 +41,57 @@ ICLDeviceManager::ICLDeviceManager(
 void ICLDeviceManager::start() {
   spdlog::debug("[ICLDeviceManager] managing ICL lifetime: {}",
                 this->manage_icl_lifetime);
+  const auto icl_start = std::chrono::steady_clock::now();
   if (this->manage_icl_lifetime && !this->icl_process->running()) {
     this->icl_process->start();
   }
   spdlog::debug("[ICLDeviceManager] ICL started");
 
-  this->communicator->open();
+  this->connect_when_ready(icl_start);
 
   const communication::Response response =
       this->communicator->request_with_response(
           communication::Command("icl_info", {}));
-  spdlog::debug("[ICLDeviceManager] ICL info: {}",
-                response.json_results().dump());
+  HORIBA_LOG_DEBUG("[ICLDeviceManager] ICL info: {}",
+                   common::log_payload(response.json_results()));
+  this->icl_version = response.json_results().value("nodeVersion", "");
 
   if (this->enable_binary_messages) {
     this->enable_binary_messages_on_icl();
   }
 
+  if (this->restore_cached_devices()) {
+    // the cached devices are checked against the ICL without delaying startup,
+    // they are only opened once confirmed
+    this->background_discovery = std::async(std::launch::async, [this] {
+      const bool cache_outdated = this->update_devices(false);
+      if (this->open_devices_on_start) {
+        this->open_all_devices();
+      }
+      if (cache_outdated) {
+        throw OutdatedDiscoveryCacheError(
+            "cached devices are outdated, they have been replaced");
+      }
+    });
+    return;
+  }
+
   this->discover_devices();
+  if (this->open_devices_on_start) {
+    this->open_all_devices();
+  }
 }
 
 void ICLDeviceManager::stop() {
+  try {
+    this->wait_for_discovery();
+  } catch (const OutdatedDiscoveryCacheError& e) {
+    spdlog::warn("[ICLDeviceManager] {}", e.what());
+  } catch (const std::exception& e) {
+    spdlog::error("[ICLDeviceManager] background discovery failed: {}",
+                  e.what());
+  }
+
   if (this->manage_icl_lifetime && !this->communicator->is_open()) {
     this->communicator->open();
   }
@@ -68,30 +109,254 @@ void ICLDeviceManager::stop() {
 }
 
 void ICLDeviceManager::discover_devices(bool error_on_no_device) {
-  ChargeCoupledDevicesDiscovery ccds_discovery =
-      ChargeCoupledDevicesDiscovery(this->communicator);
+  this->update_devices(error_on_no_device);
+}
 
-  ccds_discovery.execute(error_on_no_device);
-  this->ccds = ccds_discovery.charge_coupled_devices();
+bool ICLDeviceManager::update_devices(bool error_on_no_device) {
+  // opened once here, the discoveries would otherwise race to open it
+  if (!this->communicator->is_open()) {
+    this->communicator->open();
+  }
 
-  MonochromatorsDiscovery monochromators_discovery =
-      MonochromatorsDiscovery(this->communicator);
+  using clock = std::chrono::steady_clock;
+
+  auto ccds_discovered = std::async(std::launch::async, [this,
+                                                         error_on_no_device] {
+    const auto start = clock::now();
+    ChargeCoupledDevicesDiscovery ccds_discovery =
+        ChargeCoupledDevicesDiscovery(this->communicator);
+    ccds_discovery.execute(error_on_no_device);
+    this->ccds_discovery_time =
+        std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() -
+                                                              start);
+    return ccds_discovery;
+  });
+
+  auto monos_discovered = std::async(std::launch::async, [this,
+                                                          error_on_no_device] {
+    const auto start = clock::now();
+    MonochromatorsDiscovery monochromators_discovery =
+        MonochromatorsDiscovery(this->communicator);
+    monochromators_discovery.execute(error_on_no_device);
+    this->monos_discovery_time =
+        std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() -
+                                                              start);
+    return monochromators_discovery;
+  });
+
+  // both futures are waited on before rethrowing, so that no discovery
+  // outlives this call
+  std::exception_ptr error = nullptr;
+  std::optional<ChargeCoupledDevicesDiscovery> ccds_discovery;
+  std::optional<MonochromatorsDiscovery> monochromators_discovery;
+  try {
+    ccds_discovery.emplace(ccds_discovered.get());
+  } catch (...) {
+    error = std::current_exception();
+  }
+  try {
+    monochromators_discovery.emplace(monos_discovered.get());
+  } catch (...) {
+    if (!error) {
+      error = std::current_exception();
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
 
-  monochromators_discovery.execute(error_on_no_device);
-  this->monos = monochromators_discovery.monochromators();
+  spdlog::info("[ICLDeviceManager] discovered {} CCDs in {} ms",
+               ccds_discovery->charge_coupled_devices().size(),
+               this->ccds_discovery_time.load().count());
+  spdlog::info("[ICLDeviceManager] discovered {} monochromators in {} ms",
+               monochromators_discovery->monochromators().size(),
+               this->monos_discovery_time.load().count());
+
+  const DiscoveryCache::Entry discovered{
+      this->icl_version, ccds_discovery->raw_devices(),
+      monochromators_discovery->raw_devices()};
+  bool cache_outdated = false;
+  {
+    const std::lock_guard<std::mutex> lock(this->devices_mutex);
+    if (this->cached_devices &&
+        this->cached_devices->same_devices(discovered)) {
+      // the devices built from the cache are kept, the application may already
+      // be using them
+      spdlog::debug("[ICLDeviceManager] cached devices are up to date");
+    } else {
+      if (this->cached_devices) {
+        spdlog::warn(
+            "[ICLDeviceManager] cached devices are outdated, replacing them");
+        cache_outdated = true;
+      }
+      this->ccds = ccds_discovery->charge_coupled_devices();
+      this->monos = monochromators_discovery->monochromators();
+    }
+    this->cached_devices.reset();
+  }
+
+  if (this->discovery_cache) {
+    this->discovery_cache->store(discovered);
+  }
+  return cache_outdated;
+}
+
+void ICLDeviceManager::open_all_devices() {
+  const auto devices_ccds = this->charge_coupled_devices();
+  const auto devices_monos = this->monochromators();
+  std::vector<std::future<void>> opened_devices;
+  opened_devices.reserve(devices_ccds.size() + devices_monos.size());
+  for (const auto& ccd : devices_ccds) {
+    opened_devices.push_back(
+        std::async(std::launch::async, [ccd] { ccd->open(); }));
+  }
+  for (const auto& mono : devices_monos) {
+    opened_devices.push_back(
+        std::async(std::launch::async, [mono] { mono->open(); }));
+  }
+
+  std::exception_ptr error = nullptr;
+  for (auto& opened_device : opened_devices) {
+    try {
+      opened_device.get();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  spdlog::debug("[ICLDeviceManager] opened {} devices", opened_devices.size());
+}
+
+std::chrono::milliseconds
+ICLDeviceManager::charge_coupled_devices_discovery_time() const {
+  return this->ccds_discovery_time.load();
+}
+
+std::chrono::milliseconds ICLDeviceManager::monochromators_discovery_time()
+    const {
+  return this->monos_discovery_time.load();
+}
+
+void ICLDeviceManager::set_start_timeout(std::chrono::milliseconds timeout) {
+  this->start_timeout = timeout;
+}
+
+std::chrono::milliseconds ICLDeviceManager::icl_ready_time() const {
+  return this->ready_time;
+}
+
+void ICLDeviceManager::use_discovery_cache(
+    const std::filesystem::path& cache_file) {
+  this->discovery_cache.emplace(cache_file);
+}
+
+void ICLDeviceManager::use_automatic_reconnect(
+    communication::ReconnectPolicy policy) {
+  this->communicator =
+      std::make_shared<communication::ReconnectingCommunicator>(
+          this->communicator, policy);
+}
+
+void ICLDeviceManager::wait_for_discovery() {
+  if (this->background_discovery.valid()) {
+    this->background_discovery.get();
+  }
 }
 
 std::vector<std::shared_ptr<horiba::devices::single_devices::Monochromator>>
 ICLDeviceManager::monochromators() const {
+  const std::lock_guard<std::mutex> lock(this->devices_mutex);
   return this->monos;
 }
 
 std::vector<
     std::shared_ptr<horiba::devices::single_devices::ChargeCoupledDevice>>
 ICLDeviceManager::charge_coupled_devices() const {
+  const std::lock_guard<std::mutex> lock(this->devices_mutex);
   return this->ccds;
 }
 
+bool ICLDeviceManager::restore_cached_devices() {
+  if (!this->discovery_cache) {
+    return false;
+  }
+
+  auto entry = this->discovery_cache->load();
+  if (!entry || entry->icl_version != this->icl_version) {
+    spdlog::debug("[ICLDeviceManager] no cached devices for ICL {}",
+                  this->icl_version);
+    return false;
+  }
+
+  std::vector<
+      std::shared_ptr<horiba::devices::single_devices::ChargeCoupledDevice>>
+      cached_ccds;
+  for (const auto& device : entry->ccds) {
+    cached_ccds.push_back(
+        std::make_shared<horiba::devices::single_devices::ChargeCoupledDevice>(
+            device.at("index").get<int>(), this->communicator));
+  }
+  std::vector<std::shared_ptr<horiba::devices::single_devices::Monochromator>>
+      cached_monos;
+  for (const auto& device : entry->monos) {
+    cached_monos.push_back(
+        std::make_shared<horiba::devices::single_devices::Monochromator>(
+            device.at("index").get<int>(), this->communicator));
+  }
+
+  spdlog::info("[ICLDeviceManager] restored {} CCDs and {} monochromators "
+               "from {}",
+               cached_ccds.size(), cached_monos.size(),
+               this->discovery_cache->path().string());
+
+  const std::lock_guard<std::mutex> lock(this->devices_mutex);
+  this->ccds = std::move(cached_ccds);
+  this->monos = std::move(cached_monos);
+  this->cached_devices = std::move(entry);
+  return true;
+}
+
+void ICLDeviceManager::connect_when_ready(
+    std::chrono::steady_clock::time_point icl_start) {
+  const auto deadline = icl_start + this->start_timeout;
+  std::string last_error;
+  const bool connected = common::poll_until(
+      [this, &last_error, deadline] {
+        if (this->communicator->is_open()) {
+          return true;
+        }
+        try {
+          // an ICL accepting the connection without answering the handshake
+          // must not hold the attempt past the deadline
+          this->communicator->open_until(deadline);
+          return true;
+        } catch (const std::exception& e) {
+          // the ICL is still booting
+          last_error = e.what();
+          return false;
+        }
+      },
+      deadline,
+      common::ExponentialBackoff{std::chrono::milliseconds(5),
+                                 std::chrono::milliseconds(250)});
+  if (!connected) {
+    spdlog::error("[ICLDeviceManager] ICL not ready within {} ms: {}",
+                  this->start_timeout.count(), last_error);
+    throw std::runtime_error("ICL not ready within " +
+                             std::to_string(this->start_timeout.count()) +
+                             " ms: " + last_error);
+  }
+
+  this->ready_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - icl_start);
+  spdlog::info("[ICLDeviceManager] ICL ready in {} ms",
+               this->ready_time.count());
+}
+
 void ICLDeviceManager::enable_binary_messages_on_icl() {
   spdlog::debug("[ICLDeviceManager] enable binary messages on the ICL");
 
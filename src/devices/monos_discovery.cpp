@@ -29,7 +29,10 @@ void MonochromatorsDiscovery::execute(bool error_on_no_devices) {
     throw std::runtime_error("No Monochromators connected");
   }
 
-  auto raw_monos_list = response.json_results()["devices"];
+  auto raw_monos_list =
+      response.json_results().value("devices", nlohmann::json::array());
+  this->listed_monos =
+      raw_monos_list.is_array() ? raw_monos_list : nlohmann::json::array();
   this->monos = this->parse_monos(raw_monos_list);
 }
 
@@ -38,6 +41,10 @@ MonochromatorsDiscovery::monochromators() const {
   return this->monos;
 }
 
+const nlohmann::json& MonochromatorsDiscovery::raw_devices() const {
+  return this->listed_monos;
+}
+
 std::vector<std::shared_ptr<single_devices::Monochromator>>
 MonochromatorsDiscovery::parse_monos(const nlohmann::json& raw_monos_list) {
   spdlog::info("[MonochromatorsDiscovery] detected #{} monos",
@@ -0,0 +1,222 @@
+#include "horiba_cpp_sdk/devices/single_devices/acquisition_data.h"
+
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace horiba::devices::single_devices {
+
+namespace {
+
+/**
+ * @brief Copies rows of numbers into a contiguous array.
+ *
+ * @return Number of rows
+ */
+std::size_t copy_rows(const nlohmann::json& rows,
+                      common::AlignedVector<double>& values) {
+  std::size_t value_count = 0;
+  for (const auto& row : rows) {
+    value_count += row.size();
+  }
+  values.clear();
+  values.reserve(value_count);
+  for (const auto& row : rows) {
+    for (const auto& value : row) {
+      values.push_back(value.get<double>());
+    }
+  }
+  return rows.size();
+}
+
+void copy_pairs(const nlohmann::json& pairs, RegionOfInterestData& roi) {
+  roi.x_values.clear();
+  roi.y_values.clear();
+  roi.x_values.reserve(pairs.size());
+  roi.y_values.reserve(pairs.size());
+  for (const auto& pair : pairs) {
+    roi.x_values.push_back(pair.at(0).get<double>());
+    roi.y_values.push_back(pair.at(1).get<double>());
+  }
+  roi.rows = 1;
+}
+
+} /* namespace */
+
+std::size_t RegionOfInterestData::columns() const {
+  return this->rows == 0 ? 0 : this->y_values.size() / this->rows;
+}
+
+std::span<const double> RegionOfInterestData::y_row(std::size_t row) const {
+  if (row >= this->rows) {
+    throw std::out_of_range("row " + std::to_string(row) +
+                            " is out of range, the data has " +
+                            std::to_string(this->rows) + " rows");
+  }
+  const auto row_size = this->columns();
+  return std::span<const double>{this->y_values}.subspan(row * row_size,
+                                                         row_size);
+}
+
+AcquisitionData AcquisitionData::parse_metadata(const nlohmann::json& results) {
+  AcquisitionData data;
+  data.acquisition_timestamp = results.value("timestamp", "");
+
+  const auto& acquisitions = results.at("acquisition");
+  data.acquisition_list.reserve(acquisitions.size());
+  for (const auto& json_acquisition : acquisitions) {
+    Acquisition acquisition;
+    acquisition.index = json_acquisition.at("acqIndex").get<int>();
+
+    const auto& json_rois = json_acquisition.at("roi");
+    acquisition.regions_of_interest.reserve(json_rois.size());
+    for (const auto& json_roi : json_rois) {
+      RegionOfInterestData roi;
+      roi.index = json_roi.at("roiIndex").get<int>();
+      roi.x_origin = json_roi.value("xOrigin", 0);
+      roi.y_origin = json_roi.value("yOrigin", 0);
+      roi.x_size = json_roi.value("xSize", 0);
+      roi.y_size = json_roi.value("ySize", 0);
+      roi.x_binning = json_roi.value("xBinning", 1);
+      roi.y_binning = json_roi.value("yBinning", 1);
+      acquisition.regions_of_interest.push_back(std::move(roi));
+    }
+    data.acquisition_list.push_back(std::move(acquisition));
+  }
+  return data;
+}
+
+AcquisitionData AcquisitionData::from_json(const nlohmann::json& results) {
+  auto data = parse_metadata(results);
+
+  const auto& acquisitions = results.at("acquisition");
+  for (std::size_t i = 0; i < data.acquisition_list.size(); ++i) {
+    const auto& json_rois = acquisitions[i].at("roi");
+    auto& rois = data.acquisition_list[i].regions_of_interest;
+    for (std::size_t j = 0; j < rois.size(); ++j) {
+      const auto& json_roi = json_rois[j];
+      if (json_roi.contains("xyData")) {
+        copy_pairs(json_roi["xyData"], rois[j]);
+        continue;
+      }
+      if (json_roi.contains("xData")) {
+        copy_rows(json_roi["xData"], rois[j].x_values);
+      }
+      if (json_roi.contains("yData")) {
+        rois[j].rows = copy_rows(json_roi["yData"], rois[j].y_values);
+      }
+    }
+  }
+  return data;
+}
+
+AcquisitionData AcquisitionData::from_binary_message(
+    const nlohmann::json& results,
+    const std::vector<communication::BinaryBlock>& blocks) {
+  auto data = parse_metadata(results);
+
+  for (const auto& block : blocks) {
+    auto& roi = data.block_region(block);
+    if (block.axis == communication::BinaryBlock::Axis::X) {
+      roi.x_values.assign(block.values.begin(), block.values.end());
+    } else {
+      roi.y_values.assign(block.values.begin(), block.values.end());
+      roi.rows = static_cast<std::size_t>(block.rows);
+    }
+  }
+  return data;
+}
+
+AcquisitionData AcquisitionData::from_binary_message(
+    const nlohmann::json& results,
+    std::vector<communication::BinaryBlock>&& blocks) {
+  auto data = parse_metadata(results);
+
+  for (auto& block : blocks) {
+    auto& roi = data.block_region(block);
+    if (block.axis == communication::BinaryBlock::Axis::X) {
+      roi.x_values = std::move(block.values);
+    } else {
+      roi.y_values = std::move(block.values);
+      roi.rows = static_cast<std::size_t>(block.rows);
+    }
+  }
+  return data;
+}
+
+AcquisitionData& AcquisitionData::operator=(const AcquisitionData& other) {
+  if (this != &other) {
+    this->release_buffers();
+    this->acquisition_list = other.acquisition_list;
+    this->acquisition_timestamp = other.acquisition_timestamp;
+    this->buffer_pool = other.buffer_pool;
+  }
+  return *this;
+}
+
+AcquisitionData& AcquisitionData::operator=(AcquisitionData&& other) noexcept {
+  if (this != &other) {
+    this->release_buffers();
+    this->acquisition_list = std::move(other.acquisition_list);
+    this->acquisition_timestamp = std::move(other.acquisition_timestamp);
+    this->buffer_pool = std::move(other.buffer_pool);
+  }
+  return *this;
+}
+
+AcquisitionData::~AcquisitionData() { this->release_buffers(); }
+
+void AcquisitionData::set_buffer_pool(
+    std::shared_ptr<common::BufferPool<double>> buffers) {
+  this->buffer_pool = std::move(buffers);
+}
+
+void AcquisitionData::release_buffers() {
+  if (this->buffer_pool) {
+    this->release_buffers(*this->buffer_pool);
+    return;
+  }
+  this->acquisition_list.clear();
+  this->acquisition_timestamp.clear();
+}
+
+void AcquisitionData::release_buffers(common::BufferPool<double>& buffers) {
+  for (auto& acquisition : this->acquisition_list) {
+    for (auto& roi : acquisition.regions_of_interest) {
+      buffers.release(std::move(roi.x_values));
+      buffers.release(std::move(roi.y_values));
+    }
+  }
+  this->acquisition_list.clear();
+  this->acquisition_timestamp.clear();
+}
+
+RegionOfInterestData& AcquisitionData::block_region(
+    const communication::BinaryBlock& block) {
+  for (auto& acquisition : this->acquisition_list) {
+    if (acquisition.index != block.acquisition_index) {
+      continue;
+    }
+    for (auto& roi : acquisition.regions_of_interest) {
+      if (roi.index == block.roi_index) {
+        return roi;
+      }
+    }
+  }
+  throw std::runtime_error(
+      "binary block of acquisition " + std::to_string(block.acquisition_index) +
+      " and roi " + std::to_string(block.roi_index) +
+      " has no matching metadata");
+}
+
+const std::vector<Acquisition>& AcquisitionData::acquisitions() const {
+  return this->acquisition_list;
+}
+
+const std::string& AcquisitionData::timestamp() const {
+  return this->acquisition_timestamp;
+}
+
+} /* namespace horiba::devices::single_devices */
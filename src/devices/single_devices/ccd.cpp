@@ -1,26 +1,85 @@
+#include <horiba_cpp_sdk/common/logging.h>
 #include <horiba_cpp_sdk/devices/single_devices/ccd.h>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <optional>
 #include <sstream>
+#include <thread>
 #include <unordered_map>
+#include <utility>
 
+#include "horiba_cpp_sdk/common/async_backoff.h"
+#include "horiba_cpp_sdk/common/exponential_backoff.h"
 #include "horiba_cpp_sdk/communication/command.h"
 
 namespace horiba::devices::single_devices {
 
 using namespace nlohmann;
 
+namespace {
+
+void remember_region_of_interest(
+    ChargeCoupledDevice::AcquisitionSettings& settings,
+    const ChargeCoupledDevice::RegionOfInterest& roi) {
+  auto known_roi = std::find_if(
+      settings.regions_of_interest.begin(), settings.regions_of_interest.end(),
+      [&roi](const auto& candidate) { return candidate.index == roi.index; });
+  if (known_roi == settings.regions_of_interest.end()) {
+    settings.regions_of_interest.push_back(roi);
+  } else {
+    *known_roi = roi;
+  }
+}
+
+/**
+ * @brief Number of values along an axis once binned, a partial bin counting as
+ * a value.
+ */
+std::size_t binned_size(int size, int bin) {
+  const auto values = static_cast<std::size_t>(std::max(size, 0));
+  const auto bin_size = static_cast<std::size_t>(std::max(bin, 1));
+  return std::max<std::size_t>((values + bin_size - 1) / bin_size, 1);
+}
+
+template <typename T>
+bool differs(const std::optional<T>& wanted, const std::optional<T>& known) {
+  return wanted.has_value() && wanted != known;
+}
+
+/**
+ * @brief Builds the command setting a value back, none if the value is not
+ * known.
+ */
+template <typename T, typename MakeCommand>
+std::optional<communication::Command> restore_command(
+    const std::optional<T>& known, MakeCommand make_command) {
+  if (!known) {
+    return std::nullopt;
+  }
+  return make_command(*known);
+}
+
+} /* namespace */
+
 ChargeCoupledDevice::ChargeCoupledDevice(
     int id, std::shared_ptr<communication::Communicator> communicator)
     : Device(id, communicator) {}
 
 void ChargeCoupledDevice::open() {
+  this->clear_configuration();
+  this->clear_known_settings();
   Device::open();
   auto _ignored_response = Device::execute_command(
       communication::Command("ccd_open", {{"index", Device::device_id()}}));
 }
 
 void ChargeCoupledDevice::close() {
+  this->join_streaming_thread();
+  this->clear_configuration();
+  this->clear_known_settings();
   auto _ignored_response = Device::execute_command(
       communication::Command("ccd_close", {{"index", Device::device_id()}}));
 }
@@ -28,53 +87,86 @@ void ChargeCoupledDevice::close() {
 bool ChargeCoupledDevice::is_open() {
   auto response = Device::execute_command(
       communication::Command("ccd_isOpen", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   return json_results.at("open").get<bool>();
 }
 
 void ChargeCoupledDevice::restart() {
+  this->join_streaming_thread();
+  this->clear_configuration();
+  this->clear_known_settings();
   auto _ignored_response = Device::execute_command(
       communication::Command("ccd_restart", {{"index", Device::device_id()}}));
 }
 
 nlohmann::json ChargeCoupledDevice::get_configuration() {
+  return this->configuration()->json();
+}
+
+std::shared_ptr<const ChargeCoupledDeviceConfiguration>
+ChargeCoupledDevice::configuration() {
+  {
+    const std::lock_guard<std::mutex> lock(this->configuration_mutex);
+    if (this->cached_configuration) {
+      return this->cached_configuration;
+    }
+  }
+
   auto response = Device::execute_command(communication::Command(
       "ccd_getConfig", {{"index", Device::device_id()}}));
-  auto results = response.json_results();
-  return results["configuration"];
+  auto configuration = std::make_shared<const ChargeCoupledDeviceConfiguration>(
+      response.json_results().at("configuration"));
+
+  const std::lock_guard<std::mutex> lock(this->configuration_mutex);
+  this->cached_configuration = configuration;
+  return configuration;
+}
+
+void ChargeCoupledDevice::clear_configuration() {
+  const std::lock_guard<std::mutex> lock(this->configuration_mutex);
+  this->cached_configuration.reset();
 }
 
 int ChargeCoupledDevice::get_gain_token() {
   auto response = Device::execute_command(
       communication::Command("ccd_getGain", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   auto gain = json_results.at("token").get<int>();
+  this->update_known_settings(
+      response, [gain](auto& settings) { settings.gain_token = gain; });
   return gain;
 }
 
 void ChargeCoupledDevice::set_gain(int gain_token) {
-  auto _ignored_response = Device::execute_command(communication::Command(
-      "ccd_setGain", {{"index", Device::device_id()}, {"token", gain_token}}));
+  this->configuration()->validate_gain(gain_token);
+  auto response = Device::execute_command(this->gain_command(gain_token));
+  this->update_known_settings(response, [gain_token](auto& settings) {
+    settings.gain_token = gain_token;
+  });
 }
 
 int ChargeCoupledDevice::get_speed_token() {
   auto response = Device::execute_command(
       communication::Command("ccd_getSpeed", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   auto speed = json_results.at("token").get<int>();
+  this->update_known_settings(
+      response, [speed](auto& settings) { settings.speed_token = speed; });
   return speed;
 }
 
 void ChargeCoupledDevice::set_speed(int speed_token) {
-  auto _ignored_response = Device::execute_command(communication::Command(
-      "ccd_setSpeed",
-      {{"index", Device::device_id()}, {"token", speed_token}}));
+  this->configuration()->validate_speed(speed_token);
+  auto response = Device::execute_command(this->speed_command(speed_token));
+  this->update_known_settings(response, [speed_token](auto& settings) {
+    settings.speed_token = speed_token;
+  });
 }
 
 std::vector<int> ChargeCoupledDevice::get_fit_parameters() {
   auto response = Device::execute_command(communication::Command(
       "ccd_getFitParams", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   auto fit_params = json_results.at("fitParameters").get<std::vector<int>>();
   return fit_params;
 }
@@ -89,66 +181,85 @@ ChargeCoupledDevice::TimerResolution
 ChargeCoupledDevice::get_timer_resolution() {
   auto response = Device::execute_command(communication::Command(
       "ccd_getTimerResolution", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
-  auto timer_resolution = json_results.at("resolutionToken").get<int>();
-  return static_cast<ChargeCoupledDevice::TimerResolution>(timer_resolution);
+  const auto& json_results = response.json_results();
+  auto timer_resolution = static_cast<ChargeCoupledDevice::TimerResolution>(
+      json_results.at("resolutionToken").get<int>());
+  this->update_known_settings(response, [timer_resolution](auto& settings) {
+    settings.timer_resolution = timer_resolution;
+  });
+  return timer_resolution;
 }
 
 void ChargeCoupledDevice::set_timer_resolution(
     ChargeCoupledDevice::TimerResolution timer_resolution) {
-  auto _ignored_response = Device::execute_command(communication::Command(
-      "ccd_setTimerResolution",
-      {{"index", Device::device_id()}, {"resolutionToken", timer_resolution}
-
-      }));
+  auto response =
+      Device::execute_command(this->timer_resolution_command(timer_resolution));
+  this->update_known_settings(response, [timer_resolution](auto& settings) {
+    settings.timer_resolution = timer_resolution;
+  });
 }
 
 void ChargeCoupledDevice::set_acquisition_format(
     int number_of_rois, AcquisitionFormat acquisition_format) {
-  auto _ignored_response = Device::execute_command(communication::Command(
-      "ccd_setAcqFormat", {{"index", Device::device_id()},
-                           {"format", static_cast<int>(acquisition_format)},
-                           {"numberOfRois", number_of_rois}}));
+  auto response = Device::execute_command(
+      this->acquisition_format_command(number_of_rois, acquisition_format));
+  this->update_known_settings(
+      response, [number_of_rois, acquisition_format](auto& settings) {
+        settings.acquisition_format = acquisition_format;
+        settings.number_of_rois = number_of_rois;
+      });
 }
 
 ChargeCoupledDevice::XAxisConversionType
 ChargeCoupledDevice::get_x_axis_conversion_type() {
   auto response = Device::execute_command(communication::Command(
       "ccd_getXAxisConversionType", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
-  auto x_axis_conversion_type = json_results.at("type").get<int>();
+  const auto& json_results = response.json_results();
+  auto x_axis_conversion_type =
+      static_cast<ChargeCoupledDevice::XAxisConversionType>(
+          json_results.at("type").get<int>());
+  this->update_known_settings(
+      response, [x_axis_conversion_type](auto& settings) {
+        settings.x_axis_conversion_type = x_axis_conversion_type;
+      });
 
-  return static_cast<ChargeCoupledDevice::XAxisConversionType>(
-      x_axis_conversion_type);
+  return x_axis_conversion_type;
 }
 
 void ChargeCoupledDevice::set_x_axis_conversion_type(
     ChargeCoupledDevice::XAxisConversionType conversion_type) {
-  auto _ignored_response = Device::execute_command(
-      communication::Command("ccd_setXAxisConversionType",
-                             {{"index", Device::device_id()},
-                              {"type", static_cast<int>(conversion_type)}}));
+  auto response = Device::execute_command(
+      this->x_axis_conversion_type_command(conversion_type));
+  this->update_known_settings(response, [conversion_type](auto& settings) {
+    settings.x_axis_conversion_type = conversion_type;
+  });
 }
 
 int ChargeCoupledDevice::get_acquisition_count() {
   auto response = Device::execute_command(communication::Command(
       "ccd_getAcqCount", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   auto acquisition_count = json_results.at("count").get<int>();
+  this->update_known_settings(response, [acquisition_count](auto& settings) {
+    settings.acquisition_count = acquisition_count;
+  });
 
   return acquisition_count;
 }
 
 void ChargeCoupledDevice::set_acquisition_count(int count) {
-  auto _ignored_response = Device::execute_command(communication::Command(
-      "ccd_setAcqCount", {{"index", Device::device_id()}, {"count", count}}));
+  auto response =
+      Device::execute_command(this->acquisition_count_command(count));
+  this->update_known_settings(response, [count](auto& settings) {
+    settings.acquisition_count = count;
+  });
 }
 
 std::pair<int, ChargeCoupledDevice::CleanCountMode>
 ChargeCoupledDevice::get_clean_count() {
   auto response = Device::execute_command(communication::Command(
       "ccd_getCleanCount", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   auto acquisition_count = json_results.at("count").get<int>();
   auto acquisition_mode = static_cast<ChargeCoupledDevice::CleanCountMode>(
       json_results.at("mode").get<int>());
@@ -166,7 +277,7 @@ void ChargeCoupledDevice::set_clean_count(
 int ChargeCoupledDevice::get_acquisition_data_size() {
   auto response = Device::execute_command(communication::Command(
       "ccd_getDataSize", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   auto data_size = json_results.at("size").get<int>();
 
   return data_size;
@@ -175,7 +286,7 @@ int ChargeCoupledDevice::get_acquisition_data_size() {
 double ChargeCoupledDevice::get_temperature() {
   auto response = Device::execute_command(communication::Command(
       "ccd_getChipTemperature", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   auto temperature = json_results.at("temperature").get<double>();
 
   return temperature;
@@ -184,7 +295,7 @@ double ChargeCoupledDevice::get_temperature() {
 std::pair<int, int> ChargeCoupledDevice::get_chip_size() {
   auto response = Device::execute_command(communication::Command(
       "ccd_getChipSize", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   auto x = json_results.at("x").get<int>();
   auto y = json_results.at("y").get<int>();
 
@@ -194,22 +305,26 @@ std::pair<int, int> ChargeCoupledDevice::get_chip_size() {
 int ChargeCoupledDevice::get_exposure_time() {
   auto response = Device::execute_command(communication::Command(
       "ccd_getExposureTime", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   auto time = json_results.at("time").get<int>();
+  this->update_known_settings(
+      response, [time](auto& settings) { settings.exposure_time = time; });
 
   return time;
 }
 
 void ChargeCoupledDevice::set_exposure_time(int exposure_time_ms) {
-  auto _ignored_response = Device::execute_command(communication::Command(
-      "ccd_setExposureTime",
-      {{"index", Device::device_id()}, {"time", exposure_time_ms}}));
+  auto response =
+      Device::execute_command(this->exposure_time_command(exposure_time_ms));
+  this->update_known_settings(response, [exposure_time_ms](auto& settings) {
+    settings.exposure_time = exposure_time_ms;
+  });
 }
 
 std::tuple<bool, int, int, int> ChargeCoupledDevice::get_trigger_input() {
   auto response = Device::execute_command(communication::Command(
       "ccd_getTriggerIn", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   auto address = json_results.at("address").get<int>();
   auto event = json_results.at("event").get<int>();
   auto signal_type = json_results.at("signalType").get<int>();
@@ -233,44 +348,7 @@ void ChargeCoupledDevice::set_trigger_input(bool enabled, int address,
     return;
   }
 
-  auto config = get_configuration();
-  auto it_triggers = config.find("triggers");
-  if (it_triggers == config.end()) {
-    throw std::runtime_error("Triggers not found in the configuration");
-  }
-
-  const auto& triggers = it_triggers;
-  auto found_triggers = std::find_if(triggers->begin(), triggers->end(),
-                                     [&address](const nlohmann::json& trigger) {
-                                       return trigger["token"] == address;
-                                     });
-
-  if (found_triggers == triggers->end()) {
-    throw std::runtime_error("Trigger address " + std::to_string(address) +
-                             " not found in the configuration");
-  }
-
-  auto found_events = std::find_if(
-      (*found_triggers)["events"].begin(), (*found_triggers)["events"].end(),
-      [&event](const nlohmann::json& trigger_event) {
-        return trigger_event["token"] == event;
-      });
-
-  if (found_events == (*found_triggers)["events"].end()) {
-    throw std::runtime_error("Trigger event " + std::to_string(event) +
-                             " not found in the configuration");
-  }
-
-  auto found_signal_types = std::find_if(
-      (*found_events)["types"].begin(), (*found_events)["types"].end(),
-      [&signal_type](const nlohmann::json& signal) {
-        return signal["token"] == signal_type;
-      });
-
-  if (found_signal_types == (*found_events)["types"].end()) {
-    throw std::runtime_error("Trigger type " + std::to_string(signal_type) +
-                             " not found in the configuration");
-  }
+  this->configuration()->validate_trigger_input(address, event, signal_type);
 
   auto _ignored_response = Device::execute_command(communication::Command(
       "ccd_setTriggerIn", {{"index", Device::device_id()},
@@ -283,7 +361,7 @@ void ChargeCoupledDevice::set_trigger_input(bool enabled, int address,
 std::tuple<bool, int, int, int> ChargeCoupledDevice::get_signal_output() {
   auto response = Device::execute_command(communication::Command(
       "ccd_getSignalOut", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   auto address = json_results.at("address").get<int>();
   auto event = json_results.at("event").get<int>();
   auto signal_type = json_results.at("signalType").get<int>();
@@ -307,44 +385,7 @@ void ChargeCoupledDevice::set_signal_output(bool enabled, int address,
     return;
   }
 
-  auto config = get_configuration();
-  auto it_signals = config.find("signals");
-  if (it_signals == config.end()) {
-    throw std::runtime_error("Signals not found in the configuration");
-  }
-
-  const auto& signals = it_signals;
-  auto found_triggers = std::find_if(signals->begin(), signals->end(),
-                                     [&address](const nlohmann::json& trigger) {
-                                       return trigger["token"] == address;
-                                     });
-
-  if (found_triggers == signals->end()) {
-    throw std::runtime_error("Signal address " + std::to_string(address) +
-                             " not found in the configuration");
-  }
-
-  auto found_events = std::find_if(
-      (*found_triggers)["events"].begin(), (*found_triggers)["events"].end(),
-      [&event](const nlohmann::json& trigger_event) {
-        return trigger_event["token"] == event;
-      });
-
-  if (found_events == (*found_triggers)["events"].end()) {
-    throw std::runtime_error("Signal event " + std::to_string(event) +
-                             " not found in the configuration");
-  }
-
-  auto found_signal_types = std::find_if(
-      (*found_events)["types"].begin(), (*found_events)["types"].end(),
-      [&signal_type](const nlohmann::json& signal) {
-        return signal["token"] == signal_type;
-      });
-
-  if (found_signal_types == (*found_events)["types"].end()) {
-    throw std::runtime_error("Signal type " + std::to_string(signal_type) +
-                             " not found in the configuration");
-  }
+  this->configuration()->validate_signal_output(address, event, signal_type);
 
   auto _ignored_response = Device::execute_command(communication::Command(
       "ccd_setSignalOut", {{"index", Device::device_id()},
@@ -357,7 +398,7 @@ void ChargeCoupledDevice::set_signal_output(bool enabled, int address,
 bool ChargeCoupledDevice::get_acquisition_ready() {
   auto response = Device::execute_command(communication::Command(
       "ccd_getAcquisitionReady", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   auto ready = json_results.at("ready").get<bool>();
 
   return ready;
@@ -373,36 +414,562 @@ void ChargeCoupledDevice::set_region_of_interest(int roi_index, int x_origin,
                                                  int y_origin, int x_size,
                                                  int y_size, int x_bin,
                                                  int y_bin) {
-  auto _ignored_response = Device::execute_command(
-      communication::Command("ccd_setRoi", {{"index", Device::device_id()},
-                                            {"roiIndex", roi_index},
-                                            {"xOrigin", x_origin},
-                                            {"yOrigin", y_origin},
-                                            {"xSize", x_size},
-                                            {"ySize", y_size},
-                                            {"xBin", x_bin},
-                                            {"yBin", y_bin}}));
+  const RegionOfInterest roi{roi_index, x_origin, y_origin, x_size,
+                             y_size,    x_bin,    y_bin};
+  auto response =
+      Device::execute_command(this->region_of_interest_command(roi));
+  this->update_known_settings(response, [&roi](auto& settings) {
+    remember_region_of_interest(settings, roi);
+  });
 }
 
-std::any ChargeCoupledDevice::get_acquisition_data() {
+AcquisitionData ChargeCoupledDevice::get_acquisition_data() {
   auto response = Device::execute_command(communication::Command(
       "ccd_getAcquisitionData", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
-  return json_results.at("acquisition");
+  return this->acquisition_data(response);
+}
+
+void ChargeCoupledDevice::get_acquisition_data(AcquisitionData& data) {
+  if (const auto buffers = Device::buffer_pool()) {
+    data.release_buffers(*buffers);
+  }
+  data = this->get_acquisition_data();
+}
+
+void ChargeCoupledDevice::set_acquisition_buffer_size(std::size_t frames) {
+  const auto buffers = Device::buffer_pool();
+  if (!buffers) {
+    return;
+  }
+
+  std::vector<RegionOfInterest> regions_of_interest;
+  {
+    const std::lock_guard<std::mutex> lock(this->known_settings_mutex);
+    regions_of_interest = this->known_settings.regions_of_interest;
+  }
+  std::size_t columns = 0;
+  std::size_t values = 0;
+  if (regions_of_interest.empty()) {
+    // no binning known, a frame is at most the whole chip
+    const auto [width, height] = this->get_chip_size();
+    regions_of_interest.push_back(
+        RegionOfInterest{1, 0, 0, width, height, 1, 1});
+  }
+  for (const auto& roi : regions_of_interest) {
+    const auto roi_columns = binned_size(roi.x_size, roi.x_bin);
+    columns = std::max(columns, roi_columns);
+    values = std::max(values, roi_columns * binned_size(roi.y_size, roi.y_bin));
+  }
+
+  buffers->set_buffer_size(values);
+  // frame by frame, so that a pool too small for all the frames still gets
+  // whole frames
+  for (std::size_t i = 0; i < frames; ++i) {
+    buffers->preallocate(regions_of_interest.size(), values);
+    buffers->preallocate(regions_of_interest.size(), columns);
+  }
 }
 
 bool ChargeCoupledDevice::get_acquisition_busy() {
   auto response = Device::execute_command(communication::Command(
       "ccd_getAcquisitionBusy", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   auto ready = json_results.at("isBusy").get<bool>();
 
   return ready;
 }
 
+void ChargeCoupledDevice::apply_acquisition_settings(
+    const AcquisitionSettings& settings) {
+  if (settings.gain_token) {
+    this->configuration()->validate_gain(*settings.gain_token);
+  }
+  if (settings.speed_token) {
+    this->configuration()->validate_speed(*settings.speed_token);
+  }
+
+  AcquisitionSettings known;
+  {
+    const std::lock_guard<std::mutex> lock(this->known_settings_mutex);
+    known = this->known_settings;
+  }
+
+  std::vector<communication::Command> commands;
+  std::vector<std::function<void(AcquisitionSettings&)>> updates;
+  // set the known values back if the ICL rejects another setting of the batch
+  std::vector<std::function<std::optional<communication::Command>()>> restores;
+
+  if (differs(settings.acquisition_format, known.acquisition_format) ||
+      (settings.acquisition_format &&
+       settings.number_of_rois != known.number_of_rois)) {
+    commands.push_back(this->acquisition_format_command(
+        settings.number_of_rois, *settings.acquisition_format));
+    updates.emplace_back([&settings](auto& state) {
+      state.acquisition_format = settings.acquisition_format;
+      state.number_of_rois = settings.number_of_rois;
+    });
+    restores.emplace_back([this, &known] {
+      return restore_command(
+          known.acquisition_format, [this, &known](auto format) {
+            return this->acquisition_format_command(known.number_of_rois,
+                                                    format);
+          });
+    });
+  }
+  for (const auto& roi : settings.regions_of_interest) {
+    const auto known_roi = std::find_if(
+        known.regions_of_interest.begin(), known.regions_of_interest.end(),
+        [&roi](const auto& candidate) { return candidate.index == roi.index; });
+    if (known_roi != known.regions_of_interest.end() && *known_roi == roi) {
+      continue;
+    }
+    commands.push_back(this->region_of_interest_command(roi));
+    updates.emplace_back(
+        [&roi](auto& state) { remember_region_of_interest(state, roi); });
+    restores.emplace_back(
+        [this, known_roi, end = known.regions_of_interest.end()]()
+            -> std::optional<communication::Command> {
+          if (known_roi == end) {
+            return std::nullopt;
+          }
+          return this->region_of_interest_command(*known_roi);
+        });
+  }
+  if (differs(settings.acquisition_count, known.acquisition_count)) {
+    commands.push_back(
+        this->acquisition_count_command(*settings.acquisition_count));
+    updates.emplace_back([&settings](auto& state) {
+      state.acquisition_count = settings.acquisition_count;
+    });
+    restores.emplace_back([this, &known] {
+      return restore_command(known.acquisition_count, [this](int count) {
+        return this->acquisition_count_command(count);
+      });
+    });
+  }
+  if (differs(settings.x_axis_conversion_type, known.x_axis_conversion_type)) {
+    commands.push_back(
+        this->x_axis_conversion_type_command(*settings.x_axis_conversion_type));
+    updates.emplace_back([&settings](auto& state) {
+      state.x_axis_conversion_type = settings.x_axis_conversion_type;
+    });
+    restores.emplace_back([this, &known] {
+      return restore_command(known.x_axis_conversion_type, [this](auto type) {
+        return this->x_axis_conversion_type_command(type);
+      });
+    });
+  }
+  if (differs(settings.timer_resolution, known.timer_resolution)) {
+    commands.push_back(
+        this->timer_resolution_command(*settings.timer_resolution));
+    updates.emplace_back([&settings](auto& state) {
+      state.timer_resolution = settings.timer_resolution;
+    });
+    restores.emplace_back([this, &known] {
+      return restore_command(known.timer_resolution, [this](auto resolution) {
+        return this->timer_resolution_command(resolution);
+      });
+    });
+  }
+  if (differs(settings.exposure_time, known.exposure_time)) {
+    commands.push_back(this->exposure_time_command(*settings.exposure_time));
+    updates.emplace_back([&settings](auto& state) {
+      state.exposure_time = settings.exposure_time;
+    });
+    restores.emplace_back([this, &known] {
+      return restore_command(known.exposure_time, [this](int exposure_time) {
+        return this->exposure_time_command(exposure_time);
+      });
+    });
+  }
+  if (differs(settings.gain_token, known.gain_token)) {
+    commands.push_back(this->gain_command(*settings.gain_token));
+    updates.emplace_back(
+        [&settings](auto& state) { state.gain_token = settings.gain_token; });
+    restores.emplace_back([this, &known] {
+      return restore_command(known.gain_token, [this](int gain_token) {
+        return this->gain_command(gain_token);
+      });
+    });
+  }
+  if (differs(settings.speed_token, known.speed_token)) {
+    commands.push_back(this->speed_command(*settings.speed_token));
+    updates.emplace_back(
+        [&settings](auto& state) { state.speed_token = settings.speed_token; });
+    restores.emplace_back([this, &known] {
+      return restore_command(known.speed_token, [this](int speed_token) {
+        return this->speed_command(speed_token);
+      });
+    });
+  }
+
+  if (commands.empty()) {
+    spdlog::debug("[ChargeCoupledDevice] acquisition settings already applied");
+    return;
+  }
+
+  std::vector<communication::Response> responses;
+  try {
+    responses = Device::execute_commands(commands);
+  } catch (const std::exception&) {
+    // without all the responses, the state of the CCD is unknown
+    this->clear_known_settings();
+    throw;
+  }
+
+  const auto rejected = std::find_if(
+      responses.begin(), responses.end(),
+      [](const auto& response) { return !response.errors().empty(); });
+  if (rejected == responses.end()) {
+    for (std::size_t i = 0; i < responses.size(); ++i) {
+      this->update_known_settings(responses[i], updates[i]);
+    }
+    return;
+  }
+
+  const auto& rejected_command =
+      commands[static_cast<std::size_t>(rejected - responses.begin())];
+  spdlog::error("[ChargeCoupledDevice] {} rejected, restoring the settings",
+                rejected_command.name());
+  this->restore_acquisition_settings(responses, restores);
+  throw std::runtime_error("failed to apply acquisition settings, " +
+                           rejected_command.name() + ": " +
+                           rejected->errors().front());
+}
+
+void ChargeCoupledDevice::restore_acquisition_settings(
+    const std::vector<communication::Response>& responses,
+    const std::vector<std::function<std::optional<communication::Command>()>>&
+        restores) {
+  // the commands of the batch are all sent before any response is read, the
+  // settings after the rejected one got applied too
+  std::vector<communication::Command> commands;
+  bool restorable = true;
+  for (std::size_t i = 0; i < responses.size(); ++i) {
+    if (!responses[i].errors().empty()) {
+      continue;
+    }
+    auto command = restores[i]();
+    if (!command) {
+      restorable = false;
+      continue;
+    }
+    commands.push_back(std::move(*command));
+  }
+
+  try {
+    if (!commands.empty()) {
+      for (const auto& response : Device::execute_commands(commands)) {
+        restorable = restorable && response.errors().empty();
+      }
+    }
+  } catch (const std::exception& e) {
+    spdlog::error("[ChargeCoupledDevice] Failed to restore the settings: {}",
+                  e.what());
+    restorable = false;
+  }
+
+  if (!restorable) {
+    // some of the settings of the batch stay applied, the known state is
+    // dropped so that they are all sent again next time
+    this->clear_known_settings();
+  }
+}
+
+void ChargeCoupledDevice::wait_for_acquisition(
+    std::chrono::milliseconds timeout, std::stop_token stop_token) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  const auto exposure_time = this->exposure_duration();
+
+  const auto initial_delay =
+      std::clamp(std::chrono::duration_cast<std::chrono::milliseconds>(
+                     exposure_time / 10),
+                 std::chrono::milliseconds(1), std::chrono::milliseconds(100));
+  const auto exposure_end = std::min(
+      deadline, std::chrono::steady_clock::now() +
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        exposure_time));
+
+  const bool done =
+      common::sleep_for(exposure_end - std::chrono::steady_clock::now(),
+                        stop_token) &&
+      common::poll_until(
+          [this] { return !this->get_acquisition_busy(); }, deadline,
+          common::ExponentialBackoff{initial_delay,
+                                     std::chrono::milliseconds(500)},
+          stop_token);
+  if (done) {
+    return;
+  }
+
+  if (stop_token.stop_requested()) {
+    throw std::runtime_error("waiting for the acquisition got cancelled");
+  }
+  throw std::runtime_error(
+      "timeout reached while waiting for the acquisition to be done");
+}
+
+boost::asio::awaitable<void> ChargeCoupledDevice::wait_for_acquisition_async(
+    std::chrono::milliseconds timeout) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+  // querying the exposure time would cost two more round trips, the busy
+  // state is polled right away instead
+  auto initial_delay = std::chrono::milliseconds(10);
+  if (const auto exposure_time = this->known_exposure_duration()) {
+    initial_delay =
+        std::clamp(std::chrono::duration_cast<std::chrono::milliseconds>(
+                       *exposure_time / 10),
+                   std::chrono::milliseconds(1),
+                   std::chrono::milliseconds(100));
+    co_await common::async_sleep_until(
+        std::min(deadline, std::chrono::steady_clock::now() +
+                               std::chrono::duration_cast<
+                                   std::chrono::steady_clock::duration>(
+                                   *exposure_time)));
+  }
+
+  const bool done = co_await common::async_poll_until(
+      [this]() -> boost::asio::awaitable<bool> {
+        co_return !co_await this->get_acquisition_busy_async();
+      },
+      deadline,
+      common::ExponentialBackoff{initial_delay,
+                                 std::chrono::milliseconds(500)});
+  if (!done) {
+    throw std::runtime_error(
+        "timeout reached while waiting for the acquisition to be done");
+  }
+}
+
+boost::asio::awaitable<bool> ChargeCoupledDevice::get_acquisition_busy_async() {
+  const communication::Command command("ccd_getAcquisitionBusy",
+                                       {{"index", Device::device_id()}});
+  auto response = co_await Device::execute_command_async(command);
+  const auto& json_results = response.json_results();
+  co_return json_results.at("isBusy").get<bool>();
+}
+
+boost::asio::awaitable<AcquisitionData>
+ChargeCoupledDevice::get_acquisition_data_async() {
+  const communication::Command command("ccd_getAcquisitionData",
+                                       {{"index", Device::device_id()}});
+  auto response = co_await Device::execute_command_async(command);
+  co_return this->acquisition_data(response);
+}
+
+boost::asio::awaitable<AcquisitionData> ChargeCoupledDevice::acquire_async(
+    bool open_shutter, std::chrono::milliseconds timeout) {
+  const communication::Command command(
+      "ccd_setAcquisitionStart",
+      {{"index", Device::device_id()}, {"openShutter", open_shutter}});
+  auto _ignored_response = co_await Device::execute_command_async(command);
+  co_await this->wait_for_acquisition_async(timeout);
+  co_return co_await this->get_acquisition_data_async();
+}
+
 void ChargeCoupledDevice::abort_acquisition(bool reset_port) {
   auto _ignored_response = Device::execute_command(communication::Command(
       "ccd_setAcquisitionAbort",
       {{"index", Device::device_id()}, {"resetPort", reset_port}}));
 }
+
+void ChargeCoupledDevice::update_known_settings(
+    const communication::Response& response,
+    const std::function<void(AcquisitionSettings&)>& update) {
+  if (!response.errors().empty()) {
+    return;
+  }
+  const std::lock_guard<std::mutex> lock(this->known_settings_mutex);
+  update(this->known_settings);
+}
+
+void ChargeCoupledDevice::clear_known_settings() {
+  const std::lock_guard<std::mutex> lock(this->known_settings_mutex);
+  this->known_settings = AcquisitionSettings{};
+}
+
+void ChargeCoupledDevice::start_streaming(
+    std::size_t frame_slots, bool open_shutter,
+    std::chrono::milliseconds frame_timeout) {
+  if (this->streaming_thread.joinable()) {
+    throw std::runtime_error("CCD is already streaming");
+  }
+
+  this->streamed_frames =
+      std::make_unique<common::SpscRingBuffer<AcquisitionData>>(frame_slots);
+  this->streaming_error = nullptr;
+  this->streaming = true;
+  this->streaming_thread = std::jthread(
+      [this, open_shutter, frame_timeout](std::stop_token stop_token) {
+        this->stream(stop_token, open_shutter, frame_timeout);
+      });
+}
+
+void ChargeCoupledDevice::stop_streaming() {
+  this->join_streaming_thread();
+  if (this->streaming_error) {
+    std::rethrow_exception(std::exchange(this->streaming_error, nullptr));
+  }
+}
+
+bool ChargeCoupledDevice::is_streaming() const { return this->streaming; }
+
+bool ChargeCoupledDevice::try_pop_frame(AcquisitionData& frame) {
+  return this->streamed_frames && this->streamed_frames->try_pop(frame);
+}
+
+std::uint64_t ChargeCoupledDevice::dropped_frames() const {
+  return this->streamed_frames ? this->streamed_frames->dropped() : 0;
+}
+
+void ChargeCoupledDevice::stream(std::stop_token stop_token, bool open_shutter,
+                                 std::chrono::milliseconds frame_timeout) {
+  spdlog::debug("[ChargeCoupledDevice] streaming started");
+  AcquisitionData frame;
+  try {
+    // the frames in the ring and the one being parsed
+    this->set_acquisition_buffer_size(this->streamed_frames->capacity() + 1);
+    while (!stop_token.stop_requested()) {
+      this->set_acquisition_start(open_shutter);
+      this->wait_for_acquisition(frame_timeout, stop_token);
+      this->get_acquisition_data(frame);
+      if (!this->streamed_frames->try_push(frame)) {
+        HORIBA_LOG_DEBUG("[ChargeCoupledDevice] frame dropped, {} so far",
+                         this->streamed_frames->dropped());
+      }
+    }
+  } catch (const std::exception& e) {
+    if (!stop_token.stop_requested()) {
+      spdlog::error("[ChargeCoupledDevice] streaming failed: {}", e.what());
+      this->streaming_error = std::current_exception();
+    }
+  }
+
+  if (stop_token.stop_requested()) {
+    try {
+      this->abort_acquisition(false);
+    } catch (const std::exception& e) {
+      spdlog::warn("[ChargeCoupledDevice] failed to abort acquisition: {}",
+                   e.what());
+    }
+  }
+  this->streaming = false;
+  spdlog::debug("[ChargeCoupledDevice] streaming stopped");
+}
+
+void ChargeCoupledDevice::join_streaming_thread() {
+  if (!this->streaming_thread.joinable()) {
+    return;
+  }
+  this->streaming_thread.request_stop();
+  this->streaming_thread.join();
+  this->streaming_thread = std::jthread();
+}
+
+std::chrono::microseconds ChargeCoupledDevice::exposure_duration() {
+  std::optional<int> exposure_time;
+  std::optional<TimerResolution> timer_resolution;
+  {
+    const std::lock_guard<std::mutex> lock(this->known_settings_mutex);
+    exposure_time = this->known_settings.exposure_time;
+    timer_resolution = this->known_settings.timer_resolution;
+  }
+  // the last known settings spare two round trips per acquisition
+  const int exposure_time_units =
+      exposure_time ? *exposure_time : this->get_exposure_time();
+  const TimerResolution resolution =
+      timer_resolution ? *timer_resolution : this->get_timer_resolution();
+  if (resolution == TimerResolution::ONE_MICROSECOND) {
+    return std::chrono::microseconds(exposure_time_units);
+  }
+  return std::chrono::milliseconds(exposure_time_units);
+}
+
+std::optional<std::chrono::microseconds>
+ChargeCoupledDevice::known_exposure_duration() {
+  const std::lock_guard<std::mutex> lock(this->known_settings_mutex);
+  if (!this->known_settings.exposure_time ||
+      !this->known_settings.timer_resolution) {
+    return std::nullopt;
+  }
+  if (*this->known_settings.timer_resolution ==
+      TimerResolution::ONE_MICROSECOND) {
+    return std::chrono::microseconds(*this->known_settings.exposure_time);
+  }
+  return std::chrono::milliseconds(*this->known_settings.exposure_time);
+}
+
+AcquisitionData ChargeCoupledDevice::acquisition_data(
+    communication::Response& response) {
+  const auto& json_results = response.json_results();
+  if (!response.binary_blocks().empty()) {
+    auto data = AcquisitionData::from_binary_message(
+        json_results, response.take_binary_blocks());
+    // the buffers of the blocks come from the pool, they go back once the
+    // caller drops the data
+    data.set_buffer_pool(Device::buffer_pool());
+    return data;
+  }
+  return AcquisitionData::from_json(json_results);
+}
+
+communication::Command ChargeCoupledDevice::acquisition_format_command(
+    int number_of_rois, AcquisitionFormat acquisition_format) const {
+  return communication::Command(
+      "ccd_setAcqFormat", {{"index", Device::device_id()},
+                           {"format", static_cast<int>(acquisition_format)},
+                           {"numberOfRois", number_of_rois}});
+}
+
+communication::Command ChargeCoupledDevice::acquisition_count_command(
+    int count) const {
+  return communication::Command(
+      "ccd_setAcqCount", {{"index", Device::device_id()}, {"count", count}});
+}
+
+communication::Command ChargeCoupledDevice::x_axis_conversion_type_command(
+    XAxisConversionType conversion_type) const {
+  return communication::Command(
+      "ccd_setXAxisConversionType",
+      {{"index", Device::device_id()},
+       {"type", static_cast<int>(conversion_type)}});
+}
+
+communication::Command ChargeCoupledDevice::timer_resolution_command(
+    TimerResolution timer_resolution) const {
+  return communication::Command(
+      "ccd_setTimerResolution",
+      {{"index", Device::device_id()}, {"resolutionToken", timer_resolution}});
+}
+
+communication::Command ChargeCoupledDevice::exposure_time_command(
+    int exposure_time_ms) const {
+  return communication::Command(
+      "ccd_setExposureTime",
+      {{"index", Device::device_id()}, {"time", exposure_time_ms}});
+}
+
+communication::Command ChargeCoupledDevice::gain_command(int gain_token) const {
+  return communication::Command(
+      "ccd_setGain", {{"index", Device::device_id()}, {"token", gain_token}});
+}
+
+communication::Command ChargeCoupledDevice::speed_command(
+    int speed_token) const {
+  return communication::Command(
+      "ccd_setSpeed", {{"index", Device::device_id()}, {"token", speed_token}});
+}
+
+communication::Command ChargeCoupledDevice::region_of_interest_command(
+    const RegionOfInterest& roi) const {
+  return communication::Command("ccd_setRoi", {{"index", Device::device_id()},
+                                               {"roiIndex", roi.index},
+                                               {"xOrigin", roi.x_origin},
+                                               {"yOrigin", roi.y_origin},
+                                               {"xSize", roi.x_size},
+                                               {"ySize", roi.y_size},
+                                               {"xBin", roi.x_bin},
+                                               {"yBin", roi.y_bin}});
+}
 } /* namespace horiba::devices::single_devices */
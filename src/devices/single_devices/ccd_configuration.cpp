@@ -0,0 +1,140 @@
+#include "horiba_cpp_sdk/devices/single_devices/ccd_configuration.h"
+
+#include <functional>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace horiba::devices::single_devices {
+
+ChargeCoupledDeviceConfiguration::ChargeCoupledDeviceConfiguration(
+    nlohmann::json configuration)
+    : configuration(std::move(configuration)) {
+  if (!this->configuration.is_object()) {
+    return;
+  }
+  if (this->configuration.contains("gains")) {
+    this->gain_tokens = index_tokens(this->configuration["gains"]);
+  }
+  if (this->configuration.contains("speeds")) {
+    this->speed_tokens = index_tokens(this->configuration["speeds"]);
+  }
+  if (this->configuration.contains("triggers")) {
+    this->trigger_inputs = index_token_paths(this->configuration["triggers"]);
+  }
+  if (this->configuration.contains("signals")) {
+    this->signal_outputs = index_token_paths(this->configuration["signals"]);
+  }
+}
+
+const nlohmann::json& ChargeCoupledDeviceConfiguration::json() const {
+  return this->configuration;
+}
+
+bool ChargeCoupledDeviceConfiguration::has_gain(int gain_token) const {
+  return this->gain_tokens.paths.contains({gain_token, -1, -1});
+}
+
+bool ChargeCoupledDeviceConfiguration::has_speed(int speed_token) const {
+  return this->speed_tokens.paths.contains({speed_token, -1, -1});
+}
+
+void ChargeCoupledDeviceConfiguration::validate_gain(int gain_token) const {
+  validate(this->gain_tokens, "Gain", gain_token);
+}
+
+void ChargeCoupledDeviceConfiguration::validate_speed(int speed_token) const {
+  validate(this->speed_tokens, "Speed", speed_token);
+}
+
+void ChargeCoupledDeviceConfiguration::validate_trigger_input(
+    int address, int event, int signal_type) const {
+  validate(this->trigger_inputs, "Trigger", address, event, signal_type);
+}
+
+void ChargeCoupledDeviceConfiguration::validate_signal_output(
+    int address, int event, int signal_type) const {
+  validate(this->signal_outputs, "Signal", address, event, signal_type);
+}
+
+std::size_t ChargeCoupledDeviceConfiguration::TokenPathHash::operator()(
+    const TokenPath& path) const noexcept {
+  std::size_t seed = 0;
+  for (const int token : path) {
+    seed ^= std::hash<int>{}(token) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  }
+  return seed;
+}
+
+ChargeCoupledDeviceConfiguration::TokenIndex
+ChargeCoupledDeviceConfiguration::index_tokens(const nlohmann::json& entries) {
+  TokenIndex index;
+  index.available = true;
+  index.paths.reserve(entries.size());
+  for (const auto& entry : entries) {
+    index.paths.insert({entry.at("token").get<int>(), -1, -1});
+  }
+  return index;
+}
+
+ChargeCoupledDeviceConfiguration::TokenIndex
+ChargeCoupledDeviceConfiguration::index_token_paths(
+    const nlohmann::json& entries) {
+  TokenIndex index;
+  index.available = true;
+  for (const auto& address : entries) {
+    const int address_token = address.at("token").get<int>();
+    index.paths.insert({address_token, -1, -1});
+    if (!address.contains("events")) {
+      continue;
+    }
+    for (const auto& event : address["events"]) {
+      const int event_token = event.at("token").get<int>();
+      index.paths.insert({address_token, event_token, -1});
+      if (!event.contains("types")) {
+        continue;
+      }
+      for (const auto& type : event["types"]) {
+        index.paths.insert(
+            {address_token, event_token, type.at("token").get<int>()});
+      }
+    }
+  }
+  return index;
+}
+
+void ChargeCoupledDeviceConfiguration::validate(const TokenIndex& index,
+                                                const std::string& kind,
+                                                int token) {
+  if (!index.available) {
+    throw std::runtime_error(kind + "s not found in the configuration");
+  }
+  if (!index.paths.contains({token, -1, -1})) {
+    throw std::runtime_error(kind + " token " + std::to_string(token) +
+                             " not found in the configuration");
+  }
+}
+
+void ChargeCoupledDeviceConfiguration::validate(const TokenIndex& index,
+                                                const std::string& kind,
+                                                int address, int event,
+                                                int signal_type) {
+  if (!index.available) {
+    throw std::runtime_error(kind + "s not found in the configuration");
+  }
+  if (!index.paths.contains({address, -1, -1})) {
+    throw std::runtime_error(kind + " address " + std::to_string(address) +
+                             " not found in the configuration");
+  }
+  if (!index.paths.contains({address, event, -1})) {
+    throw std::runtime_error(kind + " event " + std::to_string(event) +
+                             " not found in the configuration");
+  }
+  if (!index.paths.contains({address, event, signal_type})) {
+    throw std::runtime_error(kind + " type " + std::to_string(signal_type) +
+                             " not found in the configuration");
+  }
+}
+
+} /* namespace horiba::devices::single_devices */
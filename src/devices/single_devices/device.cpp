@@ -1,8 +1,13 @@
+#include <horiba_cpp_sdk/communication/async_request.h>
 #include <horiba_cpp_sdk/communication/command.h>
 #include <horiba_cpp_sdk/devices/single_devices/device.h>
 #include <spdlog/spdlog.h>
 
+#include <boost/asio/use_awaitable.hpp>
+#include <exception>
+#include <future>
 #include <stdexcept>
+#include <vector>
 
 namespace horiba::devices::single_devices {
 
@@ -13,18 +18,36 @@ Device::Device(int id,
 void Device::open() {
   if (!this->communicator->is_open()) {
     spdlog::debug("[Device] communicator is closed, opening it.");
-    this->communicator->open();
+    try {
+      this->communicator->open();
+    } catch (const std::exception&) {
+      // another device sharing the communicator opened it in the meantime
+      if (!this->communicator->is_open()) {
+        throw;
+      }
+    }
     spdlog::debug("[Device] done");
   }
 }
 
+void Device::set_command_timeout(
+    std::optional<std::chrono::milliseconds> timeout) {
+  this->command_timeout = timeout;
+}
+
 communication::Response Device::execute_command(
     const communication::Command& command) {
+  return this->execute_command(command, this->command_options());
+}
+
+communication::Response Device::execute_command(
+    const communication::Command& command,
+    const communication::RequestOptions& options) {
   if (!this->communicator->is_open()) {
     throw std::runtime_error("communicator is not open");
   }
 
-  auto response = this->communicator->request_with_response(command);
+  auto response = this->communicator->request_with_response(command, options);
 
   if (!response.errors().empty()) {
     this->handle_errors(response.errors());
@@ -32,8 +55,73 @@ communication::Response Device::execute_command(
   return response;
 }
 
+boost::asio::awaitable<communication::Response> Device::execute_command_async(
+    communication::Command command) {
+  if (!this->communicator->is_open()) {
+    throw std::runtime_error("communicator is not open");
+  }
+
+  auto response = co_await communication::async_request(
+      *this->communicator, command, this->command_options(),
+      boost::asio::use_awaitable);
+
+  if (!response.errors().empty()) {
+    this->handle_errors(response.errors());
+  }
+  co_return response;
+}
+
+std::vector<communication::Response> Device::execute_commands(
+    const std::vector<communication::Command>& commands) {
+  if (!this->communicator->is_open()) {
+    throw std::runtime_error("communicator is not open");
+  }
+
+  // the whole batch has to be answered within the timeout
+  const auto options = this->command_options();
+  std::vector<std::future<communication::Response>> pending_responses;
+  pending_responses.reserve(commands.size());
+  for (const auto& command : commands) {
+    pending_responses.push_back(
+        this->communicator->request_with_response_async(command, options));
+  }
+
+  std::vector<communication::Response> responses;
+  responses.reserve(commands.size());
+  std::exception_ptr first_error = nullptr;
+  for (auto& pending_response : pending_responses) {
+    try {
+      responses.push_back(pending_response.get());
+    } catch (...) {
+      if (!first_error) {
+        first_error = std::current_exception();
+      }
+      continue;
+    }
+    if (!responses.back().errors().empty()) {
+      this->handle_errors(responses.back().errors());
+    }
+  }
+
+  if (first_error) {
+    std::rethrow_exception(first_error);
+  }
+  return responses;
+}
+
 int Device::device_id() const { return this->id; }
 
+std::shared_ptr<common::BufferPool<double>> Device::buffer_pool() const {
+  return this->communicator->buffer_pool();
+}
+
+communication::RequestOptions Device::command_options() const {
+  if (!this->command_timeout) {
+    return {};
+  }
+  return communication::RequestOptions::within(*this->command_timeout);
+}
+
 void Device::handle_errors(const std::vector<std::string>& errors) {
   for (const auto& error : errors) {
     spdlog::error(error);
@@ -1,7 +1,10 @@
+#include <horiba_cpp_sdk/common/async_backoff.h>
+#include <horiba_cpp_sdk/common/exponential_backoff.h>
 #include <horiba_cpp_sdk/communication/command.h>
 #include <horiba_cpp_sdk/devices/single_devices/mono.h>
 
-#include <thread>
+#include <chrono>
+#include <stdexcept>
 
 namespace horiba::devices::single_devices {
 using namespace nlohmann;
@@ -23,14 +26,14 @@ void Monochromator::close() {
 bool Monochromator::is_open() {
   auto response = Device::execute_command(
       communication::Command("mono_isOpen", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   return json_results.at("open").get<bool>();
 }
 
 bool Monochromator::is_busy() {
   auto response = Device::execute_command(
       communication::Command("mono_isBusy", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   return json_results.at("busy").get<bool>();
 }
 
@@ -42,14 +45,14 @@ void Monochromator::home() {
 std::string Monochromator::configuration() {
   auto response = Device::execute_command(communication::Command(
       "mono_getConfig", {{"index", Device::device_id()}, {"compact", false}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   return json_results.dump();
 }
 
 double Monochromator::get_current_wavelength() {
   auto response = Device::execute_command(communication::Command(
       "mono_getPosition", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   return json_results.at("wavelength").get<double>();
 }
 
@@ -68,7 +71,7 @@ void Monochromator::move_to_target_wavelength(double wavelength) {
 Monochromator::Grating Monochromator::get_turret_grating() {
   auto response = Device::execute_command(communication::Command(
       "mono_getGratingPosition", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   auto grating = json_results.at("position").get<int>();
 
   return static_cast<Monochromator::Grating>(grating);
@@ -86,7 +89,7 @@ Monochromator::FilterWheelPosition Monochromator::get_filter_wheel_position(
       communication::Command("mono_getFilterWheelPosition",
                              {{"index", Device::device_id()},
                               {"locationId", static_cast<int>(filter_wheel)}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   auto position = json_results.at("position").get<int>();
 
   return static_cast<Monochromator::FilterWheelPosition>(position);
@@ -105,7 +108,7 @@ Monochromator::MirrorPosition Monochromator::get_mirror_position(
   auto response = Device::execute_command(communication::Command(
       "mono_getMirrorPosition", {{"index", Device::device_id()},
                                  {"locationId", static_cast<int>(mirror)}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   auto position = json_results.at("position").get<int>();
 
   return static_cast<Monochromator::MirrorPosition>(position);
@@ -123,7 +126,7 @@ double Monochromator::get_slit_position_in_mm(Slit slit) {
   auto response = Device::execute_command(communication::Command(
       "mono_getSlitPositionInMM", {{"index", Device::device_id()},
                                    {"locationId", static_cast<int>(slit)}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   auto position = json_results.at("position").get<double>();
 
   return position;
@@ -140,7 +143,7 @@ int Monochromator::get_slit_step_position(Slit slit) {
   auto response = Device::execute_command(communication::Command(
       "mono_getSlitStepPosition", {{"index", Device::device_id()},
                                    {"locationId", static_cast<int>(slit)}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   auto position = json_results.at("position").get<int>();
 
   return position;
@@ -167,7 +170,7 @@ Monochromator::ShutterPosition Monochromator::get_shutter_position(
     Shutter shutter) {
   auto response = Device::execute_command(communication::Command(
       "mono_getShutterStatus", {{"index", Device::device_id()}}));
-  auto json_results = response.json_results();
+  const auto& json_results = response.json_results();
   ShutterPosition position = ShutterPosition::CLOSED;
   if (shutter == Shutter::FIRST) {
     position = json_results.at("shutter 1").get<ShutterPosition>();
@@ -178,16 +181,62 @@ Monochromator::ShutterPosition Monochromator::get_shutter_position(
   return position;
 }
 
-void Monochromator::wait_until_ready(std::chrono::seconds timeout) {
-  std::this_thread::sleep_for(std::chrono::seconds(1));
-
-  int current_timeout_s = 0;
-  while (this->is_busy() && current_timeout_s < timeout.count()) {
-    std::this_thread::sleep_for(std::chrono::seconds(1));
-    current_timeout_s++;
+void Monochromator::wait_until_ready(std::chrono::milliseconds timeout) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  const bool ready = common::poll_until(
+      [this] { return !this->is_busy(); }, deadline,
+      common::ExponentialBackoff{std::chrono::milliseconds(10),
+                                 std::chrono::milliseconds(500)});
+  if (!ready) {
+    throw std::runtime_error(
+        "timeout reached while waiting for monochromator to be ready");
   }
+}
 
-  if (this->is_busy()) {
+boost::asio::awaitable<bool> Monochromator::is_busy_async() {
+  const communication::Command command("mono_isBusy",
+                                       {{"index", Device::device_id()}});
+  auto response = co_await Device::execute_command_async(command);
+  const auto& json_results = response.json_results();
+  co_return json_results.at("busy").get<bool>();
+}
+
+boost::asio::awaitable<double> Monochromator::get_current_wavelength_async() {
+  const communication::Command command("mono_getPosition",
+                                       {{"index", Device::device_id()}});
+  auto response = co_await Device::execute_command_async(command);
+  const auto& json_results = response.json_results();
+  co_return json_results.at("wavelength").get<double>();
+}
+
+boost::asio::awaitable<void> Monochromator::move_to_target_wavelength_async(
+    double wavelength, std::chrono::milliseconds timeout) {
+  const communication::Command command(
+      "mono_moveToPosition",
+      {{"index", Device::device_id()}, {"wavelength", wavelength}});
+  auto _ignored_response = co_await Device::execute_command_async(command);
+  co_await this->wait_until_ready_async(timeout);
+}
+
+boost::asio::awaitable<void> Monochromator::home_async(
+    std::chrono::milliseconds timeout) {
+  const communication::Command command("mono_init",
+                                       {{"index", Device::device_id()}});
+  auto _ignored_response = co_await Device::execute_command_async(command);
+  co_await this->wait_until_ready_async(timeout);
+}
+
+boost::asio::awaitable<void> Monochromator::wait_until_ready_async(
+    std::chrono::milliseconds timeout) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  const bool ready = co_await common::async_poll_until(
+      [this]() -> boost::asio::awaitable<bool> {
+        co_return !co_await this->is_busy_async();
+      },
+      deadline,
+      common::ExponentialBackoff{std::chrono::milliseconds(10),
+                                 std::chrono::milliseconds(500)});
+  if (!ready) {
     throw std::runtime_error(
         "timeout reached while waiting for monochromator to be ready");
   }
@@ -81,27 +81,16 @@ auto main(int argc, char *argv[]) -> int {
     if (ccd->get_acquisition_ready()) {
       auto open_shutter = true;
       ccd->set_acquisition_start(open_shutter);
-      // wait a short time for the acquisition to start
-      this_thread::sleep_for(chrono::milliseconds(200));
+      ccd->wait_for_acquisition(timeout);
 
-      while (ccd->get_acquisition_busy()) {
-        this_thread::sleep_for(chrono::milliseconds(500));
-      }
+      const auto acquisition_data = ccd->get_acquisition_data();
+      const auto &roi =
+          acquisition_data.acquisitions()[0].regions_of_interest[0];
 
-      auto raw_data = any_cast<json>(ccd->get_acquisition_data());
-      auto xy_data = raw_data[0]["roi"][0]["xyData"];
-      cout << xy_data << endl;
-
-      auto x_data =
-          xy_data | views::transform([](const auto &pair) { return pair[0]; });
-      auto y_data =
-          xy_data | views::transform([](const auto &pair) { return pair[1]; });
-
-      vector<double> x_values;
-      vector<int> y_values;
-
-      ranges::copy(x_data, back_inserter(x_values));
-      ranges::copy(y_data, back_inserter(y_values));
+      const vector<double> x_values(roi.x_values.begin(),
+                                    roi.x_values.end());
+      const vector<double> y_values(roi.y_values.begin(),
+                                    roi.y_values.end());
 
       plot(x_values, y_values);
       title("Center Scan At Wavelength " + to_string(target_wavelength) + "nm");
@@ -0,0 +1,315 @@
+#include <horiba_cpp_sdk/common/exponential_backoff.h>
+#include <horiba_cpp_sdk/os/posix_process.h>
+#include <poll.h>
+#include <spawn.h>
+#include <spdlog/spdlog.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+extern char** environ;
+
+#if defined(__linux__) && defined(SYS_pidfd_open) && \
+    defined(SYS_pidfd_send_signal)
+#define HORIBA_HAS_PIDFD
+#endif
+
+namespace horiba::os {
+
+namespace {
+
+std::runtime_error errno_error(const std::string& what, int error_number) {
+  return std::runtime_error(what + ": " +
+                            std::generic_category().message(error_number));
+}
+
+bool accepts_connections(const std::string& host, const std::string& port,
+                         std::chrono::steady_clock::time_point deadline) {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::resolver resolver{context};
+  boost::asio::ip::tcp::socket socket{context};
+  boost::asio::steady_timer timer{context, deadline};
+  bool connected = false;
+
+  // neither the resolution nor a connection to an unresponsive host may
+  // outlast the probe
+  timer.async_wait([&resolver, &socket](boost::system::error_code error) {
+    if (!error) {
+      resolver.cancel();
+      boost::system::error_code ignored;
+      socket.close(ignored);
+    }
+  });
+  resolver.async_resolve(
+      host, port,
+      [&socket, &timer, &connected](
+          boost::system::error_code error,
+          const boost::asio::ip::tcp::resolver::results_type& endpoints) {
+        if (error) {
+          timer.cancel();
+          return;
+        }
+        boost::asio::async_connect(
+            socket, endpoints,
+            [&timer, &connected](boost::system::error_code connect_error,
+                                 const boost::asio::ip::tcp::endpoint&) {
+              connected = !connect_error;
+              timer.cancel();
+            });
+      });
+  context.run();
+  return connected;
+}
+
+}  // namespace
+
+PosixProcess::PosixProcess(std::string process_path, std::string process_name,
+                           std::vector<std::string> arguments)
+    : process_path{std::move(process_path)},
+      process_name{std::move(process_name)},
+      arguments{std::move(arguments)} {}
+
+PosixProcess::~PosixProcess() {
+  // like the ICL on Windows, the process outlives this instance unless
+  // stopped, it is only reaped if it already exited
+  if (this->child && this->process_id > 0) {
+    int status = 0;
+    waitpid(this->process_id, &status, WNOHANG);
+  }
+  this->forget_process();
+}
+
+void PosixProcess::wait_for_port(std::string host, std::string port,
+                                 std::chrono::milliseconds timeout) {
+  this->readiness_probe =
+      ReadinessProbe{std::move(host), std::move(port), timeout};
+}
+
+void PosixProcess::set_stop_timeout(std::chrono::milliseconds timeout) {
+  this->stop_timeout = timeout;
+}
+
+void PosixProcess::start() {
+  if (this->running()) {
+    spdlog::info("[PosixProcess] '{}' is running, not starting it.",
+                 this->process_name);
+    return;
+  }
+  spdlog::info("[PosixProcess] '{}' is not running, starting it.",
+               this->process_name);
+  this->spawn();
+
+  if (!this->readiness_probe) {
+    return;
+  }
+  try {
+    this->wait_until_ready(*this->readiness_probe);
+  } catch (const std::exception&) {
+    this->stop();
+    throw;
+  }
+}
+
+bool PosixProcess::running() {
+  if (this->process_id > 0 && !this->exited()) {
+    return true;
+  }
+  this->forget_process();
+
+  const auto found_process = this->find_process();
+  if (found_process) {
+    this->track_process(*found_process, false);
+  }
+  spdlog::debug("[PosixProcess] '{}' is running: {}", this->process_name,
+                found_process.has_value());
+  return found_process.has_value();
+}
+
+void PosixProcess::stop() {
+  if (!this->running()) {
+    spdlog::info("[PosixProcess] '{}' is not running, not stopping it.",
+                 this->process_name);
+    return;
+  }
+
+  spdlog::info("[PosixProcess] '{}' is running, stopping it.",
+               this->process_name);
+  this->signal(SIGTERM);
+  if (!this->wait_for_exit(this->stop_timeout)) {
+    spdlog::warn("[PosixProcess] '{}' did not exit within {} ms, killing it.",
+                 this->process_name, this->stop_timeout.count());
+    this->signal(SIGKILL);
+    this->wait_for_exit(this->stop_timeout);
+  }
+  this->forget_process();
+}
+
+void PosixProcess::spawn() {
+  const auto full_path = this->process_path + this->process_name;
+  std::vector<std::string> argument_strings{full_path};
+  argument_strings.insert(argument_strings.end(), this->arguments.begin(),
+                          this->arguments.end());
+  std::vector<char*> argv;
+  argv.reserve(argument_strings.size() + 1);
+  for (auto& argument : argument_strings) {
+    argv.push_back(argument.data());
+  }
+  argv.push_back(nullptr);
+
+  spdlog::debug("[PosixProcess] Starting process: {}", full_path);
+  pid_t pid = 0;
+  // without a folder, the executable is searched in the PATH
+  const int result =
+      this->process_path.empty()
+          ? posix_spawnp(&pid, full_path.c_str(), nullptr, nullptr,
+                         argv.data(), environ)
+          : posix_spawn(&pid, full_path.c_str(), nullptr, nullptr, argv.data(),
+                        environ);
+  if (result != 0) {
+    spdlog::error("[PosixProcess] Failed to start process: {}",
+                  std::strerror(result));
+    throw errno_error("failed to start '" + full_path + "' process", result);
+  }
+  this->track_process(pid, true);
+  spdlog::debug("[PosixProcess] Process started: {} ({})", full_path, pid);
+}
+
+void PosixProcess::wait_until_ready(const ReadinessProbe& probe) {
+  const auto start = std::chrono::steady_clock::now();
+  const auto deadline = start + probe.timeout;
+  bool process_exited = false;
+  const bool ready = common::poll_until(
+      [this, &probe, &process_exited, deadline] {
+        if (this->exited()) {
+          process_exited = true;
+          return true;
+        }
+        return accepts_connections(probe.host, probe.port, deadline);
+      },
+      deadline,
+      common::ExponentialBackoff{std::chrono::milliseconds(5),
+                                 std::chrono::milliseconds(200)});
+  if (process_exited) {
+    spdlog::error("[PosixProcess] '{}' exited while starting",
+                  this->process_name);
+    throw std::runtime_error("'" + this->process_name +
+                             "' exited while starting");
+  }
+  if (!ready) {
+    spdlog::error("[PosixProcess] '{}' not accepting connections on {}:{}",
+                  this->process_name, probe.host, probe.port);
+    throw std::runtime_error("'" + this->process_name +
+                             "' not accepting connections on " + probe.host +
+                             ":" + probe.port);
+  }
+  spdlog::debug("[PosixProcess] '{}' ready in {} ms", this->process_name,
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count());
+}
+
+bool PosixProcess::exited() {
+  if (this->child) {
+    int status = 0;
+    const auto result = waitpid(this->process_id, &status, WNOHANG);
+    // reaped, or reaped by someone else
+    return result == this->process_id || (result < 0 && errno == ECHILD);
+  }
+  return kill(this->process_id, 0) != 0 && errno == ESRCH;
+}
+
+bool PosixProcess::wait_for_exit(std::chrono::milliseconds timeout) {
+#ifdef HORIBA_HAS_PIDFD
+  if (this->process_fd >= 0) {
+    // the pidfd becomes readable once the process exited
+    pollfd process_poll{this->process_fd, POLLIN, 0};
+    if (poll(&process_poll, 1, static_cast<int>(timeout.count())) <= 0) {
+      return false;
+    }
+    if (this->child) {
+      int status = 0;
+      waitpid(this->process_id, &status, 0);
+    }
+    return true;
+  }
+#endif
+  return common::poll_until(
+      [this] { return this->exited(); },
+      std::chrono::steady_clock::now() + timeout,
+      common::ExponentialBackoff{std::chrono::milliseconds(1),
+                                 std::chrono::milliseconds(100)});
+}
+
+void PosixProcess::signal(int signal_number) {
+  int result = 0;
+#ifdef HORIBA_HAS_PIDFD
+  if (this->process_fd >= 0) {
+    result = static_cast<int>(syscall(SYS_pidfd_send_signal, this->process_fd,
+                                      signal_number, nullptr, 0));
+  } else {
+    result = kill(this->process_id, signal_number);
+  }
+#else
+  result = kill(this->process_id, signal_number);
+#endif
+  if (result != 0 && errno != ESRCH) {
+    const int error_number = errno;
+    spdlog::error("[PosixProcess] Failed to signal '{}': {}",
+                  this->process_name, std::strerror(error_number));
+    throw errno_error("failed to signal '" + this->process_name + "'",
+                       error_number);
+  }
+}
+
+void PosixProcess::track_process(pid_t pid, bool spawned) {
+  this->process_id = pid;
+  this->child = spawned;
+#ifdef HORIBA_HAS_PIDFD
+  // kernels older than 5.3 do not have pidfds, the process id is used then
+  this->process_fd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+#endif
+}
+
+void PosixProcess::forget_process() {
+  if (this->process_fd >= 0) {
+    close(this->process_fd);
+  }
+  this->process_fd = -1;
+  this->process_id = 0;
+  this->child = false;
+}
+
+std::optional<pid_t> PosixProcess::find_process() const {
+#ifdef __linux__
+  std::error_code error;
+  for (const auto& entry :
+       std::filesystem::directory_iterator("/proc", error)) {
+    const auto& file_name = entry.path().filename().string();
+    if (file_name.find_first_not_of("0123456789") != std::string::npos) {
+      continue;
+    }
+    // the executable is only readable for the processes of the user
+    const auto executable =
+        std::filesystem::read_symlink(entry.path() / "exe", error);
+    if (!error && executable.filename() == this->process_name) {
+      return static_cast<pid_t>(std::stol(file_name));
+    }
+  }
+#endif
+  return std::nullopt;
+}
+
+} /* namespace horiba::os */
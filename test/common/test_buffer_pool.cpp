@@ -0,0 +1,106 @@
+#include <horiba_cpp_sdk/common/buffer_pool.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <utility>
+
+namespace horiba::test {
+using namespace horiba::common;
+
+TEST_CASE("Buffer pool", "[buffer_pool]") {
+  SECTION("Released buffers are acquired again, empty") {
+    // arrange
+    BufferPool<double> pool;
+    auto buffer = pool.acquire(100);
+    buffer.assign(100, 1.0);
+    const auto* const data = buffer.data();
+
+    // act
+    pool.release(std::move(buffer));
+    const auto available = pool.available();
+    auto reused = pool.acquire(100);
+
+    // assert
+    REQUIRE(available == 1);
+    REQUIRE(reused.data() == data);
+    REQUIRE(reused.empty());
+    REQUIRE(reused.capacity() >= 100);
+    REQUIRE(pool.available() == 0);
+  }
+
+  SECTION("The smallest buffer large enough is acquired") {
+    // arrange
+    BufferPool<double> pool;
+    auto small = pool.acquire(10);
+    auto large = pool.acquire(1000);
+    const auto* const small_data = small.data();
+    const auto* const large_data = large.data();
+    pool.release(std::move(large));
+    pool.release(std::move(small));
+
+    // act
+    auto first = pool.acquire(500);
+    auto second = pool.acquire(5);
+
+    // assert
+    REQUIRE(first.data() == large_data);
+    REQUIRE(second.data() == small_data);
+  }
+
+  SECTION("The largest buffer is grown when none is large enough") {
+    // arrange
+    BufferPool<double> pool;
+    auto small = pool.acquire(10);
+    auto large = pool.acquire(20);
+    pool.release(std::move(small));
+    pool.release(std::move(large));
+
+    // act
+    auto buffer = pool.acquire(50);
+
+    // assert
+    REQUIRE(buffer.capacity() >= 50);
+    REQUIRE(pool.available() == 1);
+    REQUIRE(pool.acquire().capacity() == 10);
+  }
+
+  SECTION("Buffers released into a full pool are freed") {
+    // arrange
+    BufferPool<double> pool{1};
+
+    // act
+    pool.release(pool.acquire(10));
+    pool.release(AlignedVector<double>(10));
+    pool.release(AlignedVector<double>{});
+
+    // assert
+    REQUIRE(pool.available() == 1);
+  }
+
+  SECTION("Buffers can be allocated up front") {
+    // arrange
+    BufferPool<double> pool{3};
+
+    // act
+    pool.preallocate(2, 64);
+    pool.preallocate(2, 8);
+
+    // assert
+    REQUIRE(pool.available() == 3);
+    REQUIRE(pool.acquire().capacity() == 8);
+    REQUIRE(pool.acquire(64).capacity() == 64);
+    REQUIRE(pool.acquire(64).capacity() == 64);
+  }
+
+  SECTION("The size of frames can be set") {
+    // arrange
+    BufferPool<double> pool;
+
+    // act
+    pool.set_buffer_size(1024);
+
+    // assert
+    REQUIRE(pool.buffer_size() == 1024);
+  }
+}
+
+}  // namespace horiba::test
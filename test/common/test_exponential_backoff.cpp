@@ -0,0 +1,93 @@
+#include <horiba_cpp_sdk/common/exponential_backoff.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <stop_token>
+
+namespace horiba::test {
+using namespace horiba::common;
+using std::chrono::milliseconds;
+
+TEST_CASE("Exponential backoff", "[exponential_backoff]") {
+  SECTION("Delays grow up to the maximum delay") {
+    // arrange
+    ExponentialBackoff backoff{milliseconds(10), milliseconds(50)};
+
+    // act
+    const auto first = backoff.next_delay();
+    const auto second = backoff.next_delay();
+    const auto third = backoff.next_delay();
+    const auto fourth = backoff.next_delay();
+
+    // assert
+    REQUIRE(first == milliseconds(10));
+    REQUIRE(second == milliseconds(20));
+    REQUIRE(third == milliseconds(40));
+    REQUIRE(fourth == milliseconds(50));
+  }
+
+  SECTION("Delays restart from the initial delay after a reset") {
+    // arrange
+    ExponentialBackoff backoff{milliseconds(10), milliseconds(50)};
+    auto _ignored_delay = backoff.next_delay();
+    _ignored_delay = backoff.next_delay();
+
+    // act
+    backoff.reset();
+
+    // assert
+    REQUIRE(backoff.next_delay() == milliseconds(10));
+  }
+
+  SECTION("Polling stops as soon as the predicate is true") {
+    // arrange
+    int calls = 0;
+    const auto deadline = std::chrono::steady_clock::now() + milliseconds(500);
+
+    // act
+    const bool result = poll_until([&calls] { return ++calls == 3; }, deadline,
+                                   {milliseconds(1), milliseconds(5)});
+
+    // assert
+    REQUIRE(result);
+    REQUIRE(calls == 3);
+  }
+
+  SECTION("Polling does not exceed the deadline") {
+    // arrange
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + milliseconds(50);
+
+    // act
+    const bool result = poll_until([] { return false; }, deadline,
+                                   {milliseconds(1), milliseconds(1000)});
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // assert
+    REQUIRE_FALSE(result);
+    REQUIRE(elapsed >= milliseconds(50));
+    REQUIRE(elapsed < milliseconds(500));
+  }
+
+  SECTION("Polling stops when a stop is requested") {
+    // arrange
+    std::stop_source stop_source;
+    int calls = 0;
+    const auto deadline = std::chrono::steady_clock::now() + milliseconds(500);
+
+    // act
+    const bool result = poll_until(
+        [&calls, &stop_source] {
+          if (++calls == 2) {
+            stop_source.request_stop();
+          }
+          return false;
+        },
+        deadline, {milliseconds(1), milliseconds(5)}, stop_source.get_token());
+
+    // assert
+    REQUIRE_FALSE(result);
+    REQUIRE(calls == 2);
+  }
+}
+}  // namespace horiba::test
@@ -0,0 +1,80 @@
+#include <horiba_cpp_sdk/common/logging.h>
+#include <spdlog/spdlog.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+namespace horiba::test {
+using namespace horiba::common;
+
+TEST_CASE("Logging facade", "[logging]") {
+  const auto previous_level = spdlog::get_level();
+  const auto previous_max_size = max_logged_payload_size().load();
+
+  SECTION("Arguments of disabled logs are not evaluated") {
+    // arrange
+    spdlog::set_level(spdlog::level::info);
+    int evaluations = 0;
+    auto evaluate = [&evaluations] { return ++evaluations; };
+
+    // act
+    HORIBA_LOG_DEBUG("not logged: {}", evaluate());
+    HORIBA_LOG_INFO("logged: {}", evaluate());
+
+    // assert
+    REQUIRE(evaluations == 1);
+  }
+
+  SECTION("Small payloads are logged as is") {
+    // arrange
+    const nlohmann::json json = {{"index", 0}};
+
+    // act
+    const auto text = fmt::format("{}", log_payload(json));
+
+    // assert
+    REQUIRE(text == json.dump());
+  }
+
+  SECTION("Large payloads are truncated") {
+    // arrange
+    max_logged_payload_size() = 4;
+    const std::string payload = "0123456789";
+
+    // act
+    const auto text = fmt::format("{}", log_payload(payload));
+
+    // assert
+    REQUIRE(text == "0123... (10 bytes)");
+  }
+
+  SECTION("Large json payloads are only serialized up to the maximum size") {
+    // arrange
+    max_logged_payload_size() = 8;
+    const nlohmann::json json = {{"acquisition", std::vector<int>(100000, 1)}};
+
+    // act
+    const auto text = fmt::format("{}", log_payload(json));
+
+    // assert
+    REQUIRE(text == json.dump().substr(0, 8) + "... (truncated)");
+  }
+
+  SECTION("Json payloads of the maximum size are not truncated") {
+    // arrange
+    const nlohmann::json json = {{"index", 0}};
+    max_logged_payload_size() = json.dump().size();
+
+    // act
+    const auto text = fmt::format("{}", log_payload(json));
+
+    // assert
+    REQUIRE(text == json.dump());
+  }
+
+  spdlog::set_level(previous_level);
+  max_logged_payload_size() = previous_max_size;
+}
+}  // namespace horiba::test
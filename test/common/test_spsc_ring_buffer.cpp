@@ -0,0 +1,99 @@
+#include <horiba_cpp_sdk/common/spsc_ring_buffer.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <thread>
+#include <vector>
+
+namespace horiba::test {
+using namespace horiba::common;
+
+TEST_CASE("SPSC ring buffer", "[spsc_ring_buffer]") {
+  SECTION("Values are popped in the order they were pushed") {
+    // arrange
+    SpscRingBuffer<int> ring{4};
+    int first = 1;
+    int second = 2;
+    int popped = 0;
+
+    // act
+    ring.try_push(first);
+    ring.try_push(second);
+
+    // assert
+    REQUIRE(ring.size() == 2);
+    REQUIRE(ring.try_pop(popped));
+    REQUIRE(popped == 1);
+    REQUIRE(ring.try_pop(popped));
+    REQUIRE(popped == 2);
+    REQUIRE_FALSE(ring.try_pop(popped));
+  }
+
+  SECTION("Values pushed into a full ring are dropped") {
+    // arrange
+    SpscRingBuffer<int> ring{2};
+    int value = 0;
+
+    // act
+    const bool first_pushed = ring.try_push(value);
+    const bool second_pushed = ring.try_push(value);
+    const bool third_pushed = ring.try_push(value);
+
+    // assert
+    REQUIRE(first_pushed);
+    REQUIRE(second_pushed);
+    REQUIRE_FALSE(third_pushed);
+    REQUIRE(ring.size() == ring.capacity());
+    REQUIRE(ring.dropped() == 1);
+  }
+
+  SECTION("Buffers given back by the consumer are reused by the producer") {
+    // arrange
+    SpscRingBuffer<std::vector<double>> ring{1};
+    std::vector<double> frame(1024, 1.0);
+    std::vector<double> consumed(1024, 2.0);
+    const auto* consumed_buffer = consumed.data();
+
+    // act
+    ring.try_push(frame);
+    ring.try_pop(consumed);
+    // goes once around the ring, back to the slot holding the consumed buffer
+    ring.try_push(frame);
+    ring.try_pop(frame);
+    ring.try_push(frame);
+
+    // assert
+    REQUIRE(consumed.size() == 1024);
+    REQUIRE(consumed[0] == 1.0);
+    REQUIRE(frame.data() == consumed_buffer);
+  }
+
+  SECTION("Values are transferred between threads") {
+    // arrange
+    constexpr int values = 10000;
+    SpscRingBuffer<int> ring{16};
+    long long sum = 0;
+
+    // act
+    std::thread producer([&ring] {
+      for (int i = 1; i <= values; ++i) {
+        int value = i;
+        while (!ring.try_push(value)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+    int received = 0;
+    int value = 0;
+    while (received < values) {
+      if (ring.try_pop(value)) {
+        sum += value;
+        ++received;
+      }
+    }
+    producer.join();
+
+    // assert
+    REQUIRE(sum == static_cast<long long>(values) * (values + 1) / 2);
+  }
+}
+}  // namespace horiba::test
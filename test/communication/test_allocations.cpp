@@ -0,0 +1,290 @@
+#include <fake_icl/icl_server.h>
+#include <horiba_cpp_sdk/common/buffer_pool.h>
+#include <horiba_cpp_sdk/communication/command.h>
+#include <horiba_cpp_sdk/communication/response.h>
+#include <horiba_cpp_sdk/communication/websocket_communicator.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <catch2/catch_test_macros.hpp>
+#include <csignal>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Counts the allocations of every thread while counting is enabled, including
+// the I/O threads of the communicators. The global operators, aligned ones
+// included as used by common::AlignedAllocator, are replaced for this
+// executable only, they forward to malloc, aligned_alloc and free.
+namespace {
+std::atomic<bool> count_allocations{false};
+std::atomic<std::size_t> allocations{0};
+std::atomic<std::size_t> allocated_bytes{0};
+
+/**
+ * @brief Counts the allocations made by all threads during its lifetime.
+ */
+class AllocationCounter {
+ public:
+  AllocationCounter() {
+    allocations = 0;
+    allocated_bytes = 0;
+    count_allocations = true;
+  }
+  ~AllocationCounter() { count_allocations = false; }
+
+  AllocationCounter(const AllocationCounter&) = delete;
+  AllocationCounter& operator=(const AllocationCounter&) = delete;
+  AllocationCounter(AllocationCounter&&) = delete;
+  AllocationCounter& operator=(AllocationCounter&&) = delete;
+
+  [[nodiscard]] std::size_t count() const { return allocations; }
+  [[nodiscard]] std::size_t bytes() const { return allocated_bytes; }
+};
+
+void count_allocation(std::size_t size) {
+  if (count_allocations.load(std::memory_order_relaxed)) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  }
+}
+
+/**
+ * @brief Fake ICL served by a child process, so that its allocations are not
+ * counted.
+ *
+ * Forked before the test starts any thread, the child only serves the fake ICL
+ * until it is terminated.
+ */
+class ChildICLServer {
+ public:
+  explicit ChildICLServer(const horiba::fake_icl::ICLServerConfig& config) {
+    std::array<int, 2> port_pipe{};
+    if (pipe(port_pipe.data()) != 0) {
+      throw std::runtime_error("cannot create the port pipe");
+    }
+    this->process_id = fork();
+    if (this->process_id < 0) {
+      throw std::runtime_error("cannot fork the fake ICL");
+    }
+    if (this->process_id == 0) {
+      close(port_pipe[0]);
+      const horiba::fake_icl::ICLServer server(config);
+      const unsigned short server_port = server.port();
+      if (write(port_pipe[1], &server_port, sizeof(server_port)) !=
+          static_cast<ssize_t>(sizeof(server_port))) {
+        _exit(1);
+      }
+      while (true) {
+        pause();
+      }
+    }
+    close(port_pipe[1]);
+    const auto read_size =
+        read(port_pipe[0], &this->server_port, sizeof(this->server_port));
+    close(port_pipe[0]);
+    if (read_size != static_cast<ssize_t>(sizeof(this->server_port))) {
+      this->stop();
+      throw std::runtime_error("fake ICL did not start");
+    }
+  }
+  ~ChildICLServer() { this->stop(); }
+
+  ChildICLServer(const ChildICLServer&) = delete;
+  ChildICLServer& operator=(const ChildICLServer&) = delete;
+  ChildICLServer(ChildICLServer&&) = delete;
+  ChildICLServer& operator=(ChildICLServer&&) = delete;
+
+  [[nodiscard]] std::string port() const {
+    return std::to_string(this->server_port);
+  }
+
+ private:
+  pid_t process_id = -1;
+  unsigned short server_port = 0;
+
+  void stop() {
+    if (this->process_id > 0) {
+      kill(this->process_id, SIGTERM);
+      waitpid(this->process_id, nullptr, 0);
+      this->process_id = -1;
+    }
+  }
+};
+}  // namespace
+
+void* operator new(std::size_t size) {
+  count_allocation(size);
+  if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  count_allocation(size);
+  // aligned_alloc requires a size multiple of the alignment
+  const auto alignment_size = static_cast<std::size_t>(alignment);
+  const auto aligned_size =
+      (std::max<std::size_t>(size, 1) + alignment_size - 1) / alignment_size *
+      alignment_size;
+  if (void* memory = std::aligned_alloc(alignment_size, aligned_size)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+
+void operator delete(void* memory, std::size_t /*size*/) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t /*alignment*/) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t /*size*/,
+                     std::align_val_t /*alignment*/) noexcept {
+  std::free(memory);
+}
+
+namespace horiba::test {
+using namespace horiba::communication;
+
+TEST_CASE("Command path allocations", "[allocations]") {
+  SECTION("Serializing a command into a reused buffer does not allocate") {
+    // arrange
+    const Command command("ccd_setRoi", {{"index", 0},
+                                         {"roiIndex", 1},
+                                         {"xOrigin", 0},
+                                         {"yOrigin", 0},
+                                         {"xSize", 1024},
+                                         {"ySize", 256},
+                                         {"xBin", 1},
+                                         {"yBin", 256}});
+    std::string buffer;
+    command.serialize(buffer);
+
+    // act
+    std::size_t serialize_allocations = 0;
+    {
+      const AllocationCounter counter;
+      for (int i = 0; i < 100; ++i) {
+        command.serialize(buffer);
+      }
+      serialize_allocations = counter.count();
+    }
+
+    // assert
+    REQUIRE(serialize_allocations == 0);
+  }
+
+  SECTION("Reading a response does not copy it") {
+    // arrange
+    const Response response{42,
+                            "ccd_getAcquisitionData",
+                            {{"acquisition", std::vector<int>(1000, 1)}},
+                            {"error"}};
+
+    // act
+    std::size_t read_allocations = 0;
+    std::size_t read_values = 0;
+    {
+      const AllocationCounter counter;
+      for (int i = 0; i < 100; ++i) {
+        read_values += response.json_results().at("acquisition").size();
+        read_values += response.errors().size();
+      }
+      read_allocations = counter.count();
+    }
+
+    // assert
+    REQUIRE(read_allocations == 0);
+    REQUIRE(read_values == 100 * 1001);
+  }
+}
+
+TEST_CASE("Request path allocations with fake ICL", "[allocations]") {
+  // arrange
+  constexpr int COLUMNS = 1024;
+  constexpr int ROWS = 256;
+  constexpr int WARM_UP_REQUESTS = 20;
+  constexpr int REQUESTS = 100;
+  fake_icl::ICLServerConfig config;
+  config.port = 0;
+  config.synthetic_chip = fake_icl::ChipSize{COLUMNS, ROWS};
+  config.binary_messages = true;
+  const ChildICLServer server(config);
+  WebSocketCommunicator websocket_communicator("127.0.0.1", server.port());
+  websocket_communicator.open();
+
+  SECTION("A warm round trip allocates a bounded number of times") {
+    // arrange
+    // the parsed response and the asio operations still allocate, 36 times
+    // per round trip when measured, but nothing proportional to the message
+    constexpr std::size_t MAX_ALLOCATIONS_PER_REQUEST = 40;
+    const Command command("mono_isBusy", {{"index", 0}});
+    for (int i = 0; i < WARM_UP_REQUESTS; ++i) {
+      auto _ignored_response =
+          websocket_communicator.request_with_response(command);
+    }
+
+    // act
+    std::size_t request_allocations = 0;
+    {
+      const AllocationCounter counter;
+      for (int i = 0; i < REQUESTS; ++i) {
+        auto _ignored_response =
+            websocket_communicator.request_with_response(command);
+      }
+      request_allocations = counter.count();
+    }
+
+    // assert
+    REQUIRE(request_allocations <= REQUESTS * MAX_ALLOCATIONS_PER_REQUEST);
+  }
+
+  SECTION("Acquisition data is not copied on a warm round trip") {
+    // arrange
+    constexpr std::size_t acquisition_bytes =
+        static_cast<std::size_t>(COLUMNS) * ROWS * sizeof(double);
+    const Command command("ccd_getAcquisitionData", {{"index", 0}});
+    // the values are decoded into buffers of the pool, handed back once read
+    const auto buffers = websocket_communicator.buffer_pool();
+    const auto request_acquisition = [&websocket_communicator, &buffers,
+                                      &command] {
+      auto response = websocket_communicator.request_with_response(command);
+      for (auto& block : response.take_binary_blocks()) {
+        buffers->release(std::move(block.values));
+      }
+    };
+    for (int i = 0; i < WARM_UP_REQUESTS; ++i) {
+      request_acquisition();
+    }
+
+    // act
+    std::size_t request_bytes = 0;
+    {
+      const AllocationCounter counter;
+      for (int i = 0; i < REQUESTS; ++i) {
+        request_acquisition();
+      }
+      request_bytes = counter.bytes();
+    }
+
+    // assert
+    // a single copy of the values would already allocate their full size
+    REQUIRE(request_bytes / REQUESTS < acquisition_bytes / 4);
+  }
+
+  websocket_communicator.close();
+}
+}  // namespace horiba::test
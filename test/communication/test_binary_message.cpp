@@ -0,0 +1,101 @@
+#include <horiba_cpp_sdk/communication/binary_message.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <vector>
+
+namespace horiba::test {
+using namespace horiba::communication;
+
+TEST_CASE("Binary messages can be encoded and decoded", "[binary_message]") {
+  // arrange
+  const nlohmann::json metadata = {{"id", 42},
+                                   {"command", "ccd_getAcquisitionData"},
+                                   {"results", nlohmann::json::object()},
+                                   {"errors", nlohmann::json::array()}};
+
+  BinaryBlock x_block;
+  x_block.acquisition_index = 1;
+  x_block.roi_index = 1;
+  x_block.axis = BinaryBlock::Axis::X;
+  x_block.element_type = BinaryBlock::ElementType::FLOAT64;
+  x_block.values = {500.25, 500.5, 500.75};
+
+  BinaryBlock y_block;
+  y_block.acquisition_index = 1;
+  y_block.roi_index = 1;
+  y_block.axis = BinaryBlock::Axis::Y;
+  y_block.element_type = BinaryBlock::ElementType::UINT16;
+  y_block.values = {605, 607, 65535};
+
+  SECTION("Round trip keeps metadata and values") {
+    // act
+    const auto frame = BinaryMessage::encode(metadata, {x_block, y_block});
+    auto message = BinaryMessage::decode(frame);
+
+    // assert
+    REQUIRE(message.metadata() == metadata);
+    REQUIRE(message.blocks().size() == 2);
+    REQUIRE(message.blocks()[0].axis == BinaryBlock::Axis::X);
+    REQUIRE(message.blocks()[0].values == x_block.values);
+    REQUIRE(message.blocks()[1].axis == BinaryBlock::Axis::Y);
+    REQUIRE(message.blocks()[1].element_type ==
+            BinaryBlock::ElementType::UINT16);
+    REQUIRE(message.blocks()[1].values == y_block.values);
+  }
+
+  SECTION("Values are stored with the size of their element type") {
+    // act
+    const auto frame_f64 = BinaryMessage::encode(metadata, {x_block});
+    const auto frame_u16 = BinaryMessage::encode(metadata, {y_block});
+
+    // assert
+    REQUIRE(frame_f64.size() - frame_u16.size() ==
+            3 * (sizeof(double) - sizeof(std::uint16_t)));
+  }
+
+  SECTION("Truncated messages are rejected") {
+    // arrange
+    auto frame = BinaryMessage::encode(metadata, {x_block, y_block});
+    frame.resize(frame.size() - 1);
+
+    // act
+    // assert
+    REQUIRE_THROWS_AS(BinaryMessage::decode(frame), std::runtime_error);
+  }
+
+  SECTION("Counts larger than the frame are rejected before allocating") {
+    // arrange
+    const auto block_count_offset = 2 * sizeof(std::uint32_t) +
+                                    metadata.dump().size();
+    // after the block count and the block header fields before the count
+    const auto element_count_offset = block_count_offset + 12;
+    auto too_many_blocks = BinaryMessage::encode(metadata, {x_block});
+    auto too_many_elements = too_many_blocks;
+    for (std::size_t i = 0; i < sizeof(std::uint32_t); i++) {
+      too_many_blocks[block_count_offset + i] = std::byte{0xff};
+      too_many_elements[element_count_offset + i] = std::byte{0xff};
+    }
+    common::BufferPool<double> buffers;
+
+    // act
+    // assert
+    REQUIRE_THROWS_AS(BinaryMessage::decode(too_many_blocks, &buffers),
+                      std::runtime_error);
+    REQUIRE_THROWS_AS(BinaryMessage::decode(too_many_elements, &buffers),
+                      std::runtime_error);
+  }
+
+  SECTION("Messages with a wrong magic number are rejected") {
+    // arrange
+    auto frame = BinaryMessage::encode(metadata, {x_block});
+    frame[0] = std::byte{0};
+
+    // act
+    // assert
+    REQUIRE_THROWS_AS(BinaryMessage::decode(frame), std::runtime_error);
+  }
+}
+}  // namespace horiba::test
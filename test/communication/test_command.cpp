@@ -1,6 +1,7 @@
 #include <horiba_cpp_sdk/communication/command.h>
 
 #include <catch2/catch_test_macros.hpp>
+#include <string>
 #include <unordered_set>
 #include <vector>
 
@@ -18,6 +19,14 @@ TEST_CASE("A Command id is always incremented", "[command]") {
       ids.insert(id);
     }
   }
+
+  SECTION("The id of the json representation matches the command id") {
+    Command command("icl_info", {});
+
+    REQUIRE(command.json().at("id").get<unsigned long long int>() ==
+            command.id());
+    REQUIRE(command.name() == "icl_info");
+  }
 }
 
 TEST_CASE("Command parameters are correctly parsed", "[command]") {
@@ -58,4 +67,38 @@ TEST_CASE("Command parameters are correctly parsed", "[command]") {
     REQUIRE(parameters.dump() == expect_raw_json);
   }
 }
+
+TEST_CASE("Command serialization matches its json representation",
+          "[command]") {
+  SECTION("Without parameters") {
+    // arrange
+    Command command("icl_info", {});
+    std::string buffer;
+
+    // act
+    command.serialize(buffer);
+
+    // assert
+    REQUIRE(buffer == command.json().dump());
+  }
+
+  SECTION("With nested parameters of all types") {
+    // arrange
+    Command command("test", {{"index", 0},
+                             {"offset", -3},
+                             {"wavelength", 550.0},
+                             {"factor", 0.125},
+                             {"open", true},
+                             {"name", "quote \" backslash \\ tab \t"},
+                             {"list", {1, 2, 3}},
+                             {"nested", {{"b", nullptr}, {"a", "x"}}}});
+    std::string buffer = "previous content";
+
+    // act
+    command.serialize(buffer);
+
+    // assert
+    REQUIRE(buffer == command.json().dump());
+  }
+}
 }  // namespace horiba::test
@@ -0,0 +1,167 @@
+#include <horiba_cpp_sdk/communication/command_metrics.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace horiba::test {
+
+using namespace horiba::communication;
+
+TEST_CASE("Histogram test", "[histogram]") {
+  // arrange
+  Histogram histogram;
+
+  SECTION("Values are counted in power of two buckets") {
+    // act
+    histogram.add(0);
+    histogram.add(1);
+    histogram.add(2);
+    histogram.add(3);
+    histogram.add(1000);
+    const auto snapshot = histogram.snapshot();
+
+    // assert
+    REQUIRE(snapshot.count == 5);
+    REQUIRE(snapshot.sum == 1006);
+    REQUIRE(snapshot.max == 1000);
+    REQUIRE(snapshot.buckets[0] == 1);
+    REQUIRE(snapshot.buckets[1] == 1);
+    REQUIRE(snapshot.buckets[2] == 2);
+    REQUIRE(snapshot.buckets[10] == 1);
+  }
+
+  SECTION("Bucket upper bounds are exclusive powers of two") {
+    // act
+    // assert
+    REQUIRE(Histogram::Snapshot::upper_bound(0) == 1);
+    REQUIRE(Histogram::Snapshot::upper_bound(10) == 1024);
+    REQUIRE(Histogram::Snapshot::upper_bound(Histogram::BUCKETS - 1) ==
+            std::numeric_limits<std::uint64_t>::max());
+  }
+
+  SECTION("Largest values end up in the last bucket") {
+    // act
+    histogram.add(std::numeric_limits<std::uint64_t>::max());
+    const auto snapshot = histogram.snapshot();
+
+    // assert
+    REQUIRE(snapshot.buckets[Histogram::BUCKETS - 1] == 1);
+  }
+}
+
+TEST_CASE("CommandMetrics test", "[command_metrics]") {
+  // arrange
+  CommandMetrics metrics;
+  CommandSample sample;
+  sample.serialize_time = std::chrono::microseconds(3);
+  sample.round_trip_time = std::chrono::milliseconds(2);
+  sample.parse_time = std::chrono::microseconds(40);
+  sample.bytes_sent = 60;
+  sample.bytes_received = 300;
+
+  SECTION("Commands are recorded by name") {
+    // act
+    metrics.record("ccd_getChipSize", sample);
+    metrics.record("ccd_getChipSize", sample);
+    metrics.record("mono_isBusy", sample);
+    const auto snapshot = metrics.snapshot();
+
+    // assert
+    REQUIRE(snapshot.size() == 2);
+    REQUIRE(snapshot.at("ccd_getChipSize").round_trip_time_ns.count == 2);
+    REQUIRE(snapshot.at("ccd_getChipSize").round_trip_time_ns.sum == 4000000);
+    REQUIRE(snapshot.at("mono_isBusy").serialize_time_ns.max == 3000);
+    REQUIRE(snapshot.at("mono_isBusy").parse_time_ns.max == 40000);
+    REQUIRE(snapshot.at("mono_isBusy").bytes_sent.max == 60);
+    REQUIRE(snapshot.at("mono_isBusy").bytes_received.max == 300);
+  }
+
+  SECTION("Durations below a microsecond are recorded") {
+    // arrange
+    sample.serialize_time = std::chrono::nanoseconds(250);
+
+    // act
+    metrics.record("mono_isBusy", sample);
+    metrics.record("mono_isBusy", sample);
+
+    // assert
+    REQUIRE(metrics.snapshot().at("mono_isBusy").serialize_time_ns.sum == 500);
+  }
+
+  SECTION("Commands are recorded in their own metrics") {
+    // arrange
+    CommandMetrics other_metrics;
+
+    // act
+    metrics.record("ccd_getChipSize", sample);
+    other_metrics.record("ccd_getChipSize", sample);
+    metrics.record("ccd_getChipSize", sample);
+
+    // assert
+    REQUIRE(metrics.snapshot().at("ccd_getChipSize").bytes_sent.count == 2);
+    REQUIRE(other_metrics.snapshot().at("ccd_getChipSize").bytes_sent.count ==
+            1);
+  }
+
+  SECTION("Commands can be recorded from several threads") {
+    // arrange
+    constexpr int THREADS = 4;
+    constexpr int RECORDS = 1000;
+    std::vector<std::thread> threads;
+
+    // act
+    for (int thread = 0; thread < THREADS; thread++) {
+      threads.emplace_back([&metrics, &sample] {
+        for (int record = 0; record < RECORDS; record++) {
+          metrics.record("mono_isBusy", sample);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    // assert
+    REQUIRE(metrics.snapshot().at("mono_isBusy").bytes_sent.count ==
+            THREADS * RECORDS);
+  }
+
+  SECTION("Metrics can be exported as json") {
+    // act
+    metrics.record("ccd_getChipSize", sample);
+    const auto json_metrics = metrics.to_json();
+
+    // assert
+    const auto& round_trip = json_metrics.at("ccd_getChipSize").at(
+        "roundTripTimeNs");
+    REQUIRE(round_trip.at("count") == 1);
+    REQUIRE(round_trip.at("max") == 2000000);
+    // 2 ms falls in the bucket [2^20, 2^21) ns, the last written one
+    REQUIRE(round_trip.at("buckets").size() == 22);
+  }
+
+  SECTION("Metrics can be exported in the Prometheus text format") {
+    // act
+    metrics.record("ccd_getChipSize", sample);
+    const auto text = metrics.to_prometheus();
+
+    // assert
+    REQUIRE(text.find("# TYPE horiba_icl_command_round_trip_seconds "
+                      "histogram") != std::string::npos);
+    REQUIRE(text.find("horiba_icl_command_round_trip_seconds_count{command="
+                      "\"ccd_getChipSize\"} 1") != std::string::npos);
+    REQUIRE(text.find("horiba_icl_command_round_trip_seconds_sum{command="
+                      "\"ccd_getChipSize\"} 0.002\n") != std::string::npos);
+    REQUIRE(text.find("horiba_icl_command_sent_bytes_bucket{command="
+                      "\"ccd_getChipSize\",le=\"+Inf\"} 1") !=
+            std::string::npos);
+  }
+}
+
+}  // namespace horiba::test
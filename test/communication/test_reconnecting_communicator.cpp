@@ -0,0 +1,170 @@
+#include <fake_icl/icl_server.h>
+#include <horiba_cpp_sdk/common/exponential_backoff.h>
+#include <horiba_cpp_sdk/communication/command.h>
+#include <horiba_cpp_sdk/communication/reconnecting_communicator.h>
+#include <horiba_cpp_sdk/communication/response.h>
+#include <horiba_cpp_sdk/communication/websocket_communicator.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+
+namespace horiba::test {
+
+using horiba::communication::Command;
+using horiba::communication::ReconnectingCommunicator;
+using horiba::communication::ReconnectPolicy;
+using horiba::communication::RequestCancelledError;
+using horiba::communication::RequestOptions;
+using horiba::communication::RequestTimeoutError;
+using horiba::communication::RetryableRequestError;
+using horiba::communication::WebSocketCommunicator;
+
+TEST_CASE("ReconnectingCommunicator test", "[reconnecting_communicator]") {
+  // arrange
+  fake_icl::ICLServerConfig config;
+  config.port = 0;
+  fake_icl::CommandBehavior unanswered;
+  unanswered.drop_probability = 1.0;
+  config.command_behaviors["mono_init"] = unanswered;
+  std::optional<fake_icl::ICLServer> server;
+  server.emplace(config);
+  config.port = server->port();
+
+  auto websocket_communicator = std::make_shared<WebSocketCommunicator>(
+      "127.0.0.1", std::to_string(server->port()));
+  ReconnectPolicy policy;
+  policy.timeout = std::chrono::seconds(5);
+  ReconnectingCommunicator communicator(websocket_communicator, policy);
+  communicator.open();
+
+  const auto wait_for_lost_connection = [&websocket_communicator] {
+    return common::poll_until(
+        [&websocket_communicator] {
+          return !websocket_communicator->is_open();
+        },
+        std::chrono::steady_clock::now() + std::chrono::seconds(5),
+        common::ExponentialBackoff{std::chrono::milliseconds(1),
+                                   std::chrono::milliseconds(50)});
+  };
+
+  SECTION("Lost connections are restored with the session") {
+    // arrange
+    communicator.request_with_response(Command("ccd_open", {{"index", 0}}));
+    communicator.request_with_response(
+        Command("ccd_setExposureTime", {{"index", 0}, {"time", 10}}));
+    communicator.request_with_response(
+        Command("ccd_setExposureTime", {{"index", 0}, {"time", 20}}));
+    communicator.request_with_response(Command(
+        "ccd_setRoi", {{"index", 0}, {"roiIndex", 1}, {"xSize", 1024}}));
+    communicator.request_with_response(
+        Command("ccd_getExposureTime", {{"index", 0}}));
+    communicator.request_with_response(Command("mono_open", {{"index", 0}}));
+    communicator.request_with_response(Command("mono_close", {{"index", 0}}));
+
+    // act
+    server.reset();
+    REQUIRE(wait_for_lost_connection());
+    server.emplace(config);
+    const auto response = communicator.request_with_response(
+        Command("ccd_getExposureTime", {{"index", 0}}));
+
+    // assert
+    REQUIRE(response.errors().empty());
+    REQUIRE(communicator.is_open());
+    REQUIRE(communicator.reconnections() == 1);
+    // "ccd_open", the last exposure time and the roi, then the request
+    REQUIRE(server->received_commands() == 4);
+  }
+
+  SECTION("Requests in flight when the connection got lost are retryable") {
+    // arrange
+    auto pending_response = communicator.request_with_response_async(
+        Command("mono_init", {{"index", 0}}));
+
+    // act
+    server.reset();
+
+    // assert
+    REQUIRE_THROWS_AS(pending_response.get(), RetryableRequestError);
+    REQUIRE(communicator.is_open());
+    server.emplace(config);
+    REQUIRE_NOTHROW(communicator.request_with_response(
+        Command("mono_isBusy", {{"index", 0}})));
+  }
+
+  SECTION("Requests sent while the connection is lost do not block") {
+    // arrange
+    server.reset();
+    REQUIRE(wait_for_lost_connection());
+
+    // act
+    const auto start = std::chrono::steady_clock::now();
+    auto pending_response = communicator.request_with_response_async(
+        Command("mono_isBusy", {{"index", 0}}));
+    const auto sending_time = std::chrono::steady_clock::now() - start;
+    server.emplace(config);
+
+    // assert
+    REQUIRE(sending_time < std::chrono::milliseconds(50));
+    REQUIRE(pending_response.wait_for(std::chrono::seconds(5)) ==
+            std::future_status::ready);
+    REQUIRE(pending_response.get().errors().empty());
+  }
+
+  SECTION("Requests waiting for the connection give up on their deadline") {
+    // arrange
+    server.reset();
+    REQUIRE(wait_for_lost_connection());
+    std::stop_source stop_source;
+    auto cancelled_response = communicator.request_with_response_async(
+        Command("mono_isBusy", {{"index", 0}}),
+        RequestOptions{std::nullopt, stop_source.get_token()});
+    const auto start = std::chrono::steady_clock::now();
+
+    // act
+    stop_source.request_stop();
+
+    // assert
+    REQUIRE_THROWS_AS(
+        communicator.request_with_response(
+            Command("mono_isBusy", {{"index", 0}}),
+            RequestOptions::within(std::chrono::milliseconds(100))),
+        RequestTimeoutError);
+    REQUIRE_THROWS_AS(cancelled_response.get(), RequestCancelledError);
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+  }
+
+  SECTION("Reconnecting gives up after the timeout") {
+    // arrange
+    ReconnectPolicy short_policy;
+    short_policy.timeout = std::chrono::milliseconds(100);
+    ReconnectingCommunicator impatient_communicator(websocket_communicator,
+                                                    short_policy);
+    communicator.close();
+    impatient_communicator.open();
+
+    // act
+    server.reset();
+    REQUIRE(wait_for_lost_connection());
+    const auto start = std::chrono::steady_clock::now();
+
+    // assert
+    REQUIRE_THROWS_AS(impatient_communicator.request_with_response(
+                          Command("mono_isBusy", {{"index", 0}})),
+                      std::runtime_error);
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+    REQUIRE(impatient_communicator.reconnections() == 0);
+  }
+
+  if (communicator.is_open()) {
+    communicator.close();
+  }
+}
+
+}  // namespace horiba::test
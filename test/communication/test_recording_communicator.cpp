@@ -0,0 +1,269 @@
+#include <fake_icl/icl_server.h>
+#include <horiba_cpp_sdk/communication/command.h>
+#include <horiba_cpp_sdk/communication/recording_communicator.h>
+#include <horiba_cpp_sdk/communication/replay_communicator.h>
+#include <horiba_cpp_sdk/communication/response.h>
+#include <horiba_cpp_sdk/communication/websocket_communicator.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace horiba::test {
+
+using horiba::communication::Command;
+using horiba::communication::RecordedExchange;
+using horiba::communication::RecordingCommunicator;
+using horiba::communication::ReplayCommunicator;
+using horiba::communication::Response;
+using horiba::communication::WebSocketCommunicator;
+
+TEST_CASE("RecordingCommunicator test", "[recording_communicator]") {
+  // arrange
+  const auto recording_file =
+      std::filesystem::temp_directory_path() / "horiba_test_recording.bin";
+  std::filesystem::remove(recording_file);
+
+  fake_icl::ICLServerConfig config;
+  config.port = 0;
+  config.synthetic_chip = fake_icl::ChipSize{16, 4};
+  config.binary_messages = true;
+  fake_icl::CommandBehavior failing;
+  failing.error_probability = 1.0;
+  failing.error_message = "[E];-42;Injected";
+  config.command_behaviors["mono_home"] = failing;
+  fake_icl::ICLServer server(config);
+
+  const Command busy("mono_isBusy", {{"index", 0}});
+  const Command home("mono_home", {{"index", 0}});
+  const Command acquisition("ccd_getAcquisitionData", {{"index", 0}});
+
+  SECTION("Commands and responses are recorded") {
+    // arrange
+    RecordingCommunicator recorder(
+        std::make_shared<WebSocketCommunicator>("127.0.0.1",
+                                                std::to_string(server.port())),
+        recording_file);
+    recorder.open();
+
+    // act
+    const auto busy_response = recorder.request_with_response(busy);
+    recorder.request_with_response(home);
+    const auto acquisition_response =
+        recorder.request_with_response_async(acquisition).get();
+    recorder.close();
+    const auto exchanges =
+        RecordingCommunicator::read_recording(recording_file);
+
+    // assert
+    REQUIRE(exchanges.size() == 3);
+    REQUIRE(exchanges[0].command == "mono_isBusy");
+    REQUIRE(exchanges[0].parameters == nlohmann::json{{"index", 0}});
+    REQUIRE(exchanges[0].results == busy_response.json_results());
+    REQUIRE(exchanges[0].round_trip_time > std::chrono::microseconds(0));
+    REQUIRE(exchanges[1].errors ==
+            std::vector<std::string>{"[E];-42;Injected"});
+    REQUIRE(exchanges[2].sent_at >= exchanges[1].sent_at);
+    REQUIRE(exchanges[2].binary_blocks.size() == 2);
+    REQUIRE(exchanges[2].binary_blocks[1].values ==
+            acquisition_response.binary_blocks()[1].values);
+  }
+
+  SECTION("Sessions can be appended to a recording") {
+    // act
+    for (int session = 0; session < 2; session++) {
+      RecordingCommunicator recorder(
+          std::make_shared<WebSocketCommunicator>(
+              "127.0.0.1", std::to_string(server.port())),
+          recording_file);
+      recorder.open();
+      recorder.request_with_response(busy);
+      recorder.close();
+    }
+
+    // assert
+    REQUIRE(RecordingCommunicator::read_recording(recording_file).size() == 2);
+  }
+
+  SECTION("Appended sessions are read back in order") {
+    // arrange
+    const auto between_sessions = std::chrono::milliseconds(50);
+    for (const auto* command : {&busy, &home}) {
+      RecordingCommunicator recorder(
+          std::make_shared<WebSocketCommunicator>(
+              "127.0.0.1", std::to_string(server.port())),
+          recording_file);
+      recorder.open();
+      recorder.request_with_response(*command);
+      recorder.close();
+      std::this_thread::sleep_for(between_sessions);
+    }
+
+    // act
+    const auto exchanges =
+        RecordingCommunicator::read_recording(recording_file);
+
+    // assert
+    REQUIRE(exchanges.size() == 2);
+    REQUIRE(exchanges[0].command == "mono_isBusy");
+    REQUIRE(exchanges[0].session == 0);
+    REQUIRE(exchanges[1].command == "mono_home");
+    REQUIRE(exchanges[1].session == 1);
+    REQUIRE(exchanges[1].sent_at - exchanges[0].sent_at >=
+            between_sessions);
+  }
+
+  SECTION("A truncated last record is ignored") {
+    // arrange
+    {
+      RecordingCommunicator recorder(
+          std::make_shared<WebSocketCommunicator>(
+              "127.0.0.1", std::to_string(server.port())),
+          recording_file);
+      recorder.open();
+      recorder.request_with_response(busy);
+      recorder.request_with_response(acquisition);
+      recorder.close();
+    }
+
+    // act
+    std::filesystem::resize_file(
+        recording_file, std::filesystem::file_size(recording_file) - 1);
+
+    // assert
+    REQUIRE(RecordingCommunicator::read_recording(recording_file).size() == 1);
+  }
+
+  SECTION("Files that are not recordings cannot be read") {
+    // arrange
+    std::ofstream(recording_file) << "not a recording";
+
+    // act
+    // assert
+    REQUIRE_THROWS_AS(RecordingCommunicator::read_recording(recording_file),
+                      std::runtime_error);
+  }
+
+  SECTION("Recorded responses can be replayed") {
+    // arrange
+    {
+      RecordingCommunicator recorder(
+          std::make_shared<WebSocketCommunicator>(
+              "127.0.0.1", std::to_string(server.port())),
+          recording_file);
+      recorder.open();
+      recorder.request_with_response(busy);
+      recorder.request_with_response(home);
+      recorder.request_with_response(acquisition);
+      recorder.close();
+    }
+    ReplayCommunicator replay(recording_file, 0.0);
+    replay.open();
+    const Command replayed_acquisition("ccd_getAcquisitionData",
+                                       {{"index", 0}});
+
+    // act
+    const auto acquisition_response =
+        replay.request_with_response(replayed_acquisition);
+    const auto home_response =
+        replay.request_with_response_async(Command("mono_home", {{"index", 0}}))
+            .get();
+    const auto remaining = replay.remaining_exchanges();
+
+    // assert
+    REQUIRE(acquisition_response.id() == replayed_acquisition.id());
+    REQUIRE(acquisition_response.binary_blocks()[1].values.size() == 16 * 4);
+    REQUIRE(home_response.errors() ==
+            std::vector<std::string>{"[E];-42;Injected"});
+    REQUIRE(remaining == 1);
+    REQUIRE_THROWS_AS(replay.request_with_response(home), std::runtime_error);
+    replay.close();
+  }
+}
+
+TEST_CASE("ReplayCommunicator test", "[replay_communicator]") {
+  // arrange
+  RecordedExchange busy;
+  busy.command = "mono_isBusy";
+  busy.parameters = {{"index", 0}};
+  busy.results = {{"busy", true}};
+  busy.round_trip_time = std::chrono::milliseconds(40);
+  RecordedExchange idle = busy;
+  idle.parameters = {{"index", 1}};
+  idle.results = {{"busy", false}};
+  idle.round_trip_time = std::chrono::milliseconds(10);
+  RecordedExchange failed = busy;
+  failed.command = "mono_home";
+  failed.failure = "websocket is not open";
+
+  SECTION("Responses are matched on the command parameters") {
+    // arrange
+    ReplayCommunicator replay({busy, idle}, 0.0);
+    replay.open();
+
+    // act
+    const auto first =
+        replay.request_with_response(Command("mono_isBusy", {{"index", 1}}));
+    const auto second =
+        replay.request_with_response(Command("mono_isBusy", {{"index", 7}}));
+
+    // assert
+    REQUIRE(first.json_results().at("busy") == false);
+    REQUIRE(second.json_results().at("busy") == true);
+  }
+
+  SECTION("Responses are delayed by the scaled round trip time") {
+    // arrange
+    ReplayCommunicator replay({busy, idle}, 0.5);
+    replay.open();
+
+    // act
+    const auto start = std::chrono::steady_clock::now();
+    auto slow = replay.request_with_response_async(
+        Command("mono_isBusy", {{"index", 0}}));
+    auto fast = replay.request_with_response_async(
+        Command("mono_isBusy", {{"index", 1}}));
+    const auto fast_status = fast.wait_for(std::chrono::milliseconds(15));
+    const auto slow_status = slow.wait_for(std::chrono::milliseconds(1));
+    slow.get();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // assert
+    REQUIRE(fast_status == std::future_status::ready);
+    REQUIRE(slow_status == std::future_status::timeout);
+    REQUIRE(elapsed >= std::chrono::milliseconds(20));
+  }
+
+  SECTION("Recorded failures are thrown") {
+    // arrange
+    ReplayCommunicator replay({failed}, 0.0);
+    replay.open();
+
+    // act
+    // assert
+    REQUIRE_THROWS_AS(replay.request_with_response(Command("mono_home", {})),
+                      std::runtime_error);
+  }
+
+  SECTION("Commands cannot be sent when the replay is closed") {
+    // arrange
+    ReplayCommunicator replay({busy}, 0.0);
+
+    // act
+    // assert
+    REQUIRE_THROWS_AS(replay.request_with_response(
+                          Command("mono_isBusy", {{"index", 0}})),
+                      std::runtime_error);
+    REQUIRE(replay.remaining_exchanges() == 1);
+  }
+}
+
+}  // namespace horiba::test
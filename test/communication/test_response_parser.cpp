@@ -0,0 +1,155 @@
+#include <fake_icl/icl_server.h>
+#include <horiba_cpp_sdk/common/buffer_pool.h>
+#include <horiba_cpp_sdk/communication/binary_message.h>
+#include <horiba_cpp_sdk/communication/response_parser.h>
+#include <horiba_cpp_sdk/devices/single_devices/acquisition_data.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace horiba::test {
+
+using horiba::communication::BinaryBlock;
+using horiba::communication::DomResponseParser;
+using horiba::communication::NumericDataResponseParser;
+using horiba::devices::single_devices::AcquisitionData;
+
+TEST_CASE("Response parser test", "[response_parser]") {
+  // arrange
+  NumericDataResponseParser parser(0);
+  std::vector<BinaryBlock> blocks;
+  const nlohmann::json roi = {{"roiIndex", 2},
+                              {"xOrigin", 0},
+                              {"yOrigin", 0},
+                              {"xSize", 2},
+                              {"ySize", 1},
+                              {"xBinning", 1},
+                              {"yBinning", 1},
+                              {"xyData", {{500.5, 7}, {501.5, 8}}}};
+  const auto response = [](const nlohmann::json& results) {
+    return nlohmann::json{{"id", 1234},
+                          {"command", "ccd_getAcquisitionData"},
+                          {"results", results},
+                          {"errors", nlohmann::json::array()}}
+        .dump();
+  };
+
+  SECTION("Small responses are parsed as a document") {
+    // arrange
+    NumericDataResponseParser default_parser;
+    const auto raw_response =
+        response(fake_icl::synthetic_acquisition_results({4, 2}));
+
+    // act
+    const auto json_response = default_parser.parse(raw_response, blocks);
+
+    // assert
+    REQUIRE(blocks.empty());
+    REQUIRE(json_response == nlohmann::json::parse(raw_response));
+  }
+
+  SECTION("Data rows are parsed into binary blocks") {
+    // arrange
+    const auto results = fake_icl::synthetic_acquisition_results({64, 8});
+    const auto raw_response = response(results);
+
+    // act
+    const auto json_response = parser.parse(raw_response, blocks);
+    const auto data = AcquisitionData::from_binary_message(
+        json_response.at("results"), blocks);
+    const auto expected = AcquisitionData::from_json(results);
+
+    // assert
+    REQUIRE(json_response.at("id") == 1234);
+    REQUIRE(json_response.at("errors").empty());
+    const auto& json_roi = json_response["results"]["acquisition"][0]["roi"][0];
+    REQUIRE_FALSE(json_roi.contains("xData"));
+    REQUIRE_FALSE(json_roi.contains("yData"));
+    REQUIRE(json_roi.at("xSize") == 64);
+    REQUIRE(blocks.size() == 2);
+    const auto& region = data.acquisitions()[0].regions_of_interest[0];
+    const auto& expected_region =
+        expected.acquisitions()[0].regions_of_interest[0];
+    REQUIRE(data.timestamp() == expected.timestamp());
+    REQUIRE(region.rows == 8);
+    REQUIRE(region.x_values == expected_region.x_values);
+    REQUIRE(region.y_values == expected_region.y_values);
+  }
+
+  SECTION("Data pairs are parsed into binary blocks") {
+    // arrange
+    const nlohmann::json results = {
+        {"acquisition", {{{"acqIndex", 3}, {"roi", {roi}}}}}};
+
+    // act
+    const auto json_response = parser.parse(response(results), blocks);
+    const auto data = AcquisitionData::from_binary_message(
+        json_response.at("results"), blocks);
+
+    // assert
+    REQUIRE(blocks.size() == 2);
+    REQUIRE(blocks[0].acquisition_index == 3);
+    REQUIRE(blocks[0].roi_index == 2);
+    const auto& region = data.acquisitions()[0].regions_of_interest[0];
+    REQUIRE(region.rows == 1);
+    REQUIRE(region.x_values[1] == 501.5);
+    REQUIRE(region.y_values[1] == 8);
+  }
+
+  SECTION("Data is parsed into buffers of the pool") {
+    // arrange
+    common::BufferPool<double> buffers;
+    buffers.set_buffer_size(64 * 8);
+    const auto raw_response =
+        response(fake_icl::synthetic_acquisition_results({64, 8}));
+    parser.parse(raw_response, blocks, &buffers);
+    const auto* const x_data = blocks[0].values.data();
+    const auto* const y_data = blocks[1].values.data();
+    REQUIRE(blocks[1].values.capacity() == 64 * 8);
+    for (auto& block : blocks) {
+      buffers.release(std::move(block.values));
+    }
+    blocks.clear();
+
+    // act
+    parser.parse(raw_response, blocks, &buffers);
+
+    // assert
+    REQUIRE(blocks[0].values.data() == x_data);
+    REQUIRE(blocks[1].values.data() == y_data);
+    REQUIRE(blocks[1].values.size() == 64 * 8);
+  }
+
+  SECTION("Data with another layout is parsed as a document") {
+    // arrange
+    auto odd_roi = roi;
+    odd_roi["xyData"] = {{500.5, 7, 1}};
+    const nlohmann::json odd_pairs = {
+        {"acquisition", {{{"acqIndex", 1}, {"roi", {odd_roi}}}}}};
+    const nlohmann::json no_roi = {{"xData", {{1, 2, 3}}}};
+    const nlohmann::json strings = {{"yData", {{"a", "b"}}}};
+
+    // act
+    // assert
+    for (const auto& results : {odd_pairs, no_roi, strings}) {
+      const auto raw_response = response(results);
+      const auto json_response = parser.parse(raw_response, blocks);
+      REQUIRE(blocks.empty());
+      REQUIRE(json_response == nlohmann::json::parse(raw_response));
+    }
+  }
+
+  SECTION("Invalid responses cannot be parsed") {
+    // act
+    // assert
+    REQUIRE_THROWS_AS(parser.parse(R"({"id": 1, "results": [1, 2)", blocks),
+                      nlohmann::json::parse_error);
+    REQUIRE_THROWS_AS(DomResponseParser().parse("{", blocks),
+                      nlohmann::json::parse_error);
+  }
+}
+
+}  // namespace horiba::test
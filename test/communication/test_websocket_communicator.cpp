@@ -1,11 +1,23 @@
 #include <horiba_cpp_sdk/communication/command.h>
+#include <horiba_cpp_sdk/communication/command_metrics.h>
 #include <horiba_cpp_sdk/communication/response.h>
+#include <horiba_cpp_sdk/communication/response_parser.h>
 #include <horiba_cpp_sdk/communication/websocket_communicator.h>
 
+#include <atomic>
 #include <catch2/catch_message.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <chrono>
 #include <cstdlib>
+#include <future>
+#include <memory>
 #include <nlohmann/json.hpp>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "../fake_icl_server.h"
 #include "../icl_exe.h"
@@ -91,6 +103,96 @@ TEST_CASE("WebSocket communicator test with fake ICL",
     }
   }
 
+  SECTION("WebSocketCommunicator can pipeline multiple requests") {
+    // arrange
+    websocket_communicator.open();
+    const size_t amount_requests = 20;
+    std::vector<horiba::communication::Command> commands;
+    for (size_t i = 0; i < amount_requests; i++) {
+      commands.emplace_back(i % 2 == 0 ? "ccd_getChipSize" : "mono_isBusy",
+                            json{{"index", 0}});
+    }
+
+    // act
+    std::vector<std::future<communication::Response>> futures;
+    for (const auto& command : commands) {
+      futures.push_back(
+          websocket_communicator.request_with_response_async(command));
+    }
+    std::vector<communication::Response> responses;
+    for (auto& future : futures) {
+      responses.push_back(future.get());
+    }
+    websocket_communicator.close();
+
+    // assert
+    for (size_t i = 0; i < amount_requests; i++) {
+      REQUIRE(responses[i].id() == commands[i].id());
+      const auto* expected_key = i % 2 == 0 ? "x" : "busy";
+      REQUIRE(responses[i].json_results().contains(expected_key));
+    }
+  }
+
+  SECTION("WebSocketCommunicator calls the handler of an async request") {
+    // arrange
+    websocket_communicator.open();
+    const horiba::communication::Command command("test_command", {});
+    std::promise<unsigned long long int> received_id;
+
+    // act
+    websocket_communicator.async_request(
+        command, [&received_id](std::exception_ptr error,
+                                communication::Response response) {
+          if (error) {
+            received_id.set_exception(error);
+            return;
+          }
+          received_id.set_value(response.id());
+        });
+
+    // assert
+    REQUIRE(received_id.get_future().get() == command.id());
+  }
+
+  SECTION("WebSocketCommunicator records the sent commands in its metrics") {
+    // arrange
+    auto metrics = std::make_shared<horiba::communication::CommandMetrics>();
+    websocket_communicator.set_metrics(metrics);
+    websocket_communicator.open();
+    const size_t amount_requests = 5;
+
+    // act
+    for (size_t i = 0; i < amount_requests; i++) {
+      auto _response = websocket_communicator.request_with_response(
+          horiba::communication::Command("ccd_getChipSize", {{"index", 0}}));
+    }
+    websocket_communicator.close();
+    const auto snapshot = metrics->snapshot();
+
+    // assert
+    REQUIRE(snapshot.size() == 1);
+    const auto& chip_size = snapshot.at("ccd_getChipSize");
+    REQUIRE(chip_size.round_trip_time_ns.count == amount_requests);
+    REQUIRE(chip_size.bytes_sent.count == amount_requests);
+    REQUIRE(chip_size.bytes_sent.max > 0);
+    REQUIRE(chip_size.bytes_received.max > 0);
+  }
+
+  SECTION("Closing the WebSocketCommunicator fails pending requests") {
+    // arrange
+    websocket_communicator.open();
+    const horiba::communication::Command command("test_command", {});
+    auto future = websocket_communicator.request_with_response_async(command);
+
+    // act
+    websocket_communicator.close();
+
+    // assert
+    // either the response arrived before the close, or the request failed
+    REQUIRE(future.wait_for(std::chrono::seconds(1)) ==
+            std::future_status::ready);
+  }
+
   SECTION("Already opened WebSocketCommunicator cannot be opened again") {
     // act
     websocket_communicator.open();
@@ -119,6 +221,233 @@ TEST_CASE("WebSocket communicator test with fake ICL",
   }
 }
 
+TEST_CASE("WebSocket communicator deadlines and cancellation",
+          "[websocket_communicator]") {
+  // arrange
+  using horiba::communication::RequestCancelledError;
+  using horiba::communication::RequestOptions;
+  using horiba::communication::RequestTimeoutError;
+
+  fake_icl::ICLServerConfig config;
+  config.port = 0;
+  fake_icl::CommandBehavior unanswered;
+  unanswered.drop_probability = 1.0;
+  config.command_behaviors["mono_init"] = unanswered;
+  fake_icl::ICLServer server(config);
+  horiba::communication::WebSocketCommunicator websocket_communicator(
+      "127.0.0.1", std::to_string(server.port()));
+  websocket_communicator.open();
+  const horiba::communication::Command init("mono_init", {{"index", 0}});
+  const horiba::communication::Command busy("mono_isBusy", {{"index", 0}});
+
+  SECTION("Requests not answered before their deadline time out") {
+    // act
+    const auto start = std::chrono::steady_clock::now();
+    REQUIRE_THROWS_AS(
+        websocket_communicator.request_with_response(
+            init, RequestOptions::within(std::chrono::milliseconds(50))),
+        RequestTimeoutError);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // assert
+    REQUIRE(elapsed >= std::chrono::milliseconds(50));
+    REQUIRE(elapsed < std::chrono::seconds(1));
+    REQUIRE_NOTHROW(websocket_communicator.request_with_response(
+        busy, RequestOptions::within(std::chrono::seconds(5))));
+  }
+
+  SECTION("Requests in flight can be cancelled") {
+    // arrange
+    std::stop_source stop_source;
+    auto future = websocket_communicator.request_with_response_async(
+        init, RequestOptions{std::nullopt, stop_source.get_token()});
+    const auto status_before_cancel =
+        future.wait_for(std::chrono::milliseconds(50));
+
+    // act
+    stop_source.request_stop();
+
+    // assert
+    REQUIRE(status_before_cancel == std::future_status::timeout);
+    REQUIRE(future.wait_for(std::chrono::seconds(1)) ==
+            std::future_status::ready);
+    REQUIRE_THROWS_AS(future.get(), RequestCancelledError);
+  }
+
+  SECTION("Requests past their deadline or cancelled are not sent") {
+    // arrange
+    std::stop_source stop_source;
+    stop_source.request_stop();
+
+    // act
+    // assert
+    REQUIRE_THROWS_AS(
+        websocket_communicator.request_with_response(
+            busy, RequestOptions{std::chrono::steady_clock::now(), {}}),
+        RequestTimeoutError);
+    REQUIRE_THROWS_AS(
+        websocket_communicator.request_with_response(
+            busy, RequestOptions{std::nullopt, stop_source.get_token()}),
+        RequestCancelledError);
+    REQUIRE(server.received_commands() == 0);
+  }
+
+  websocket_communicator.close();
+}
+
+namespace {
+
+/**
+ * @brief Parses the responses of the fake ICL, then replaces one of their
+ * fields, to simulate a malformed response.
+ */
+class TamperingResponseParser : public horiba::communication::ResponseParser {
+ public:
+  TamperingResponseParser(std::string field, json value)
+      : field{std::move(field)}, value{std::move(value)} {}
+
+  json parse(std::string_view raw_response,
+             std::vector<horiba::communication::BinaryBlock>& binary_blocks,
+             common::BufferPool<double>* buffers) override {
+    auto response = this->parser.parse(raw_response, binary_blocks, buffers);
+    response[this->field] = this->value;
+    return response;
+  }
+
+ private:
+  horiba::communication::DomResponseParser parser;
+  std::string field;
+  json value;
+};
+
+}  // namespace
+
+TEST_CASE("WebSocket communicator with malformed responses",
+          "[websocket_communicator]") {
+  // arrange
+  fake_icl::ICLServerConfig config;
+  config.port = 0;
+  fake_icl::ICLServer server(config);
+  horiba::communication::WebSocketCommunicator websocket_communicator(
+      "127.0.0.1", std::to_string(server.port()));
+  const horiba::communication::Command busy("mono_isBusy", {{"index", 0}});
+
+  const auto request_once_tampered = [&websocket_communicator, &busy](
+                                         std::string field, json value) {
+    websocket_communicator.set_response_parser(
+        std::make_shared<TamperingResponseParser>(std::move(field),
+                                                  std::move(value)));
+    websocket_communicator.open();
+    auto response = websocket_communicator.request_with_response_async(busy);
+    const auto status = response.wait_for(std::chrono::seconds(5));
+    REQUIRE(status == std::future_status::ready);
+    return response;
+  };
+
+  SECTION("Responses with a malformed field fail their request") {
+    // act
+    auto response = request_once_tampered("command", 42);
+
+    // assert
+    REQUIRE_THROWS_AS(response.get(), std::exception);
+  }
+
+  SECTION("Responses without a valid id fail the pending requests") {
+    // act
+    auto response = request_once_tampered("id", "not a number");
+
+    // assert
+    REQUIRE_THROWS_AS(response.get(), std::runtime_error);
+  }
+
+  websocket_communicator.close();
+}
+
+TEST_CASE("WebSocket communicator shared between threads",
+          "[websocket_communicator]") {
+  // arrange
+  constexpr int DEVICES = 4;
+  constexpr int REQUESTS = 25;
+  fake_icl::ICLServerConfig config;
+  config.port = 0;
+  config.threads = 2;
+  config.default_behavior.latency = fake_icl::LatencyDistribution::uniform(
+      std::chrono::microseconds(0), std::chrono::microseconds(500));
+  fake_icl::ICLServer server(config);
+  horiba::communication::WebSocketCommunicator websocket_communicator(
+      "127.0.0.1", std::to_string(server.port()), 4);
+  websocket_communicator.open();
+
+  SECTION("Responses are routed to the thread that sent the command") {
+    // arrange
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> device_threads;
+
+    // act
+    for (int device = 0; device < DEVICES; device++) {
+      device_threads.emplace_back([&websocket_communicator, &mismatches,
+                                   device] {
+        for (int i = 0; i < REQUESTS; i++) {
+          const horiba::communication::Command command(
+              device % 2 == 0 ? "ccd_isBusy" : "mono_isBusy",
+              {{"index", device}});
+          const auto response =
+              websocket_communicator.request_with_response(command);
+          if (response.id() != command.id() ||
+              response.command_name() != command.name()) {
+            mismatches++;
+          }
+        }
+      });
+    }
+    for (auto& device_thread : device_threads) {
+      device_thread.join();
+    }
+
+    // assert
+    REQUIRE(mismatches == 0);
+    REQUIRE(server.received_commands() == DEVICES * REQUESTS);
+  }
+
+  SECTION("The handlers of a device run one at a time") {
+    // arrange
+    std::vector<std::atomic<int>> running_handlers(
+        static_cast<std::size_t>(DEVICES));
+    std::atomic<int> overlaps{0};
+    std::vector<std::future<void>> done;
+
+    // act
+    for (int i = 0; i < REQUESTS; i++) {
+      for (int device = 0; device < DEVICES; device++) {
+        auto promise = std::make_shared<std::promise<void>>();
+        done.push_back(promise->get_future());
+        websocket_communicator.async_request(
+            horiba::communication::Command("ccd_isBusy", {{"index", device}}),
+            [&running_handlers, &overlaps,
+             handler_index = static_cast<std::size_t>(device), promise](
+                std::exception_ptr /*error*/,
+                horiba::communication::Response /*response*/) {
+              if (running_handlers[handler_index]++ > 0) {
+                overlaps++;
+              }
+              std::this_thread::sleep_for(std::chrono::microseconds(200));
+              running_handlers[handler_index]--;
+              promise->set_value();
+            });
+      }
+    }
+
+    // assert
+    for (auto& handled : done) {
+      REQUIRE(handled.wait_for(std::chrono::seconds(5)) ==
+              std::future_status::ready);
+    }
+    REQUIRE(overlaps == 0);
+  }
+
+  websocket_communicator.close();
+}
+
 TEST_CASE("WebSocket communicator test without fake ICL",
           "[websocket_communicator]") {
   horiba::communication::WebSocketCommunicator websocket_communicator(
@@ -0,0 +1,168 @@
+#include <horiba_cpp_sdk/communication/binary_message.h>
+#include <horiba_cpp_sdk/devices/single_devices/acquisition_data.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace horiba::test {
+using namespace horiba::devices::single_devices;
+using horiba::communication::BinaryBlock;
+
+TEST_CASE("Acquisition data can be built from the ICL results",
+          "[acquisition_data]") {
+  // arrange
+  const nlohmann::json roi_metadata = {
+      {"roiIndex", 1}, {"xOrigin", 0},   {"yOrigin", 0},  {"xSize", 3},
+      {"ySize", 2},    {"xBinning", 1}, {"yBinning", 1}};
+
+  SECTION("Acquisition data can be built from x and y data rows") {
+    // arrange
+    auto roi = roi_metadata;
+    roi["xData"] = {{1.0, 2.0, 3.0}};
+    roi["yData"] = {{10, 20, 30}, {40, 50, 60}};
+    const nlohmann::json results = {
+        {"acquisition", {{{"acqIndex", 1}, {"roi", {roi}}}}},
+        {"timestamp", "2024.04.22 15:07:50.096"}};
+
+    // act
+    const auto data = AcquisitionData::from_json(results);
+
+    // assert
+    REQUIRE(data.timestamp() == "2024.04.22 15:07:50.096");
+    REQUIRE(data.acquisitions().size() == 1);
+    REQUIRE(data.acquisitions()[0].index == 1);
+    const auto& region = data.acquisitions()[0].regions_of_interest[0];
+    REQUIRE(region.x_size == 3);
+    REQUIRE(region.rows == 2);
+    REQUIRE(region.columns() == 3);
+    REQUIRE(region.x_values.size() == 3);
+    REQUIRE(region.y_row(1)[0] == 40);
+    REQUIRE_THROWS_AS((void)region.y_row(2), std::out_of_range);
+  }
+
+  SECTION("Acquisition data can be built from xy data pairs") {
+    // arrange
+    auto roi = roi_metadata;
+    roi["xyData"] = {{500.5, 7}, {501.5, 8}};
+    const nlohmann::json results = {
+        {"acquisition", {{{"acqIndex", 1}, {"roi", {roi}}}}}};
+
+    // act
+    const auto data = AcquisitionData::from_json(results);
+
+    // assert
+    REQUIRE(data.timestamp().empty());
+    const auto& region = data.acquisitions()[0].regions_of_interest[0];
+    REQUIRE(region.rows == 1);
+    REQUIRE(region.x_values[1] == 501.5);
+    REQUIRE(region.y_values[1] == 8);
+  }
+
+  SECTION("Acquisition data can be built from binary blocks") {
+    // arrange
+    const nlohmann::json results = {
+        {"acquisition", {{{"acqIndex", 1}, {"roi", {roi_metadata}}}}}};
+    BinaryBlock x_block;
+    x_block.acquisition_index = 1;
+    x_block.roi_index = 1;
+    x_block.axis = BinaryBlock::Axis::X;
+    x_block.values = {1.0, 2.0, 3.0};
+    BinaryBlock y_block;
+    y_block.acquisition_index = 1;
+    y_block.roi_index = 1;
+    y_block.axis = BinaryBlock::Axis::Y;
+    y_block.rows = 2;
+    y_block.values = {10, 20, 30, 40, 50, 60};
+
+    // act
+    const auto data =
+        AcquisitionData::from_binary_message(results, {x_block, y_block});
+
+    // assert
+    const auto& region = data.acquisitions()[0].regions_of_interest[0];
+    REQUIRE(region.rows == 2);
+    REQUIRE(region.x_values[2] == 3.0);
+    REQUIRE(region.y_row(1)[2] == 60);
+  }
+
+  SECTION("Binary blocks without matching region of interest are rejected") {
+    // arrange
+    const nlohmann::json results = {
+        {"acquisition", {{{"acqIndex", 1}, {"roi", {roi_metadata}}}}}};
+    BinaryBlock block;
+    block.acquisition_index = 2;
+    block.roi_index = 1;
+
+    // act
+    // assert
+    REQUIRE_THROWS_AS(AcquisitionData::from_binary_message(results, {block}),
+                      std::runtime_error);
+  }
+
+  SECTION("Buffers go back to the pool once the data is dropped") {
+    // arrange
+    const nlohmann::json results = {
+        {"acquisition", {{{"acqIndex", 1}, {"roi", {roi_metadata}}}}}};
+    const auto buffers = std::make_shared<common::BufferPool<double>>();
+    const auto pooled_data = [&results, &buffers]() {
+      BinaryBlock block;
+      block.acquisition_index = 1;
+      block.roi_index = 1;
+      block.axis = BinaryBlock::Axis::Y;
+      block.values = buffers->acquire(6);
+      block.values.assign(6, 1.0);
+      std::vector<BinaryBlock> blocks;
+      blocks.push_back(std::move(block));
+      auto data =
+          AcquisitionData::from_binary_message(results, std::move(blocks));
+      data.set_buffer_pool(buffers);
+      return data;
+    };
+
+    // act
+    {
+      const auto data = pooled_data();
+    }
+    const auto available_after_drop = buffers->available();
+    auto data = pooled_data();
+    const auto available_while_used = buffers->available();
+    auto moved_data = std::move(data);
+    const auto available_after_move = buffers->available();
+    moved_data = pooled_data();
+
+    // assert
+    REQUIRE(available_after_drop == 1);
+    REQUIRE(available_while_used == 0);
+    REQUIRE(available_after_move == 0);
+    REQUIRE(buffers->available() == 1);
+    REQUIRE(moved_data.acquisitions()[0].regions_of_interest[0].y_values[5] ==
+            1.0);
+  }
+
+  SECTION("Values are stored on a cache line boundary") {
+    // arrange
+    auto roi = roi_metadata;
+    roi["xData"] = {{1.0, 2.0, 3.0}};
+    roi["yData"] = {{10, 20, 30}};
+    const nlohmann::json results = {
+        {"acquisition", {{{"acqIndex", 1}, {"roi", {roi}}}}}};
+
+    // act
+    const auto data = AcquisitionData::from_json(results);
+
+    // assert
+    const auto& region = data.acquisitions()[0].regions_of_interest[0];
+    REQUIRE(reinterpret_cast<std::uintptr_t>(region.x_values.data()) %
+                common::CACHE_LINE_SIZE ==
+            0);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(region.y_values.data()) %
+                common::CACHE_LINE_SIZE ==
+            0);
+  }
+}
+}  // namespace horiba::test
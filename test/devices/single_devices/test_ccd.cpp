@@ -1,8 +1,20 @@
+#include <fake_icl/icl_server.h>
+#include <horiba_cpp_sdk/communication/command.h>
+#include <horiba_cpp_sdk/communication/response.h>
 #include <horiba_cpp_sdk/communication/websocket_communicator.h>
 #include <horiba_cpp_sdk/devices/single_devices/ccd.h>
 
+#include <atomic>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/use_future.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <future>
 #include <memory>
+#include <set>
+#include <stdexcept>
+#include <stop_token>
 #include <string>
 #include <utility>
 #include <vector>
@@ -14,6 +26,36 @@ namespace horiba::test {
 using namespace horiba::devices::single_devices;
 using namespace horiba::communication;
 
+/**
+ * @brief Forwards to another communicator and counts the sent commands.
+ */
+class CountingCommunicator : public Communicator {
+ public:
+  explicit CountingCommunicator(std::shared_ptr<Communicator> communicator)
+      : communicator{std::move(communicator)} {}
+
+  void open() override { this->communicator->open(); }
+  void close() override { this->communicator->close(); }
+  bool is_open() override { return this->communicator->is_open(); }
+
+  Response request_with_response(const Command& command) override {
+    ++this->sent_commands;
+    return this->communicator->request_with_response(command);
+  }
+
+  using Communicator::async_request;
+  void async_request(const Command& command,
+                     ResponseHandler handler) override {
+    ++this->sent_commands;
+    this->communicator->async_request(command, std::move(handler));
+  }
+
+  std::atomic<int> sent_commands{0};
+
+ private:
+  std::shared_ptr<Communicator> communicator;
+};
+
 TEST_CASE("CCD test with fake ICL", "[ccd_no_hw]") {
   // arrange
   auto websocket_communicator = std::make_shared<WebSocketCommunicator>(
@@ -64,6 +106,52 @@ TEST_CASE("CCD test with fake ICL", "[ccd_no_hw]") {
     REQUIRE(configuration.empty() == false);
   }
 
+  SECTION("CCD configuration is cached until the CCD is opened again") {
+    // arrange
+    ccd.open();
+
+    // act
+    auto first_configuration = ccd.configuration();
+    auto second_configuration = ccd.configuration();
+    ccd.open();
+    auto configuration_after_open = ccd.configuration();
+
+    // assert
+    REQUIRE(first_configuration == second_configuration);
+    REQUIRE(configuration_after_open != first_configuration);
+  }
+
+  SECTION("CCD gain not in the configuration cannot be set") {
+    // arrange
+    ccd.open();
+
+    // act
+    // assert
+    REQUIRE_THROWS_AS(ccd.set_gain(42), std::runtime_error);
+  }
+
+  SECTION("CCD trigger input can be set") {
+    // arrange
+    ccd.open();
+
+    // act
+    // assert
+    REQUIRE_NOTHROW(ccd.set_trigger_input(true, 0, 1, 1));
+    REQUIRE_THROWS_AS(ccd.set_trigger_input(true, 0, 2, 0),
+                      std::runtime_error);
+  }
+
+  SECTION("CCD signal output can be set") {
+    // arrange
+    ccd.open();
+
+    // act
+    // assert
+    REQUIRE_NOTHROW(ccd.set_signal_output(true, 0, 3, 1));
+    REQUIRE_THROWS_AS(ccd.set_signal_output(true, 1, 3, 1),
+                      std::runtime_error);
+  }
+
   SECTION("CCD get gain") {
     // arrange
     ccd.open();
@@ -337,7 +425,181 @@ TEST_CASE("CCD test with fake ICL", "[ccd_no_hw]") {
     auto acquisition_data = ccd.get_acquisition_data();
 
     // assert
-    REQUIRE(acquisition_data.has_value() == true);
+    REQUIRE(acquisition_data.timestamp() == "2024.04.22 15:07:50.096");
+    REQUIRE(acquisition_data.acquisitions().size() == 1);
+    const auto& roi = acquisition_data.acquisitions()[0].regions_of_interest[0];
+    REQUIRE(roi.x_size == 1000);
+    REQUIRE(roi.y_binning == 200);
+    REQUIRE(roi.rows == 1);
+    REQUIRE(roi.x_values.size() == 1000);
+    REQUIRE(roi.y_values.size() == 1000);
+    REQUIRE(roi.y_values[0] == 607);
+  }
+
+  SECTION("CCD acquisition data can be obtained as binary message") {
+    // arrange
+    ccd.open();
+    auto _ignored_response = websocket_communicator->request_with_response(
+        Command("icl_binMode", {{"mode", "all"}}));
+
+    // act
+    auto acquisition_data = ccd.get_acquisition_data();
+
+    // assert
+    REQUIRE(acquisition_data.acquisitions().size() == 1);
+    const auto& roi = acquisition_data.acquisitions()[0].regions_of_interest[0];
+    REQUIRE(roi.x_size == 1000);
+    REQUIRE(roi.x_values.size() == 1000);
+    REQUIRE(roi.y_values.size() == 1000);
+    REQUIRE(roi.y_values[0] == 607);
+  }
+
+  SECTION("CCD acquisition data can reuse the buffers of a previous one") {
+    // arrange
+    ccd.open();
+    auto _ignored_response = websocket_communicator->request_with_response(
+        Command("icl_binMode", {{"mode", "all"}}));
+    ccd.set_acquisition_buffer_size();
+    auto acquisition_data = ccd.get_acquisition_data();
+    const auto& previous_roi =
+        acquisition_data.acquisitions()[0].regions_of_interest[0];
+    const std::set<const double*> previous_buffers{
+        previous_roi.x_values.data(), previous_roi.y_values.data()};
+
+    // act
+    ccd.get_acquisition_data(acquisition_data);
+
+    // assert
+    const auto& roi = acquisition_data.acquisitions()[0].regions_of_interest[0];
+    REQUIRE(roi.y_values.size() == 1000);
+    REQUIRE(roi.y_values[0] == 607);
+    REQUIRE(previous_buffers.contains(roi.x_values.data()));
+    REQUIRE(previous_buffers.contains(roi.y_values.data()));
+  }
+
+  SECTION("CCD frame buffers are sized from the binned regions of interest") {
+    // arrange
+    ccd.open();
+    const auto buffers = websocket_communicator->buffer_pool();
+    ccd.set_region_of_interest(1, 0, 0, 1000, 200, 2, 50);
+
+    // act
+    ccd.set_acquisition_buffer_size(2);
+
+    // assert
+    REQUIRE(buffers->buffer_size() == 500 * 4);
+    REQUIRE(buffers->available() == 4);
+    REQUIRE(buffers->acquire().capacity() == 500);
+    REQUIRE(buffers->acquire(500 * 4).capacity() == 500 * 4);
+  }
+
+  SECTION("CCD frame buffers are sized from the chip without regions") {
+    // arrange
+    ccd.open();
+    const auto buffers = websocket_communicator->buffer_pool();
+
+    // act
+    ccd.set_acquisition_buffer_size();
+
+    // assert
+    REQUIRE(buffers->buffer_size() == 1024 * 256);
+    REQUIRE(buffers->available() == 2);
+  }
+
+  SECTION("CCD acquisition can be waited for") {
+    // arrange
+    ccd.open();
+    const auto start = std::chrono::steady_clock::now();
+
+    // act
+    ccd.wait_for_acquisition(std::chrono::seconds(5));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // assert
+    REQUIRE(elapsed < std::chrono::milliseconds(500));
+  }
+
+  SECTION("CCD acquisition can be waited for asynchronously") {
+    // arrange
+    ccd.open();
+
+    boost::asio::io_context io_context;
+
+    // act
+    auto done = boost::asio::co_spawn(
+        io_context, ccd.wait_for_acquisition_async(std::chrono::seconds(5)),
+        boost::asio::use_future);
+    io_context.run();
+
+    // assert
+    REQUIRE_NOTHROW(done.get());
+  }
+
+  SECTION("CCD waiting for acquisition can be cancelled") {
+    // arrange
+    ccd.open();
+    std::stop_source stop_source;
+    stop_source.request_stop();
+
+    // act
+    // assert
+    REQUIRE_THROWS_AS(ccd.wait_for_acquisition(std::chrono::seconds(5),
+                                               stop_source.get_token()),
+                      std::runtime_error);
+  }
+
+  SECTION("CCD acquisition can be awaited in a coroutine") {
+    // arrange
+    ccd.open();
+    boost::asio::io_context io_context;
+
+    // act
+    auto acquisition = boost::asio::co_spawn(
+        io_context, ccd.acquire_async(true, std::chrono::seconds(5)),
+        boost::asio::use_future);
+    auto busy = boost::asio::co_spawn(
+        io_context, ccd.get_acquisition_busy_async(), boost::asio::use_future);
+    io_context.run();
+
+    // assert
+    REQUIRE_FALSE(busy.get());
+    const auto data = acquisition.get();
+    REQUIRE_FALSE(data.acquisitions().empty());
+    REQUIRE_FALSE(data.acquisitions()[0].regions_of_interest.empty());
+  }
+
+  SECTION("CCD frames can be streamed") {
+    // arrange
+    ccd.open();
+    AcquisitionData frame;
+    bool popped = false;
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+    // act
+    ccd.start_streaming(2);
+    while (!popped && std::chrono::steady_clock::now() < deadline) {
+      popped = ccd.try_pop_frame(frame);
+    }
+    const bool was_streaming = ccd.is_streaming();
+    ccd.stop_streaming();
+
+    // assert
+    REQUIRE(popped);
+    REQUIRE(was_streaming);
+    REQUIRE_FALSE(ccd.is_streaming());
+    REQUIRE(frame.acquisitions().size() == 1);
+  }
+
+  SECTION("CCD cannot stream twice at once") {
+    // arrange
+    ccd.open();
+    ccd.start_streaming();
+
+    // act
+    // assert
+    REQUIRE_THROWS_AS(ccd.start_streaming(), std::runtime_error);
+    ccd.stop_streaming();
   }
 
   SECTION("CCD get acquisition busy") {
@@ -366,4 +628,158 @@ TEST_CASE("CCD test with fake ICL", "[ccd_no_hw]") {
     websocket_communicator->close();
   }
 }
+
+TEST_CASE("CCD acquisition settings with fake ICL", "[ccd_no_hw]") {
+  // arrange
+  auto counting_communicator = std::make_shared<CountingCommunicator>(
+      std::make_shared<WebSocketCommunicator>(
+          FakeICLServer::FAKE_ICL_ADDRESS,
+          std::to_string(FakeICLServer::FAKE_ICL_PORT)));
+  auto ccd = ChargeCoupledDevice(0, counting_communicator);
+  ChargeCoupledDevice::AcquisitionSettings settings;
+  settings.acquisition_format = ChargeCoupledDevice::AcquisitionFormat::SPECTRA;
+  settings.acquisition_count = 1;
+  settings.x_axis_conversion_type =
+      ChargeCoupledDevice::XAxisConversionType::FROM_ICL_SETTINGS_INI;
+  settings.timer_resolution =
+      ChargeCoupledDevice::TimerResolution::THOUSAND_MICROSECONDS;
+  settings.exposure_time = 2;
+  settings.regions_of_interest.push_back({});
+
+  SECTION("CCD acquisition settings can be applied in one batch") {
+    // arrange
+    ccd.open();
+    const int sent_before = counting_communicator->sent_commands;
+
+    // act
+    ccd.apply_acquisition_settings(settings);
+
+    // assert
+    REQUIRE(counting_communicator->sent_commands - sent_before == 6);
+  }
+
+  SECTION("CCD acquisition settings already applied are not sent again") {
+    // arrange
+    ccd.open();
+    ccd.apply_acquisition_settings(settings);
+    settings.exposure_time = 5;
+    const int sent_before = counting_communicator->sent_commands;
+
+    // act
+    ccd.apply_acquisition_settings(settings);
+
+    // assert
+    REQUIRE(counting_communicator->sent_commands - sent_before == 1);
+  }
+
+  SECTION("CCD acquisition settings set one by one are known") {
+    // arrange
+    ccd.open();
+    ccd.set_exposure_time(2);
+    ChargeCoupledDevice::AcquisitionSettings exposure_only;
+    exposure_only.exposure_time = 2;
+    const int sent_before = counting_communicator->sent_commands;
+
+    // act
+    ccd.apply_acquisition_settings(exposure_only);
+
+    // assert
+    REQUIRE(counting_communicator->sent_commands == sent_before);
+  }
+
+  SECTION("CCD acquisition settings are sent again after opening the CCD") {
+    // arrange
+    ccd.open();
+    ccd.apply_acquisition_settings(settings);
+    ccd.open();
+    const int sent_before = counting_communicator->sent_commands;
+
+    // act
+    ccd.apply_acquisition_settings(settings);
+
+    // assert
+    REQUIRE(counting_communicator->sent_commands - sent_before == 6);
+  }
+
+  SECTION("CCD acquisition settings with unknown gain are not sent") {
+    // arrange
+    ccd.open();
+    settings.gain_token = 42;
+    const int sent_before = counting_communicator->sent_commands;
+
+    // act
+    // assert
+    REQUIRE_THROWS_AS(ccd.apply_acquisition_settings(settings),
+                      std::runtime_error);
+    // only the configuration got fetched
+    REQUIRE(counting_communicator->sent_commands - sent_before == 1);
+  }
+
+  if (counting_communicator->is_open()) {
+    counting_communicator->close();
+  }
+}
+
+TEST_CASE("CCD acquisition settings rejected by the ICL", "[ccd_no_hw]") {
+  // arrange
+  fake_icl::ICLServerConfig config;
+  config.port = 0;
+  config.responses_folder = "./fake_icl_responses/";
+  fake_icl::CommandBehavior rejected;
+  rejected.error_probability = 1.0;
+  config.command_behaviors["ccd_setExposureTime"] = rejected;
+  fake_icl::ICLServer server(config);
+  auto counting_communicator = std::make_shared<CountingCommunicator>(
+      std::make_shared<WebSocketCommunicator>("127.0.0.1",
+                                              std::to_string(server.port())));
+  counting_communicator->open();
+  auto ccd = ChargeCoupledDevice(0, counting_communicator);
+  ccd.open();
+  ChargeCoupledDevice::AcquisitionSettings settings;
+  settings.acquisition_count = 1;
+  settings.timer_resolution =
+      ChargeCoupledDevice::TimerResolution::THOUSAND_MICROSECONDS;
+  ccd.apply_acquisition_settings(settings);
+
+  SECTION("CCD settings accepted in a rejected batch are set back") {
+    // arrange
+    settings.acquisition_count = 2;
+    settings.exposure_time = 5;
+    const int sent_before = counting_communicator->sent_commands;
+
+    // act
+    REQUIRE_THROWS_AS(ccd.apply_acquisition_settings(settings),
+                      std::runtime_error);
+    const int sent_by_batch =
+        counting_communicator->sent_commands - sent_before;
+    settings.exposure_time.reset();
+    ccd.apply_acquisition_settings(settings);
+
+    // assert
+    // the acquisition count, the exposure time, then the count set back
+    REQUIRE(sent_by_batch == 3);
+    // the count set back to 1 is known, only the count is sent again
+    REQUIRE(counting_communicator->sent_commands - sent_before == 4);
+  }
+
+  SECTION("CCD settings without a known value are sent again") {
+    // arrange
+    settings.exposure_time = 5;
+    settings.x_axis_conversion_type =
+        ChargeCoupledDevice::XAxisConversionType::FROM_ICL_SETTINGS_INI;
+    REQUIRE_THROWS_AS(ccd.apply_acquisition_settings(settings),
+                      std::runtime_error);
+    settings.exposure_time.reset();
+    const int sent_before = counting_communicator->sent_commands;
+
+    // act
+    ccd.apply_acquisition_settings(settings);
+
+    // assert
+    // the conversion type could not be set back, nothing is known anymore
+    REQUIRE(counting_communicator->sent_commands - sent_before == 3);
+  }
+
+  counting_communicator->close();
+}
 }  // namespace horiba::test
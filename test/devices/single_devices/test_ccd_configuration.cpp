@@ -0,0 +1,88 @@
+#include <horiba_cpp_sdk/devices/single_devices/ccd_configuration.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+
+namespace horiba::test {
+using namespace horiba::devices::single_devices;
+using Catch::Matchers::ContainsSubstring;
+
+TEST_CASE("CCD configuration lookup tables", "[ccd_configuration]") {
+  // arrange
+  const nlohmann::json types = {{{"name", "TTL Falling Edge"}, {"token", 0}},
+                                {{"name", "TTL Rising Edge"}, {"token", 1}}};
+  const nlohmann::json json_configuration = {
+      {"gains", {{{"info", "High Light"}, {"token", 0}}}},
+      {"speeds", {{{"info", "1 MHz"}, {"token", 2}}}},
+      {"triggers",
+       {{{"name", "Trigger Input"},
+         {"token", 0},
+         {"events", {{{"name", "Once"}, {"token", 1}, {"types", types}}}}}}}};
+  const ChargeCoupledDeviceConfiguration configuration{json_configuration};
+
+  SECTION("Gains and speeds of the configuration are found") {
+    // act
+    // assert
+    REQUIRE(configuration.has_gain(0));
+    REQUIRE_FALSE(configuration.has_gain(2));
+    REQUIRE(configuration.has_speed(2));
+    REQUIRE_FALSE(configuration.has_speed(0));
+  }
+
+  SECTION("Gains and speeds not in the configuration name the missing token") {
+    // act
+    // assert
+    REQUIRE_NOTHROW(configuration.validate_gain(0));
+    REQUIRE_THROWS_WITH(configuration.validate_gain(2),
+                        ContainsSubstring("Gain token 2"));
+    REQUIRE_NOTHROW(configuration.validate_speed(2));
+    REQUIRE_THROWS_WITH(configuration.validate_speed(0),
+                        ContainsSubstring("Speed token 0"));
+  }
+
+  SECTION("Gains and speeds are rejected without them in the configuration") {
+    // arrange
+    const ChargeCoupledDeviceConfiguration no_gains_nor_speeds{
+        nlohmann::json{{"triggers", json_configuration.at("triggers")}}};
+
+    // act
+    // assert
+    REQUIRE_THROWS_WITH(no_gains_nor_speeds.validate_gain(0),
+                        ContainsSubstring("Gains not found"));
+    REQUIRE_THROWS_WITH(no_gains_nor_speeds.validate_speed(2),
+                        ContainsSubstring("Speeds not found"));
+  }
+
+  SECTION("Trigger inputs of the configuration are valid") {
+    // act
+    // assert
+    REQUIRE_NOTHROW(configuration.validate_trigger_input(0, 1, 1));
+  }
+
+  SECTION("Trigger inputs not in the configuration name the missing token") {
+    // act
+    // assert
+    REQUIRE_THROWS_WITH(configuration.validate_trigger_input(1, 1, 1),
+                        ContainsSubstring("Trigger address 1"));
+    REQUIRE_THROWS_WITH(configuration.validate_trigger_input(0, 0, 1),
+                        ContainsSubstring("Trigger event 0"));
+    REQUIRE_THROWS_WITH(configuration.validate_trigger_input(0, 1, 2),
+                        ContainsSubstring("Trigger type 2"));
+  }
+
+  SECTION("Signal outputs are rejected without signals in the configuration") {
+    // act
+    // assert
+    REQUIRE_THROWS_WITH(configuration.validate_signal_output(0, 1, 1),
+                        ContainsSubstring("Signals not found"));
+  }
+
+  SECTION("The json of the configuration is kept") {
+    // act
+    // assert
+    REQUIRE(configuration.json() == json_configuration);
+  }
+}
+}  // namespace horiba::test
@@ -394,13 +394,14 @@ TEST_CASE_METHOD(ICLExe, "CCD test on HW", "[ccd_hw]") {
       }
 
       auto acquistion_data_size = ccd.get_acquisition_data_size();
-      auto acquisition_data =
-          std::any_cast<nlohmann::json>(ccd.get_acquisition_data());
+      auto acquisition_data = ccd.get_acquisition_data();
 
       // assert
       REQUIRE(acquistion_data_size == 1000);
-      REQUIRE_FALSE(acquisition_data.empty());
-      REQUIRE(acquisition_data[0]["roi"][0]["xOrigin"] == 0);
+      REQUIRE_FALSE(acquisition_data.acquisitions().empty());
+      REQUIRE(acquisition_data.acquisitions()[0]
+                  .regions_of_interest[0]
+                  .x_origin == 0);
     }
   }
 
@@ -512,7 +513,7 @@ TEST_CASE_METHOD(ICLExe, "CCD test on HW", "[ccd_hw]") {
     auto acquisition_data = ccd.get_acquisition_data();
 
     // assert
-    REQUIRE(acquisition_data.has_value());
+    REQUIRE_FALSE(acquisition_data.acquisitions().empty());
   }
 
   SECTION("CCD get acquisition busy") {
@@ -1,9 +1,17 @@
 #include <horiba_cpp_sdk/communication/websocket_communicator.h>
 #include <horiba_cpp_sdk/devices/single_devices/mono.h>
 
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/use_future.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_floating_point.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "../../fake_icl_server.h"
 
@@ -15,6 +23,119 @@ using Catch::Matchers::WithinAbs;
 using namespace horiba::devices::single_devices;
 using namespace horiba::communication;
 
+TEST_CASE("Mono command timeout with fake ICL", "[mono_no_hw]") {
+  // arrange
+  fake_icl::ICLServerConfig config;
+  config.port = 0;
+  fake_icl::CommandBehavior unanswered;
+  unanswered.drop_probability = 1.0;
+  config.command_behaviors["mono_init"] = unanswered;
+  fake_icl::ICLServer server(config);
+  auto websocket_communicator = std::make_shared<WebSocketCommunicator>(
+      "127.0.0.1", std::to_string(server.port()));
+  auto mono = Monochromator(0, websocket_communicator);
+  mono.set_command_timeout(std::chrono::milliseconds(50));
+  mono.open();
+
+  // act
+  // assert
+  REQUIRE_THROWS_AS(mono.home(), RequestTimeoutError);
+
+  boost::asio::io_context io_context;
+  auto homed = boost::asio::co_spawn(io_context, mono.home_async(),
+                                     boost::asio::use_future);
+  io_context.run();
+  REQUIRE_THROWS_AS(homed.get(), RequestTimeoutError);
+  REQUIRE_NOTHROW(mono.close());
+
+  websocket_communicator->close();
+}
+
+TEST_CASE("Monos sharing a communicator driven from several threads",
+          "[mono_no_hw]") {
+  // arrange
+  constexpr int MONOS = 3;
+  auto websocket_communicator = std::make_shared<WebSocketCommunicator>(
+      FakeICLServer::FAKE_ICL_ADDRESS,
+      std::to_string(FakeICLServer::FAKE_ICL_PORT), 2);
+  std::vector<std::future<void>> mono_threads;
+
+  // act
+  for (int index = 0; index < MONOS; index++) {
+    mono_threads.push_back(
+        std::async(std::launch::async, [websocket_communicator, index] {
+          auto mono = Monochromator(index, websocket_communicator);
+          mono.open();
+          for (int i = 0; i < 20; i++) {
+            [[maybe_unused]] auto _ignored_busy = mono.is_busy();
+          }
+        }));
+  }
+
+  // assert
+  for (auto& mono_thread : mono_threads) {
+    REQUIRE_NOTHROW(mono_thread.get());
+  }
+  REQUIRE(websocket_communicator->is_open());
+
+  websocket_communicator->close();
+}
+
+TEST_CASE("Monos driven by coroutines on a single thread", "[mono_no_hw]") {
+  // arrange
+  constexpr int MONOS = 3;
+  auto websocket_communicator = std::make_shared<WebSocketCommunicator>(
+      FakeICLServer::FAKE_ICL_ADDRESS,
+      std::to_string(FakeICLServer::FAKE_ICL_PORT));
+  std::vector<std::unique_ptr<Monochromator>> monos;
+  for (int index = 0; index < MONOS; index++) {
+    monos.push_back(
+        std::make_unique<Monochromator>(index, websocket_communicator));
+    monos.back()->open();
+  }
+  boost::asio::io_context io_context;
+
+  SECTION("Monos can be moved concurrently") {
+    // act
+    std::vector<std::future<double>> wavelengths;
+    for (auto& mono : monos) {
+      wavelengths.push_back(boost::asio::co_spawn(
+          io_context,
+          [&mono]() -> boost::asio::awaitable<double> {
+            co_await mono->home_async(std::chrono::seconds(5));
+            co_await mono->move_to_target_wavelength_async(
+                500.0, std::chrono::seconds(5));
+            co_return co_await mono->get_current_wavelength_async();
+          },
+          boost::asio::use_future));
+    }
+    io_context.run();
+
+    // assert
+    for (auto& wavelength : wavelengths) {
+      REQUIRE_THAT(wavelength.get(), WithinAbs(320.0, 0.1));
+    }
+  }
+
+  SECTION("Monos can be polled while the thread is awaiting the ICL") {
+    // act
+    std::vector<std::future<bool>> busy_states;
+    for (std::size_t i = 0; i < 100; i++) {
+      busy_states.push_back(boost::asio::co_spawn(
+          io_context, monos[i % monos.size()]->is_busy_async(),
+          boost::asio::use_future));
+    }
+    io_context.run();
+
+    // assert
+    for (auto& busy : busy_states) {
+      REQUIRE_FALSE(busy.get());
+    }
+  }
+
+  websocket_communicator->close();
+}
+
 TEST_CASE("Mono test with fake ICL", "[mono_no_hw]") {
   // arrange
   auto websocket_communicator = std::make_shared<WebSocketCommunicator>(
@@ -54,6 +175,34 @@ TEST_CASE("Mono test with fake ICL", "[mono_no_hw]") {
     REQUIRE_FALSE(mono.is_busy());
   }
 
+  SECTION("Mono wait until ready returns as soon as the mono is ready") {
+    // arrange
+    mono.open();
+    const auto start = std::chrono::steady_clock::now();
+
+    // act
+    mono.wait_until_ready(std::chrono::seconds(5));
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    // assert
+    REQUIRE(elapsed < std::chrono::milliseconds(500));
+  }
+
+  SECTION("Mono can be waited for asynchronously") {
+    // arrange
+    mono.open();
+    boost::asio::io_context io_context;
+
+    // act
+    auto ready = boost::asio::co_spawn(
+        io_context, mono.wait_until_ready_async(std::chrono::seconds(5)),
+        boost::asio::use_future);
+    io_context.run();
+
+    // assert
+    REQUIRE_NOTHROW(ready.get());
+  }
+
   SECTION("Mono can be homed") {
     // arrange
     mono.open();
@@ -0,0 +1,79 @@
+#include <horiba_cpp_sdk/devices/discovery_cache.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <nlohmann/json.hpp>
+
+namespace horiba::test {
+
+using namespace horiba::devices;
+
+TEST_CASE("Discovery cache", "[discovery_cache]") {
+  // arrange
+  const auto cache_path =
+      std::filesystem::temp_directory_path() / "horiba_discovery_cache.json";
+  std::filesystem::remove(cache_path);
+  const DiscoveryCache cache{cache_path};
+  const DiscoveryCache::Entry entry{
+      "2.0.0.108.d762232a",
+      {{{"deviceType", "HORIBA Scientific Syncerity"},
+        {"index", 0},
+        {"serialNumber", "Camera SN:  2244"}}},
+      {{{"deviceType", "HORIBA Scientific iHR"},
+        {"index", 0},
+        {"serialNumber", "1745B-2017-iHR320       "}}}};
+
+  SECTION("Missing cache is not loaded") {
+    // act
+    // assert
+    REQUIRE_FALSE(cache.load().has_value());
+  }
+
+  SECTION("Stored entry can be loaded") {
+    // arrange
+    cache.store(entry);
+
+    // act
+    const auto loaded_entry = cache.load();
+
+    // assert
+    REQUIRE(loaded_entry.has_value());
+    REQUIRE(loaded_entry->icl_version == entry.icl_version);
+    REQUIRE(loaded_entry->ccds == entry.ccds);
+    REQUIRE(loaded_entry->monos == entry.monos);
+  }
+
+  SECTION("Invalid cache is not loaded") {
+    // arrange
+    std::ofstream(cache_path) << "{\"iclVersion\": 3";
+
+    // act
+    // assert
+    REQUIRE_FALSE(cache.load().has_value());
+  }
+
+  SECTION("Entries with other serial numbers are other devices") {
+    // arrange
+    auto other_entry = entry;
+    other_entry.ccds[0]["serialNumber"] = "Camera SN:  2245";
+
+    // act
+    // assert
+    REQUIRE(entry.same_devices(entry));
+    REQUIRE_FALSE(entry.same_devices(other_entry));
+  }
+
+  SECTION("Entries of another ICL version are other devices") {
+    // arrange
+    auto other_entry = entry;
+    other_entry.icl_version = "2.0.0.109";
+
+    // act
+    // assert
+    REQUIRE_FALSE(entry.same_devices(other_entry));
+  }
+
+  std::filesystem::remove(cache_path);
+}
+}  // namespace horiba::test
@@ -1,14 +1,26 @@
+#include <fake_icl/icl_server.h>
 #include <horiba_cpp_sdk/devices/icl_device_manager.h>
+#include <horiba_cpp_sdk/devices/single_devices/ccd.h>
+#include <horiba_cpp_sdk/devices/single_devices/mono.h>
 #include <horiba_cpp_sdk/os/process.h>
 
 #if _WIN32
 #include <horiba_cpp_sdk/os/windows_process.h>
 #endif
 
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/address.hpp>
+#include <boost/asio/ip/tcp.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <chrono>
 #include <cstdlib>
+#include <filesystem>
+#include <future>
 #include <memory>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <thread>
 
 #include "../fake_icl_server.h"
 #include "../os/fake_process.h"
@@ -41,6 +53,171 @@ TEST_CASE("ICL Device Manager test with fake ICL", "[icl_device_manager]") {
     REQUIRE(ccds.size() == 1);
     REQUIRE(monos.size() == 1);
   }
+
+  SECTION("Discovered devices can be opened") {
+    // arrange
+    device_manager.discover_devices();
+
+    // act
+    // assert
+    REQUIRE_NOTHROW(device_manager.open_all_devices());
+    REQUIRE(device_manager.charge_coupled_devices().front()->is_open());
+    REQUIRE(device_manager.monochromators().front()->is_open());
+  }
+
+  SECTION("Discovered devices are stored in the discovery cache") {
+    // arrange
+    const auto cache_path = std::filesystem::temp_directory_path() /
+                            "horiba_icl_device_manager_cache.json";
+    std::filesystem::remove(cache_path);
+    device_manager.use_discovery_cache(cache_path);
+
+    // act
+    device_manager.discover_devices();
+    const auto entry = horiba::devices::DiscoveryCache(cache_path).load();
+
+    // assert
+    REQUIRE(entry.has_value());
+    REQUIRE(entry->ccds.size() == 1);
+    REQUIRE(entry->monos.size() == 1);
+    std::filesystem::remove(cache_path);
+  }
+}
+
+TEST_CASE("ICL Device Manager waits for the ICL on start",
+          "[icl_device_manager]") {
+  // arrange
+  fake_icl::ICLServerConfig config;
+  config.port = 0;
+  config.responses_folder = "./fake_icl_responses/";
+  std::optional<fake_icl::ICLServer> server;
+  server.emplace(config);
+  config.port = server->port();
+  server.reset();
+
+  const std::shared_ptr<horiba::os::Process> fake_icl_process =
+      std::make_shared<horiba::os::FakeProcess>();
+  horiba::devices::ICLDeviceManager device_manager(
+      fake_icl_process, "127.0.0.1", std::to_string(config.port), false);
+
+  SECTION("ICL accepting connections late is connected to") {
+    // arrange
+    auto booting_icl = std::async(std::launch::async, [&server, &config] {
+      std::this_thread::sleep_for(std::chrono::milliseconds(200));
+      server.emplace(config);
+    });
+
+    // act
+    device_manager.start();
+    booting_icl.wait();
+
+    // assert
+    REQUIRE(device_manager.icl_ready_time() >= std::chrono::milliseconds(150));
+    REQUIRE(device_manager.icl_ready_time() < std::chrono::seconds(5));
+    REQUIRE_FALSE(device_manager.charge_coupled_devices().empty());
+    device_manager.stop();
+  }
+
+  SECTION("ICL not accepting connections in time fails the start") {
+    // arrange
+    device_manager.set_start_timeout(std::chrono::milliseconds(100));
+    const auto start = std::chrono::steady_clock::now();
+
+    // act
+    // assert
+    REQUIRE_THROWS_AS(device_manager.start(), std::runtime_error);
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+  }
+
+  SECTION("ICL not answering the handshake in time fails the start") {
+    // arrange
+    // the system accepts the connections, but the websocket handshake is never
+    // answered
+    boost::asio::io_context context;
+    const boost::asio::ip::tcp::acceptor silent_icl(
+        context, boost::asio::ip::tcp::endpoint(
+                     boost::asio::ip::make_address("127.0.0.1"), config.port));
+    device_manager.set_start_timeout(std::chrono::milliseconds(200));
+    const auto start = std::chrono::steady_clock::now();
+
+    // act
+    // assert
+    REQUIRE_THROWS_AS(device_manager.start(), std::runtime_error);
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+  }
+}
+
+TEST_CASE("ICL Device Manager starts from the discovery cache",
+          "[icl_device_manager]") {
+  // arrange
+  constexpr auto list_latency = std::chrono::milliseconds(300);
+  fake_icl::ICLServerConfig config;
+  config.port = 0;
+  config.responses_folder = "./fake_icl_responses/";
+  config.command_behaviors["ccd_list"].latency =
+      fake_icl::LatencyDistribution::fixed(list_latency);
+  const fake_icl::ICLServer server(config);
+  const auto port = std::to_string(server.port());
+
+  const auto cache_path = std::filesystem::temp_directory_path() /
+                          "horiba_icl_device_manager_start_cache.json";
+  std::filesystem::remove(cache_path);
+  const std::shared_ptr<horiba::os::Process> fake_icl_process =
+      std::make_shared<horiba::os::FakeProcess>();
+  {
+    horiba::devices::ICLDeviceManager first_device_manager(
+        fake_icl_process, "127.0.0.1", port, false);
+    first_device_manager.use_discovery_cache(cache_path);
+    first_device_manager.start();
+    first_device_manager.stop();
+  }
+
+  horiba::devices::ICLDeviceManager device_manager(
+      fake_icl_process, "127.0.0.1", port, false, false, true);
+  device_manager.use_discovery_cache(cache_path);
+
+  SECTION("Cached devices are available before the discovery is done") {
+    // act
+    const auto start = std::chrono::steady_clock::now();
+    device_manager.start();
+    const auto start_duration = std::chrono::steady_clock::now() - start;
+    const auto cached_ccds = device_manager.charge_coupled_devices();
+
+    // assert
+    REQUIRE(start_duration < list_latency);
+    REQUIRE(cached_ccds.size() == 1);
+    REQUIRE_NOTHROW(device_manager.wait_for_discovery());
+    REQUIRE(device_manager.charge_coupled_devices().front() ==
+            cached_ccds.front());
+    REQUIRE(device_manager.charge_coupled_devices().front()->is_open());
+  }
+
+  SECTION("Outdated cached devices are replaced") {
+    // arrange
+    auto entry = horiba::devices::DiscoveryCache(cache_path).load();
+    REQUIRE(entry.has_value());
+    const auto serial_number = entry->ccds.at(0).at("serialNumber");
+    entry->ccds.at(0)["serialNumber"] = "outdated";
+    horiba::devices::DiscoveryCache(cache_path).store(*entry);
+
+    // act
+    device_manager.start();
+    const auto cached_ccds = device_manager.charge_coupled_devices();
+
+    // assert
+    REQUIRE_THROWS_AS(device_manager.wait_for_discovery(),
+                      horiba::devices::OutdatedDiscoveryCacheError);
+    REQUIRE(device_manager.charge_coupled_devices().size() == 1);
+    REQUIRE(device_manager.charge_coupled_devices().front() !=
+            cached_ccds.front());
+    REQUIRE(horiba::devices::DiscoveryCache(cache_path)
+                .load()
+                ->ccds.at(0)
+                .at("serialNumber") == serial_number);
+  }
+
+  device_manager.stop();
+  std::filesystem::remove(cache_path);
 }
 
 TEST_CASE("ICL Device Manager test on hardware", "[icl_device_manager_hw]") {
@@ -0,0 +1,230 @@
+#include <fake_icl/icl_server.h>
+#include <horiba_cpp_sdk/communication/command.h>
+#include <horiba_cpp_sdk/communication/response.h>
+#include <horiba_cpp_sdk/communication/websocket_communicator.h>
+#include <horiba_cpp_sdk/devices/single_devices/acquisition_data.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <future>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace horiba::test {
+
+using namespace horiba::fake_icl;
+using horiba::communication::Command;
+using horiba::communication::Response;
+using horiba::communication::WebSocketCommunicator;
+
+TEST_CASE("LatencyDistribution test", "[fake_icl]") {
+  // arrange
+  std::mt19937_64 generator{42};
+
+  SECTION("Distributions can be parsed in milliseconds") {
+    // act
+    const auto none = LatencyDistribution::parse("none");
+    const auto fixed = LatencyDistribution::parse("fixed:2.5");
+    const auto uniform = LatencyDistribution::parse("uniform:1:3");
+    const auto normal = LatencyDistribution::parse("normal:10:2");
+
+    // assert
+    REQUIRE(none.kind() == LatencyDistribution::Kind::NONE);
+    REQUIRE(fixed.kind() == LatencyDistribution::Kind::FIXED);
+    REQUIRE(fixed.sample(generator) == std::chrono::microseconds(2500));
+    REQUIRE(uniform.kind() == LatencyDistribution::Kind::UNIFORM);
+    REQUIRE(normal.kind() == LatencyDistribution::Kind::NORMAL);
+  }
+
+  SECTION("Invalid distributions cannot be parsed") {
+    // act
+    // assert
+    REQUIRE_THROWS_AS(LatencyDistribution::parse("fixed"),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(LatencyDistribution::parse("uniform:3:1"),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(LatencyDistribution::parse("gamma:1:2"),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(LatencyDistribution::parse("fixed:-1"),
+                      std::invalid_argument);
+  }
+
+  SECTION("Samples stay in the range of the distribution") {
+    // arrange
+    const auto uniform = LatencyDistribution::uniform(
+        std::chrono::microseconds(100), std::chrono::microseconds(200));
+    const auto normal = LatencyDistribution::normal(
+        std::chrono::microseconds(0), std::chrono::microseconds(1000));
+
+    // act
+    // assert
+    for (int i = 0; i < 1000; i++) {
+      const auto uniform_sample = uniform.sample(generator);
+      REQUIRE(uniform_sample >= std::chrono::microseconds(100));
+      REQUIRE(uniform_sample <= std::chrono::microseconds(200));
+      REQUIRE(normal.sample(generator) >= std::chrono::microseconds(0));
+    }
+  }
+}
+
+TEST_CASE("ICLServer test", "[fake_icl]") {
+  // arrange
+  ICLServerConfig config;
+  config.port = 0;
+  config.threads = 2;
+  config.synthetic_chip = ChipSize{64, 8};
+
+  SECTION("Unknown commands are answered with empty results") {
+    // arrange
+    ICLServer server(config);
+    WebSocketCommunicator communicator("127.0.0.1",
+                                       std::to_string(server.port()));
+    communicator.open();
+
+    // act
+    const auto response =
+        communicator.request_with_response(Command("icl_info", {}));
+    communicator.close();
+
+    // assert
+    REQUIRE(server.port() != 0);
+    REQUIRE(response.json_results().empty());
+    REQUIRE(response.errors().empty());
+    REQUIRE(server.received_commands() == 1);
+  }
+
+  SECTION("Acquisitions are synthesized for the configured chip") {
+    // arrange
+    ICLServer server(config);
+    WebSocketCommunicator communicator("127.0.0.1",
+                                       std::to_string(server.port()));
+    communicator.open();
+
+    // act
+    const auto chip_size = communicator.request_with_response(
+        Command("ccd_getChipSize", {{"index", 0}}));
+    const auto acquisition = communicator.request_with_response(
+        Command("ccd_getAcquisitionData", {{"index", 0}}));
+    communicator.close();
+    const auto data = devices::single_devices::AcquisitionData::from_json(
+        acquisition.json_results());
+
+    // assert
+    REQUIRE(chip_size.json_results().at("x") == 64);
+    REQUIRE(chip_size.json_results().at("y") == 8);
+    const auto& roi = data.acquisitions().at(0).regions_of_interest.at(0);
+    REQUIRE(roi.rows == 8);
+    REQUIRE(roi.columns() == 64);
+  }
+
+  SECTION("Acquisitions are sent as binary messages when enabled") {
+    // arrange
+    config.binary_messages = true;
+    ICLServer server(config);
+    WebSocketCommunicator communicator("127.0.0.1",
+                                       std::to_string(server.port()));
+    communicator.open();
+
+    // act
+    const auto acquisition = communicator.request_with_response(
+        Command("ccd_getAcquisitionData", {{"index", 0}}));
+    communicator.close();
+
+    // assert
+    REQUIRE(acquisition.binary_blocks().size() == 2);
+    REQUIRE(acquisition.binary_blocks()[1].values.size() == 64 * 8);
+  }
+
+  SECTION("Errors can be injected") {
+    // arrange
+    CommandBehavior failing;
+    failing.error_probability = 1.0;
+    failing.error_message = "[E];-42;Injected";
+    config.command_behaviors["mono_home"] = failing;
+    ICLServer server(config);
+    WebSocketCommunicator communicator("127.0.0.1",
+                                       std::to_string(server.port()));
+    communicator.open();
+
+    // act
+    const auto failed =
+        communicator.request_with_response(Command("mono_home", {}));
+    const auto succeeded =
+        communicator.request_with_response(Command("mono_isBusy", {}));
+    communicator.close();
+
+    // assert
+    REQUIRE(failed.errors() == std::vector<std::string>{"[E];-42;Injected"});
+    REQUIRE(succeeded.errors().empty());
+  }
+
+  SECTION("Dropped commands are never answered") {
+    // arrange
+    CommandBehavior dropped;
+    dropped.drop_probability = 1.0;
+    config.command_behaviors["ccd_getAcquisitionBusy"] = dropped;
+    ICLServer server(config);
+    WebSocketCommunicator communicator("127.0.0.1",
+                                       std::to_string(server.port()));
+    communicator.open();
+
+    // act
+    auto response = communicator.request_with_response_async(
+        Command("ccd_getAcquisitionBusy", {}));
+    const auto status = response.wait_for(std::chrono::milliseconds(200));
+    communicator.close();
+
+    // assert
+    REQUIRE(status == std::future_status::timeout);
+  }
+
+  SECTION("Commands are answered after their latency") {
+    // arrange
+    config.default_behavior.latency =
+        LatencyDistribution::fixed(std::chrono::milliseconds(50));
+    ICLServer server(config);
+    WebSocketCommunicator communicator("127.0.0.1",
+                                       std::to_string(server.port()));
+    communicator.open();
+
+    // act
+    const auto start = std::chrono::steady_clock::now();
+    const auto response =
+        communicator.request_with_response(Command("mono_isBusy", {}));
+    const auto round_trip = std::chrono::steady_clock::now() - start;
+    communicator.close();
+
+    // assert
+    REQUIRE(round_trip >= std::chrono::milliseconds(50));
+  }
+
+  SECTION("Pipelined commands with random latencies get their own response") {
+    // arrange
+    config.default_behavior.latency = LatencyDistribution::uniform(
+        std::chrono::microseconds(0), std::chrono::milliseconds(5));
+    ICLServer server(config);
+    WebSocketCommunicator communicator("127.0.0.1",
+                                       std::to_string(server.port()));
+    communicator.open();
+    std::vector<Command> commands;
+    for (int i = 0; i < 32; i++) {
+      commands.emplace_back("mono_isBusy", nlohmann::json{{"index", i}});
+    }
+
+    // act
+    std::vector<std::future<Response>> responses;
+    for (const auto& command : commands) {
+      responses.push_back(communicator.request_with_response_async(command));
+    }
+
+    // assert
+    for (std::size_t i = 0; i < commands.size(); i++) {
+      REQUIRE(responses[i].get().id() == commands[i].id());
+    }
+    communicator.close();
+  }
+}
+
+}  // namespace horiba::test
@@ -0,0 +1,153 @@
+#include <fake_icl/icl_server.h>
+#include <horiba_cpp_sdk/os/posix_process.h>
+
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace horiba::test {
+
+using horiba::os::PosixProcess;
+
+namespace {
+
+/**
+ * @brief Copies a system executable under a name no other process has, so
+ * that running() does not find unrelated processes.
+ */
+std::string copy_executable(const std::filesystem::path& executable,
+                            const std::string& name) {
+  const auto folder = std::filesystem::temp_directory_path();
+  std::filesystem::copy_file(
+      executable, folder / name,
+      std::filesystem::copy_options::skip_existing);
+  return folder.string() + "/";
+}
+
+}  // namespace
+
+TEST_CASE("PosixProcess test", "[posix_process]") {
+  // arrange
+  const auto sleep_folder = copy_executable("/bin/sleep", "hsdk_sleep");
+  fake_icl::ICLServerConfig config;
+  config.port = 0;
+  std::optional<fake_icl::ICLServer> server;
+  server.emplace(config);
+  const auto open_port = std::to_string(server->port());
+
+  SECTION("Process can be started and stopped") {
+    // arrange
+    PosixProcess process(sleep_folder, "hsdk_sleep", {"30"});
+
+    // act
+    process.start();
+    const bool running_after_start = process.running();
+    process.stop();
+
+    // assert
+    REQUIRE(running_after_start);
+    REQUIRE_FALSE(process.running());
+  }
+
+  SECTION("Process started elsewhere is found and stopped") {
+    // arrange
+    PosixProcess process(sleep_folder, "hsdk_sleep", {"30"});
+    process.start();
+    PosixProcess same_process(sleep_folder, "hsdk_sleep", {"30"});
+
+    // act
+    same_process.start();
+    same_process.stop();
+
+    // assert
+    REQUIRE_FALSE(process.running());
+  }
+
+  SECTION("Process that ignores SIGTERM is killed") {
+    // arrange
+    const auto shell_folder = copy_executable("/bin/sh", "hsdk_sh");
+    PosixProcess process(shell_folder, "hsdk_sh",
+                         {"-c", "trap '' TERM; exec sleep 30"});
+    process.set_stop_timeout(std::chrono::milliseconds(100));
+    process.start();
+
+    // act
+    const auto start = std::chrono::steady_clock::now();
+    process.stop();
+
+    // assert
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+  }
+
+  SECTION("Start waits until the port accepts connections") {
+    // arrange
+    PosixProcess process(sleep_folder, "hsdk_sleep", {"30"});
+    process.wait_for_port("127.0.0.1", open_port, std::chrono::seconds(5));
+
+    // act
+    const auto start = std::chrono::steady_clock::now();
+    process.start();
+
+    // assert
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+    REQUIRE(process.running());
+    process.stop();
+  }
+
+  SECTION("Process not accepting connections in time is stopped") {
+    // arrange
+    server.reset();
+    PosixProcess process(sleep_folder, "hsdk_sleep", {"30"});
+    process.wait_for_port("127.0.0.1", open_port,
+                          std::chrono::milliseconds(100));
+
+    // act
+    // assert
+    REQUIRE_THROWS_AS(process.start(), std::runtime_error);
+    REQUIRE_FALSE(process.running());
+  }
+
+  SECTION("Unresponsive host does not delay the start past its timeout") {
+    // arrange
+    // TEST-NET-1 is never routed, a connection to it is never answered
+    PosixProcess process(sleep_folder, "hsdk_sleep", {"30"});
+    process.wait_for_port("192.0.2.1", "80", std::chrono::milliseconds(200));
+
+    // act
+    const auto start = std::chrono::steady_clock::now();
+
+    // assert
+    REQUIRE_THROWS_AS(process.start(), std::runtime_error);
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(2));
+    REQUIRE_FALSE(process.running());
+  }
+
+  SECTION("Process exiting while starting is reported right away") {
+    // arrange
+    server.reset();
+    const auto false_folder = copy_executable("/bin/false", "hsdk_false");
+    PosixProcess process(false_folder, "hsdk_false");
+    process.wait_for_port("127.0.0.1", open_port, std::chrono::seconds(10));
+
+    // act
+    const auto start = std::chrono::steady_clock::now();
+
+    // assert
+    REQUIRE_THROWS_AS(process.start(), std::runtime_error);
+    REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+  }
+
+  SECTION("Missing executable cannot be started") {
+    // arrange
+    PosixProcess process(sleep_folder, "hsdk_missing");
+
+    // act
+    // assert
+    REQUIRE_THROWS_AS(process.start(), std::runtime_error);
+  }
+}
+
+}  // namespace horiba::test